@@ -10,14 +10,103 @@
 #include <vector>
 #include <iostream>
 #include <optional>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <iterator> // for back_inserter
+#include <algorithm>
 
 #include "YAGL_Graph.hpp"
+#include "YAGL_Thread_Pool.hpp"
+#include "YAGL_Match.hpp"
 
 namespace YAGL
 {
 
 #define DEBUG_PRINT 0 
 
+// Motivation: graphs that hand out dense integer ids can be searched with
+// 						 flat visited arrays instead of hashing every key
+template <typename GraphType, typename = void>
+struct has_dense_ids : std::false_type {};
+
+template <typename GraphType>
+struct has_dense_ids<GraphType, std::void_t<
+	decltype(std::declval<GraphType&>().id_bound()),
+	decltype(std::declval<GraphType&>().out_ids(typename GraphType::id_type{}))>> : std::true_type {};
+
+template <typename GraphType>
+inline constexpr bool has_dense_ids_v = has_dense_ids<GraphType>::value;
+
+// Motivation: graphs that keep their labels in a column by id can filter
+// 						 candidates without touching the node payloads
+template <typename GraphType, typename = void>
+struct has_label_column : std::false_type {};
+
+template <typename GraphType>
+struct has_label_column<GraphType, std::enable_if_t<GraphType::has_label_column>> : std::true_type {};
+
+template <typename GraphType>
+inline constexpr bool has_label_column_v = has_label_column<GraphType>::value;
+
+// Motivation: and with a label index the candidates come straight from
+// 						 the bucket of their label
+template <typename GraphType, typename = void>
+struct has_label_index : std::false_type {};
+
+template <typename GraphType>
+struct has_label_index<GraphType, std::enable_if_t<GraphType::has_label_index>> : std::true_type {};
+
+template <typename GraphType>
+inline constexpr bool has_label_index_v = has_label_index<GraphType>::value;
+
+// Motivation: graphs whose edges carry labeled payloads are matched on those
+// 						 labels as well
+template <typename GraphType, typename = void>
+struct has_edge_labels : std::false_type {};
+
+template <typename GraphType>
+struct has_edge_labels<GraphType, std::enable_if_t<GraphType::has_edge_labels>> : std::true_type {};
+
+template <typename GraphType>
+inline constexpr bool has_edge_labels_v = has_edge_labels<GraphType>::value;
+
+// a pattern with edge labels can only be matched against a host that has
+// them too, without them every host edge would pass for any label
+template <typename GraphType, typename HostGraphType>
+inline constexpr bool edge_labels_comparable_v = 
+	!has_edge_labels_v<GraphType> || has_edge_labels_v<HostGraphType>;
+
+template <typename GraphType, bool = has_edge_labels_v<GraphType>>
+struct edge_label_of { using type = NoLabel; };
+
+template <typename GraphType>
+struct edge_label_of<GraphType, true> { using type = typename GraphType::edge_label_traits::type; };
+
+// true when the host edge between c and d can stand in for the pattern edge
+// between a and b, a pattern edge without a payload takes any host edge
+template <typename GraphType, typename HostGraphType>
+bool edge_labels_agree(GraphType& g1, const typename GraphType::key_type& a, const typename GraphType::key_type& b, 
+		HostGraphType& g2, const typename HostGraphType::key_type& c, const typename HostGraphType::key_type& d)
+{
+	static_assert(edge_labels_comparable_v<GraphType, HostGraphType>, 
+		"the pattern has edge labels but the host does not, give the host edge data with the same labels");
+
+	if constexpr(has_edge_labels_v<GraphType>)
+	{
+		const auto* pattern_edge = g1.getEdgeData(a, b);
+		if(!pattern_edge) return true;
+		
+		const auto* host_edge = g2.getEdgeData(c, d);
+		return host_edge && HostGraphType::edge_label_traits::get(*host_edge) 
+			== GraphType::edge_label_traits::get(*pattern_edge);
+	}
+	else
+	{
+		return true;
+	}
+}
+
 template <typename GraphType, typename NodeSet>
 GraphType induced_subgraph(GraphType& graph, NodeSet& inducing_set)
 {
@@ -26,8 +115,7 @@ GraphType induced_subgraph(GraphType& graph, NodeSet& inducing_set)
 	//first add all of the inducing nodes to the subgraph 
 	for(const auto& u : inducing_set)
 	{
-		auto node_u = graph.findNode(u)->second;
-		subgraph.addNode(node_u);
+		subgraph.addNode(graph.findNode(u)->second);
 	}
 	//next for every node only add an edge if adjecent
 	for(const auto& u : inducing_set)
@@ -54,7 +142,23 @@ recursive_dfs(GraphType& graph, typename GraphType::key_type v, std::size_t max_
 	//a max depth of zero means search with no limit
 	std::size_t cur_depth = 0;
 	//run the implementation
-	impl_recursive_dfs(graph, v, visited, path, cur_depth, max_depth);
+	if constexpr(has_dense_ids_v<GraphType>)
+	{
+		std::vector<bool> seen(graph.id_bound(), false);
+		std::vector<std::pair<typename GraphType::key_type, std::size_t>> order;
+		impl_dense_dfs2(graph, graph.node_id(v), seen, order, cur_depth, max_depth);
+		
+		visited.reserve(order.size());
+		for(auto& [u, depth] : order)
+		{
+			visited.insert(u);
+			path.push_back(u);
+		}
+	}
+	else
+	{
+		impl_recursive_dfs(graph, v, visited, path, cur_depth, max_depth);
+	}
 	if(DEBUG_PRINT)
 	{
 		std::cout << "Recursive DFS Path: ";
@@ -113,7 +217,15 @@ auto recursive_dfs2(GraphType& graph, typename GraphType::key_type v, std::size_
 	//a max depth of zero means search with no limit
 	std::size_t cur_depth = 0;
 	//run the implementation
-	impl_recursive_dfs2(graph, v, visited, path, cur_depth, max_depth);
+	if constexpr(has_dense_ids_v<GraphType>)
+	{
+		std::vector<bool> seen(graph.id_bound(), false);
+		impl_dense_dfs2(graph, graph.node_id(v), seen, path, cur_depth, max_depth);
+	}
+	else
+	{
+		impl_recursive_dfs2(graph, v, visited, path, cur_depth, max_depth);
+	}
 	if(DEBUG_PRINT)
 	{
 		std::cout << "Recursive DFS Path ({ vertex, depth }): ";
@@ -159,6 +271,60 @@ void impl_recursive_dfs2(GraphType& graph,
 	}
 }
 
+// Same traversal as impl_recursive_dfs2 but over dense ids, a stack of
+// neighbor cursors stands in for the call stack so long paths can't
+// overflow it
+template <typename GraphType>
+void impl_dense_dfs2(GraphType& graph, 
+		typename GraphType::id_type v, 
+		std::vector<bool>& seen,
+		std::vector<std::pair<typename GraphType::key_type, std::size_t>>& path,
+		std::size_t cur_depth = 0,
+		std::size_t max_depth = 0)
+{
+	using nbr_iterator = decltype(graph.out_ids(v).begin());
+	
+	struct Frame
+	{
+		nbr_iterator cur;
+		nbr_iterator end;
+		std::size_t depth;
+	};
+	std::vector<Frame> stack;
+
+	auto visit = [&](typename GraphType::id_type u, std::size_t depth)
+	{
+		//mark the current node as found 
+		seen[u] = true;
+		path.push_back({graph.node_key(u), depth});
+		
+		//its neighbors sit one deeper, unless that hits the max depth
+		if(depth + 1 != max_depth)
+		{
+			const auto& nbrs = graph.out_ids(u);
+			stack.push_back({nbrs.begin(), nbrs.end(), depth + 1});
+		}
+	};
+
+	visit(v, cur_depth);
+	while(!stack.empty())
+	{
+		auto& top = stack.back();
+		if(top.cur == top.end)
+		{
+			stack.pop_back();
+			continue;
+		}
+		
+		auto u = *top.cur;
+		++top.cur;
+		if(!seen[u]) //not found we need to search it 
+		{
+			visit(u, top.depth);
+		}
+	}
+}
+
 
 
 template <typename GraphType>
@@ -168,7 +334,23 @@ iterative_dfs(GraphType& graph, typename GraphType::key_type v)
 	std::unordered_set<typename GraphType::key_type> visited;
 	std::vector<typename GraphType::key_type> path;
 	
-	impl_iterative_dfs(graph, v, visited, path);
+	if constexpr(has_dense_ids_v<GraphType>)
+	{
+		std::vector<bool> seen(graph.id_bound(), false);
+		std::vector<typename GraphType::id_type> order;
+		impl_dense_iterative_dfs(graph, graph.node_id(v), seen, order);
+		
+		visited.reserve(order.size());
+		for(auto u : order)
+		{
+			visited.insert(graph.node_key(u));
+			path.push_back(graph.node_key(u));
+		}
+	}
+	else
+	{
+		impl_iterative_dfs(graph, v, visited, path);
+	}
 	if(DEBUG_PRINT)
 	{
 		std::cout << "Iterative DFS Path: ";
@@ -217,6 +399,44 @@ void impl_iterative_dfs(GraphType& graph,
 	} 
 }
 
+// Same traversal as impl_iterative_dfs but over dense ids 
+template <typename GraphType>
+void impl_dense_iterative_dfs(GraphType& graph, 
+		typename GraphType::id_type v,
+		std::vector<bool>& seen,
+		std::vector<typename GraphType::id_type>& order)
+{
+	//create the stack for our search
+	std::vector<typename GraphType::id_type> q;
+	
+	//push the current node to the stack 
+	q.push_back(v);
+	
+	//loop until the stack is empty 
+	while(!q.empty())
+	{
+		// pop a vertex from the stack to visit
+		v = q.back();
+		q.pop_back();
+		
+		//stack may contain the same vertex twice so we need 
+		//too record it only if not visited 
+		if(!seen[v])
+		{
+			order.push_back(v);
+			seen[v] = true;
+		}
+		//do this for every edge (v, u)
+		for(auto u : graph.out_ids(v))
+		{
+			if(!seen[u]) // not found yet
+			{
+				q.push_back(u);
+			}
+		}
+	} 
+}
+
 template <typename GraphType>
 std::unordered_set<typename GraphType::key_type>
 iterative_bfs(GraphType& graph, typename GraphType::key_type v)
@@ -225,7 +445,23 @@ iterative_bfs(GraphType& graph, typename GraphType::key_type v)
 	std::unordered_set<typename GraphType::key_type> visited;
 	std::vector<typename GraphType::key_type> path;
 
-	impl_iterative_bfs(graph, v, visited, path);
+	if constexpr(has_dense_ids_v<GraphType>)
+	{
+		std::vector<bool> seen(graph.id_bound(), false);
+		std::vector<typename GraphType::id_type> order;
+		impl_dense_bfs(graph, graph.node_id(v), seen, order);
+		
+		visited.reserve(order.size());
+		for(auto u : order)
+		{
+			visited.insert(graph.node_key(u));
+			path.push_back(graph.node_key(u));
+		}
+	}
+	else
+	{
+		impl_iterative_bfs(graph, v, visited, path);
+	}
 	if(DEBUG_PRINT)
 	{
 		std::cout << "Iterative BFS Path: ";
@@ -272,6 +508,37 @@ void impl_iterative_bfs(GraphType& graph,
 	} 
 }
 
+// Same traversal as impl_iterative_bfs but over dense ids, the order 
+// vector doubles as the queue so nothing but the ids gets allocated
+template <typename GraphType>
+void impl_dense_bfs(GraphType& graph, 
+		typename GraphType::id_type v, 
+		std::vector<bool>& seen,
+		std::vector<typename GraphType::id_type>& order)
+{
+	auto head = order.size();
+
+	//mark the first node as found and enqueue it
+	seen[v] = true;
+	order.push_back(v);
+
+	//loop until the queue is empty 
+	while(head != order.size())
+	{
+		v = order[head++];
+
+		//do this for every edge (v, u)
+		for(auto u : graph.out_ids(v))
+		{
+			if(!seen[u]) // not found yet
+			{
+				seen[u] = true;
+				order.push_back(u);
+			}
+		}
+	}
+}
+
 template <typename GraphType>
 std::size_t connected_components(GraphType& graph)
 {
@@ -279,19 +546,42 @@ std::size_t connected_components(GraphType& graph)
 	std::vector<std::vector<typename GraphType::key_type>> component_paths;
 
 	std::size_t count = 0; //no connected components found to start
-	for(auto i = graph.node_list_begin(); i != graph.node_list_end(); i++)
+	if constexpr(has_dense_ids_v<GraphType>)
 	{
-		auto v = i->first;
-		//node hasn't been visited so it must be the start of a new connected component 
-		if(visited.find(v) == visited.end())
+		std::vector<bool> seen(graph.id_bound(), false);
+		std::vector<typename GraphType::id_type> order;
+		for(typename GraphType::id_type v = 0; v < graph.id_bound(); v++)
 		{
-			std::vector<typename GraphType::key_type> path;
-			//we could use whatever search method we feel like 
-			impl_iterative_bfs(graph, v, visited, path);
-			component_paths.push_back(path);
+			if(!graph.has_id(v) || seen[v]) continue;
+			
+			//reuse the same buffer for every component
+			order.clear();
+			impl_dense_bfs(graph, v, seen, order);
+			if(DEBUG_PRINT)
+			{
+				std::vector<typename GraphType::key_type> path;
+				for(auto u : order) path.push_back(graph.node_key(u));
+				component_paths.push_back(path);
+			}
 			count++;
 		}
 	}
+	else
+	{
+		for(auto i = graph.node_list_begin(); i != graph.node_list_end(); i++)
+		{
+			auto v = i->first;
+			//node hasn't been visited so it must be the start of a new connected component 
+			if(visited.find(v) == visited.end())
+			{
+				std::vector<typename GraphType::key_type> path;
+				//we could use whatever search method we feel like 
+				impl_iterative_bfs(graph, v, visited, path);
+				component_paths.push_back(path);
+				count++;
+			}
+		}
+	}
 	if(DEBUG_PRINT)
 	{
 		//print paths
@@ -327,21 +617,53 @@ Ltype<GraphType> graph_isomorphism(GraphType& g1, GraphType& g2)
 	if(g1.numNodes() == g2.numNodes() && g1.numEdges() == g2.numEdges())
 	{
 		auto v = g1.node_list_begin();
-		extend_graph_isomorphism(g1, g2, M, v, L);
+		auto emit = [&](const Mtype<GraphType>& M_prime) {
+			L.push_back(M_prime);
+			return true;
+		};
+		extend_graph_isomorphism(g1, g2, M, v, emit);
 	}
 	// return the container L 
 	return L;
 }
 
-template <typename GraphType, typename NodeTypeIter>
-void extend_graph_isomorphism(GraphType& g1, GraphType& g2, Mtype<GraphType> M, 
-		NodeTypeIter v, Ltype<GraphType>& L )
+// Motivation: the streaming form of graph_isomorphism, every match is handed
+// 						 to visit(MatchView) as it is found instead of being stored.
+// 						 Returning false from visit stops the search, the number of
+// 						 matches visited is returned
+template <typename GraphType, typename Visitor>
+std::size_t graph_isomorphism(GraphType& g1, GraphType& g2, Visitor&& visit)
+{
+	using key_type = typename GraphType::key_type;
+
+	std::size_t count = 0;
+	std::vector<std::pair<key_type, key_type>> pairs;
+	
+	if(g1.numNodes() == g2.numNodes() && g1.numEdges() == g2.numEdges())
+	{
+		Mtype<GraphType> M{};
+		auto v = g1.node_list_begin();
+		auto emit = [&](const Mtype<GraphType>& M_prime) {
+			pairs.assign(M_prime.begin(), M_prime.end());
+			count++;
+			return visit_match(visit, MatchView<key_type>(pairs.data(), pairs.size()));
+		};
+		extend_graph_isomorphism(g1, g2, M, v, emit);
+	}
+	return count;
+}
+
+// emit(M) is called for every match, the search stops and returns false
+// as soon as emit does
+template <typename GraphType, typename NodeTypeIter, typename Emit>
+bool extend_graph_isomorphism(GraphType& g1, GraphType& g2, Mtype<GraphType> M, 
+		NodeTypeIter v, Emit& emit)
 {
 	// let M' be a copy of M 
 	auto M_prime = M;
 	
-	// get a copy of the vertices of G2
-	auto node_set2 = g2.getNodeSet();
+	// rather than copying the vertices of G2 just track the keys removed from V2
+	std::unordered_set<typename GraphType::key_type> removed2;
 	
 	// for all vertices v' of G1
 	for(const auto& v_prime : g1.getNodeSetRef())
@@ -350,26 +672,20 @@ void extend_graph_isomorphism(GraphType& g1, GraphType& g2, Mtype<GraphType> M,
 		auto& node = v_prime.second;
 		if(M_prime.find(node.getKey()) != M_prime.end()) 
 		{
-			node_set2.erase(M[node.getKey()]);
+			removed2.insert(M[node.getKey()]);
 		}
 	} 
 
-	// for all vertices w of G2 
-	for(auto& w : g2.getNodeSetRef())
+	// for all vertices w in V2 
+	for(auto& w : g2.getNodeSetRef()) 
 	{
-		auto& node_w = w.second;
-		auto& node_v = v->second;
-
-		// if the labels aren't equal, not a candidate 
-		if(node_v.getData().type != node_w.getData().type)
+		// if w was already mapped or the labels aren't equal, not a candidate 
+		if(removed2.find(w.first) != removed2.end() 
+				|| v->second.getData().type != w.second.getData().type)
 		{
-			node_set2.erase(node_w.getKey());
+			continue;
 		}
-	}
 
-	// for all vertices w in V2 
-	for(auto& w : node_set2) 
-	{
 		// check to see if adjecencies are preserved 
 		if(preserve_adjacencies(g1, g2, M_prime, v, w))
 		{
@@ -382,7 +698,7 @@ void extend_graph_isomorphism(GraphType& g1, GraphType& g2, Mtype<GraphType> M,
 			v_temp++;
 			if(v_temp == g1.node_list_end())
 			{
-				L.push_back(M_prime); 
+				if(!emit(static_cast<const Mtype<GraphType>&>(M_prime))) return false;
 			}
 			// let v' be the next vertex after v in G1
 			else 
@@ -390,17 +706,18 @@ void extend_graph_isomorphism(GraphType& g1, GraphType& g2, Mtype<GraphType> M,
 				// let v' be the next vertex after v in G1 
 				auto v_prime = v; 
 				v_prime++;
-				extend_graph_isomorphism(g1, g2, M_prime, v_prime, L);
+				if(!extend_graph_isomorphism(g1, g2, M_prime, v_prime, emit)) return false;
 			}	
 		}
 	}
+	return true;
 }
 
 template <typename GraphType, typename NodeTypeIter, typename NodeType>
 bool preserve_adjacencies(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, NodeTypeIter& v, NodeType& w)
 {
-	auto node_v = v->second;
-	auto node_w = w.second;
+	const auto& node_v = v->second;
+	const auto& node_w = w.second;
 
 	// if the degree of the nodes aren't the same, no match
 	if(g1.in_degree(node_v) != g2.in_degree(node_w) || g1.out_degree(node_v) != g2.out_degree(node_w))
@@ -412,7 +729,7 @@ bool preserve_adjacencies(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, Nod
 	for(auto& x : g1.in_neighbors(node_v))
 	{
 		// if the src vertex, x, in M and M[x] is not adjecent with w in G2, no match 
-		if(M.find(x) != M.end() && !g2.adjacent(M[x], w.first))
+		if(M.find(x) != M.end() && (!g2.adjacent(M[x], w.first) || !edge_labels_agree(g1, x, v->first, g2, M[x], w.first)))
 		{
 			//std::cout << "Adjacency test failed for in neighbors\n";
 			return false;
@@ -422,7 +739,7 @@ bool preserve_adjacencies(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, Nod
 	for(auto& x : g1.out_neighbors(node_v))
 	{
 		// if the target vertex, x, in M and w is not adjecent with M[x] in G2, no match 
-		if(M.find(x) != M.end() && !g2.adjacent(w.first, M[x]))
+		if(M.find(x) != M.end() && (!g2.adjacent(w.first, M[x]) || !edge_labels_agree(g1, v->first, x, g2, w.first, M[x])))
 		{
 			//std::cout << "Adjacency test failed for out neighbors\n";
 			return false;
@@ -437,11 +754,10 @@ bool preserve_adjacencies(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, Nod
 template <typename GraphType>
 using Ctype = std::unordered_map<typename GraphType::key_type, std::unordered_set<typename GraphType::key_type>>;
 
+// the candidate sets every vertex of G1 starts out with
 template<typename GraphType>
-Ltype<GraphType> subgraph_isomorphism(GraphType& g1, GraphType& g2)
+Ctype<GraphType> subgraph_isomorphism_candidates(GraphType& g1, GraphType& g2)
 {
-	//std::cout << "Running subgraph isomorphism\n";
-	
 	// let C be an empty dictionary of vertices to sets of vertices 
 	Ctype<GraphType> C{};
 	
@@ -449,36 +765,118 @@ Ltype<GraphType> subgraph_isomorphism(GraphType& g1, GraphType& g2)
 	for(auto& [v, node_v] : g1.getNodeSetRef())
 	{
 		C[v] = {};
-		for(auto& [w, node_w] : g2.getNodeSetRef())
+		if constexpr(has_label_index_v<GraphType>)
+		{
+			//only nodes with the same label can be candidates
+			for(const auto& w : g2.nodes_with_label(node_v.getData().type))
+			{
+				const auto& node_w = g2.findNode(w)->second;
+				if(g1.in_degree(node_v) <= g2.in_degree(node_w) && g1.out_degree(node_v) <= g2.out_degree(node_w))
+				{
+					C[v].insert(w);
+				}
+			}
+		}
+		else
 		{
-			if(g1.in_degree(node_v) <= g2.in_degree(node_w) && g1.out_degree(node_v) <= g2.out_degree(node_w) 
-					&& node_v.getData().type == node_w.getData().type)
+			for(auto& [w, node_w] : g2.getNodeSetRef())
 			{
-				C[v].insert(w);
+				if(g1.in_degree(node_v) <= g2.in_degree(node_w) && g1.out_degree(node_v) <= g2.out_degree(node_w) 
+						&& node_v.getData().type == node_w.getData().type)
+				{
+					C[v].insert(w);
+				}
 			}
 		}
 	}
 	
+	return C;
+}
+
+template<typename GraphType>
+Ltype<GraphType> subgraph_isomorphism(GraphType& g1, GraphType& g2)
+{
+	//std::cout << "Running subgraph isomorphism\n";
+	
+	// for all vertices in G1, build a set of candidates in G2
+	auto C = subgraph_isomorphism_candidates(g1, g2);
+
 	// let L be an empty list of vertices to vertices aka list of matches 
 	Ltype<GraphType> L{};
 	
 	// let M be an empty dictionary of vertices to vertices aka a match 
 	Mtype<GraphType> M{};
 	
-	// let v be the iterator to the first vertex of G1 
-	auto v_iter = g1.node_list_begin();	
+	// let the vertices of G1 be taken cheapest candidate set first
+	auto order = subgraph_isomorphism_order(g1, C);
+	if(order.empty()) return L;
 	
-	extend_subgraph_isomorphism(g1, g2, C, v_iter, M, L);
+	auto emit = [&](const Mtype<GraphType>& M_prime) {
+		L.push_back(M_prime);
+		return true;
+	};
+	extend_subgraph_isomorphism(g1, g2, C, order, 0, M, emit);
 
 	return L;
 }
 
-template <typename GraphType, typename NodeTypeIter>
-void extend_subgraph_isomorphism(GraphType& g1, GraphType& g2, 
-		Ctype<GraphType> C, NodeTypeIter v_iter, Mtype<GraphType> M, Ltype<GraphType>& L)
+// the streaming form of subgraph_isomorphism, see graph_isomorphism
+template<typename GraphType, typename Visitor>
+std::size_t subgraph_isomorphism(GraphType& g1, GraphType& g2, Visitor&& visit)
+{
+	using key_type = typename GraphType::key_type;
+	
+	auto C = subgraph_isomorphism_candidates(g1, g2);
+
+	std::size_t count = 0;
+	std::vector<std::pair<key_type, key_type>> pairs;
+	
+	Mtype<GraphType> M{};
+	auto order = subgraph_isomorphism_order(g1, C);
+	if(order.empty()) return count;
+	
+	auto emit = [&](const Mtype<GraphType>& M_prime) {
+		pairs.assign(M_prime.begin(), M_prime.end());
+		count++;
+		return visit_match(visit, MatchView<key_type>(pairs.data(), pairs.size()));
+	};
+	extend_subgraph_isomorphism(g1, g2, C, order, 0, M, emit);
+
+	return count;
+}
+
+// the order subgraph_isomorphism extends a match in, planned from the sizes
+// of the candidate sets when the pattern has dense ids
+template <typename GraphType>
+std::vector<typename GraphType::key_type> subgraph_isomorphism_order(GraphType& g1, Ctype<GraphType>& C)
+{
+	std::vector<typename GraphType::key_type> order;
+	if constexpr(has_dense_ids_v<GraphType>)
+	{
+		auto plan = plan_matching_order(g1, [&](typename GraphType::id_type u) {
+			return double(C[g1.node_key(u)].size());
+		});
+		for(auto u : plan.order)
+		{
+			order.push_back(g1.node_key(u));
+		}
+	}
+	else
+	{
+		for(auto& [v, node_v] : g1.getNodeSetRef())
+		{
+			order.push_back(v);
+		}
+	}
+	return order;
+}
+
+// emit(M) is called for every match, returns false once emit stops the search
+template <typename GraphType, typename Emit>
+bool extend_subgraph_isomorphism(GraphType& g1, GraphType& g2, Ctype<GraphType> C, 
+		const std::vector<typename GraphType::key_type>& order, std::size_t idx, Mtype<GraphType> M, Emit& emit)
 {
-	auto v = v_iter->first;
-	auto node_v = v_iter->second;
+	auto v = order[idx];
 
 	for(auto& [w, node_w] : g2.getNodeSetRef())
 	{
@@ -506,26 +904,25 @@ void extend_subgraph_isomorphism(GraphType& g1, GraphType& g2,
 			}
 			if(refine_subgraph_isomorphism(g1, g2, N, v, w))
 			{
-				auto v_next = v_iter; 
-				v_next++;
-				if(v_next == g1.node_list_end())
+				if(idx + 1 == order.size())
 				{
-					L.push_back(M);
+					if(!emit(static_cast<const Mtype<GraphType>&>(M))) return false;
 				}
 				else
 				{
-					extend_subgraph_isomorphism(g1, g2, N, v_next, M, L);	
+					if(!extend_subgraph_isomorphism(g1, g2, N, order, idx + 1, M, emit)) return false;
 				}
 			}
 		}
 	}
+	return true;
 }
 
 template <typename GraphType>
 bool refine_subgraph_isomorphism(GraphType& g1, GraphType& g2, Ctype<GraphType>& C, 
 		typename GraphType::key_type v, typename GraphType::key_type w)
 {
-	auto node_v = g1.findNode(v)->second; auto node_w = g2.findNode(w)->second;
+	const auto& node_v = g1.findNode(v)->second; const auto& node_w = g2.findNode(w)->second;
 
 	if(g1.in_degree(node_v) > g2.in_degree(node_w) || g1.out_degree(node_v) > g2.out_degree(node_w))
 	{
@@ -535,27 +932,19 @@ bool refine_subgraph_isomorphism(GraphType& g1, GraphType& g2, Ctype<GraphType>&
 	{
 		for(auto& [y, node_y] : g2.getNodeSetRef())
 		{
-			if(!g2.adjacent(y, w))
+			if(!g2.adjacent(y, w) || !edge_labels_agree(g1, x, v, g2, y, w))
 			{
 				C[x].erase(y);
 			}
-			else
-			{
-				//check edge labels
-			}
 		}
 	}
 	for(auto& x : g1.out_neighbors(v))
 	{
 		for(auto& [y, node_y] : g2.getNodeSetRef())
 		{
-			if(!g2.adjacent(w, y))
+			if(!g2.adjacent(w, y) || !edge_labels_agree(g1, v, x, g2, w, y))
 			{
 				C[x].erase(y);
-			} 
-			else
-			{
-				//check edge labels
 			}
 		}
 	}
@@ -608,6 +997,18 @@ struct FlatNTree
         nodes[find_node(parent_key)].children.push_back(index);
         build_preorder_index();
     }
+
+    //the root of another tree, its own parent like the first one. It hangs
+    //off the first root so the preorder visits the trees one after another
+    void add_root(KeyType key)
+    {
+        auto index = nodes.size();
+        nodes.push_back({key, key, {}});
+        nodes[0].children.push_back(index);
+        build_preorder_index();
+    }
+
+    bool indexed_root(int i) { return nodes[index[i]].parent == nodes[index[i]].key; }
     
     int find_node(KeyType key)
     {
@@ -659,116 +1060,1205 @@ struct FlatNTree
 };
 
 
+// Motivation: the order the pattern vertices are matched in decides how
+// 						 early a search prunes. Like the RI and GraphQL orderings
+// 						 the plan starts from the vertex with the fewest expected
+// 						 candidates, then keeps taking the vertex with the most
+// 						 already ordered neighbors, the cheaper one on ties, so
+// 						 every step is constrained by as many edges as possible. A
+// 						 vertex without ordered neighbors starts the next component,
+// 						 so disconnected patterns are planned as well
+//
+// NOTE: 			 remaining ties go to the smaller key, so the plan never
+// 						 depends on the iteration order of the pattern's maps
 template <typename GraphType>
-Ltype<GraphType> subgraph_isomorphism2(GraphType& g1, GraphType& g2)
+struct MatchingPlan
 {
-	//std::cout << "Running subgraph isomorphism\n";
+	using id_type = typename GraphType::id_type;
 
-	// let L be an empty container of dictionaries of nodes to nodes
-	Ltype<GraphType> L{};
+	// the pattern ids in matching order
+	std::vector<id_type> order;
 
-	// let M be an empty dictionary of nodes to nodes 
-	Mtype<GraphType> M{};
-	Mtype<GraphType> M_inverse{};	
-	//find a dfs orderding for g1 
-	auto path = recursive_dfs2(g1, g1.node_list_begin()->first);
+	// for every position the earlier positions adjacent to it, true when
+	// the edge leads from the earlier one to it
+	std::vector<std::vector<std::pair<std::size_t, bool>>> anchors;
+};
+
+// cost(id) estimates how many host vertices a pattern vertex may map to
+template <typename GraphType, typename CostFn>
+MatchingPlan<GraphType> plan_matching_order(GraphType& pattern, CostFn&& cost)
+{
+	using id_type = typename GraphType::id_type;
+	constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+	MatchingPlan<GraphType> plan;
 	
-	if(path.size() == 0) return L;
+	std::vector<id_type> remaining;
+	std::vector<double> costs(pattern.id_bound());
+	for(id_type u = 0; u < pattern.id_bound(); u++)
+	{
+		if(!pattern.has_id(u)) continue;
+		remaining.push_back(u);
+		costs[u] = cost(u);
+	}
 
-	//build a tree for the preorder traversal
-	FlatNTree<typename GraphType::key_type> rst(path[0].first);
-	if(path.size() > 1)
+	//the position of every ordered vertex and the edges from the rest to them
+	std::vector<std::size_t> position(pattern.id_bound(), none);
+	std::vector<std::size_t> links(pattern.id_bound(), 0);
+	
+	auto better = [&](id_type a, id_type b) {
+		if(links[a] != links[b]) return links[a] > links[b];
+		if(costs[a] != costs[b]) return costs[a] < costs[b];
+		return pattern.node_key(a) < pattern.node_key(b);
+	};
+
+	plan.order.reserve(remaining.size());
+	while(!remaining.empty())
 	{
-		for(auto i = 1; i < path.size(); i++)
+		auto best = std::min_element(remaining.begin(), remaining.end(), better);
+		auto v = *best;
+		*best = remaining.back();
+		remaining.pop_back();
+
+		auto pos = plan.order.size();
+		plan.order.push_back(v);
+		auto& anchors = plan.anchors.emplace_back();
+		
+		for(auto u : pattern.in_ids(v))
 		{
-			//parent is node of previous depth 
-			typename GraphType::key_type parent; 
-			
-			for(auto j = i-1; j >= 0; j--)
-			{
-				if(path[i].second == (path[j].second + 1))
-				{
-					parent = path[j].first;
-					break;
-				}
-				else 
-					parent = path[0].first;
-			}
-			rst.add_node(path[i].first, parent);
+			if(position[u] != none) anchors.emplace_back(position[u], true);
+		}
+		for(auto u : pattern.out_ids(v))
+		{
+			auto known = std::any_of(anchors.begin(), anchors.end(), 
+					[&](const auto& a) { return a.first == position[u]; });
+			if(position[u] != none && !known) anchors.emplace_back(position[u], false);
 		}
+		position[v] = pos;
+
+		for(auto u : pattern.in_ids(v)) links[u]++;
+		for(auto u : pattern.out_ids(v)) links[u]++;
 	}
-	
-	//set v to be the first item in the total orderding of the dfs tree
-	int idx = 0;
-	auto v = g1.findNode(rst.indexed_key(idx));
-	
-	//if g1 has more nodes than g2, can't be a subgraph, but equal we'll let it slide
-	//same with edges
-	if(g1.numNodes() > g2.numNodes() || g1.numEdges() > g2.numEdges())
-		return L;
+	return plan;
+}
 
-	//all nodes are potential candidates for the first ordered vertex of g1
-	for(auto& n : g2.getNodeSetRef())
-	{
-		//TODO: fix the wierd pointer issue caused by this in preserve_adjacencies2 
-		auto w = g2.findNode(n.first); //my janky fix, but makes no sense since we iter g2
-		auto& node_w = w->second;
-		auto& node_v = v->second;
+// Motivation: the key based matcher keeps its state in std::maps and
+// 						 recurses once per pattern vertex. This engine works on
+// 						 dense ids, the partial match lives in two flat arrays and
+// 						 the search runs on an explicit stack of preallocated
+// 						 frames, so long patterns can't overflow the call stack and
+// 						 no step of the search allocates
+//
+// NOTE: 			 the pattern is matched in the order plan_matching_order
+// 						 picks from label frequencies in the host. Every vertex
+// 						 with ordered neighbors takes its candidates from the host
+// 						 neighbors of their image with the fewest of them, the
+// 						 first vertex of each component from all host vertices
+// 						 sharing its label
+template <typename GraphType, typename HostGraphType>
+class SubgraphMatcher
+{
+	public:
+		using key_type = typename GraphType::key_type;
+		using pattern_id_type = typename GraphType::id_type;
+		using host_id_type = typename HostGraphType::id_type;
+		
+		// a match is indexed by pattern id and holds host ids
+		using match_type = std::vector<host_id_type>;
 
-		//if labels are different not a candidate 
-		if(node_v.getData().type == node_w.getData().type)
-		{
-			//if the degree of v is greater than w, also not a candidate 
-			if(preserve_adjacencies2(g1, g2, M, v, w))	
+		static constexpr host_id_type unmapped = std::numeric_limits<host_id_type>::max();
+
+		// a valid root is put first in the matching order, so runs seeded with
+		// host ids only find the matches mapping the root to one of them
+		SubgraphMatcher(GraphType& pattern, HostGraphType& host, 
+				pattern_id_type root = GraphType::invalid_id);
+
+		// calls visit(M) for every match, returning false stops the search
+		template <typename Visitor>
+		void run(Visitor&& visit);
+
+		// the same search seeded only from the given root images, returns false
+		// if visit stopped it. Matchers sharing a pattern and host can search
+		// disjoint roots side by side
+		template <typename Visitor>
+		bool run(const host_id_type* first, const host_id_type* last, Visitor&& visit);
+
+		// the host ids the first vertex of the matching order may map to
+		std::vector<host_id_type> root_candidates() const;
+
+		// the seeds of later components are found once per matcher, a host
+		// that changed since has to be seeded again
+		void reseed() { seeded = false; }
+
+		// if g1 has more nodes than g2, can't be a subgraph, same with edges
+		bool trivially_empty() const;
+
+		const std::vector<pattern_id_type>& matching_order() const { return order; }
+
+		// the pattern keys in matching order
+		std::vector<key_type> pattern_keys() const;
+
+		// restricts the search to one match per distinct embedding, see below
+		void break_symmetries();
+
+		// the number of automorphisms of the pattern, one until symmetries
+		// are broken
+		std::size_t automorphism_count() const { return automorphisms; }
+
+		Mtype<GraphType> to_map(const match_type& M) const;
+
+	private:
+		using host_iterator = typename std::decay_t<decltype(
+				std::declval<const HostGraphType&>().out_ids(host_id_type{}))>::const_iterator;
+		using pattern_label_type = std::decay_t<decltype(
+				std::declval<typename GraphType::node_type&>().getData().type)>;
+
+		// edge labels are matched whenever the pattern carries them, the
+		// host has to carry them too
+		static_assert(edge_labels_comparable_v<GraphType, HostGraphType>, 
+			"the pattern has edge labels but the host does not, give the host edge data with the same labels");
+		static constexpr bool match_edge_labels = has_edge_labels_v<GraphType>;
+		using edge_label_type = typename edge_label_of<GraphType>::type;
+
+		// a labeled pattern edge to or from an earlier position, the host
+		// edge between the images must carry the same label
+		struct EdgeCheck
+		{
+			std::size_t anchor;
+			bool forward;
+			edge_label_type label;
+		};
+
+		// a frame walks either the neighbors of an anchor's image or, for the
+		// first vertex of a component, a list of seeds
+		struct Frame
+		{
+			host_iterator cur;
+			host_iterator end;
+			const host_id_type* next;
+			const host_id_type* last;
+			host_id_type assigned;
+		};
+
+		GraphType& g1;
+		HostGraphType& g2;
+
+		// everything about the pattern is indexed by position in the order
+		std::vector<pattern_id_type> order;
+		std::vector<std::vector<std::pair<std::size_t, bool>>> anchors;
+		std::vector<pattern_label_type> labels;
+		std::vector<std::size_t> in_degrees;
+		std::vector<std::size_t> out_degrees;
+		std::vector<std::vector<EdgeCheck>> edge_checks;
+
+		// ordering constraints, the images of the positions in below[pos] must
+		// be smaller than the image chosen at pos and those in above[pos] larger
+		std::vector<std::vector<std::size_t>> below;
+		std::vector<std::vector<std::size_t>> above;
+		std::size_t automorphisms = 1;
+
+		// the seeds of the later components, found on the first run
+		std::vector<std::vector<host_id_type>> seeds;
+		bool seeded = false;
+
+		match_type M;
+		std::vector<pattern_id_type> M_inverse;
+		std::vector<Frame> frames;
+
+		// the host ids sharing the label of a position
+		std::vector<host_id_type> candidates(std::size_t pos) const;
+
+		bool feasible(std::size_t pos, host_id_type w);
+};
+
+template <typename GraphType, typename HostGraphType>
+SubgraphMatcher<GraphType, HostGraphType>::SubgraphMatcher(GraphType& pattern, HostGraphType& host, 
+		pattern_id_type root)
+: g1(pattern), g2(host)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	if(g1.numNodes() == 0) return;
+
+	auto label_of = [&](pattern_id_type u) -> const pattern_label_type& {
+		return g1.findNode(g1.node_key(u))->second.getData().type;
+	};
+
+	//how many host vertices carry each pattern label, only worth counting
+	//when the pattern has more than one label. An index answers at once, a
+	//column or the payloads take one pass over the host, small next to the
+	//search it steers
+	std::vector<std::pair<pattern_label_type, std::size_t>> frequency;
+	for(pattern_id_type u = 0; u < g1.id_bound(); u++)
+	{
+		if(!g1.has_id(u)) continue;
+		auto known = std::any_of(frequency.begin(), frequency.end(), 
+				[&](const auto& f) { return f.first == label_of(u); });
+		if(!known) frequency.emplace_back(label_of(u), 0);
+	}
+	if constexpr(has_label_index_v<HostGraphType>)
+	{
+		for(auto& [l, count] : frequency) count = g2.label_count(l);
+	}
+	else if constexpr(has_label_column_v<HostGraphType>)
+	{
+		const auto& column = g2.label_column();
+		for(host_id_type w = 0; frequency.size() > 1 && w < g2.id_bound(); w++)
+		{
+			if(!g2.has_id(w)) continue;
+			for(auto& [l, count] : frequency)
 			{
-				M.insert_or_assign(v->first, w->first);	
-				M_inverse.insert_or_assign(w->first, v->first);
-				
-				if(idx+1 == rst.index.size())
-				{
-					L.push_back(M);
-				}
-				else 
-				{
-					int idx_next = idx+1;
-					auto v_prime = g1.findNode(rst.indexed_key(idx_next));
-					extend_subgraph_isomorphism2(g1, g2, M, M_inverse, idx_next, v_prime, L, rst);
-					M.erase(v->first);
-					M_inverse.erase(w->first);
-				}
+				if(l == column[w]) { count++; break; }
+			}
+		}
+	}
+	else
+	{
+		for(const auto& [w, node_w] : g2.getNodeSetRef())
+		{
+			if(frequency.size() < 2) break;
+			for(auto& [l, count] : frequency)
+			{
+				if(l == node_w.getData().type) { count++; break; }
 			}
 		}
 	}
 
-	// return the container L 
-	return L;
+	//the expected number of candidates shrinks with rarer labels and with
+	//every edge a candidate has to carry
+	auto plan = plan_matching_order(g1, [&](pattern_id_type u) {
+		if(u == root) return -1.0;
+
+		double count = 1.0;
+		for(const auto& [l, c] : frequency)
+		{
+			if(frequency.size() > 1 && l == label_of(u)) { count = double(c); break; }
+		}
+		return count / double(1 + g1.in_ids(u).size() + g1.out_ids(u).size());
+	});
+	order = std::move(plan.order);
+	anchors = std::move(plan.anchors);
+
+	for(auto u : order)
+	{
+		labels.push_back(label_of(u));
+		in_degrees.push_back(g1.in_ids(u).size());
+		out_degrees.push_back(g1.out_ids(u).size());
+	}
+	frames.resize(order.size());
+	seeds.resize(order.size());
+	below.resize(order.size());
+	above.resize(order.size());
+
+	//pattern edges without a payload take any host edge. Anchors keep one
+	//edge per earlier position, but a directed pattern may have a labeled
+	//edge each way, so the edges are read from both neighbor sets
+	edge_checks.resize(order.size());
+	if constexpr(match_edge_labels)
+	{
+		std::vector<std::size_t> position(g1.id_bound(), order.size());
+		for(std::size_t pos = 0; pos < order.size(); pos++)
+		{
+			auto v = order[pos];
+			auto check = [&](pattern_id_type x, bool forward) {
+				if(position[x] >= pos) return;
+				const auto* data = forward ? g1.edge_data_ids(x, v) : g1.edge_data_ids(v, x);
+				if(data) edge_checks[pos].push_back({position[x], forward, GraphType::edge_label_traits::get(*data)});
+			};
+			position[v] = pos;
+
+			for(auto x : g1.in_ids(v)) check(x, true);
+			if constexpr(GraphType::is_directed)
+			{
+				for(auto x : g1.out_ids(v)) check(x, false);
+			}
+		}
+	}
 }
 
-template <typename GraphType, typename NodeTypeIter>
-void extend_subgraph_isomorphism2(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, Mtype<GraphType>& M_inverse, 
-		int idx, NodeTypeIter v, Ltype<GraphType>& L, FlatNTree<typename GraphType::key_type>& rst)
+// Motivation: a symmetric pattern matches every embedding once per
+// 						 automorphism, six times for a triangle. Following Grochow
+// 						 and Kellis the automorphisms are found by matching the
+// 						 pattern onto itself, then the vertex with the first non
+// 						 trivial orbit in the matching order is required to have
+// 						 the smallest image of its orbit and the automorphisms are
+// 						 narrowed to those fixing it, until only the identity is
+// 						 left. Each embedding, as a set of host vertices and edges,
+// 						 then passes the constraints exactly once
+//
+// NOTE: 			 images are compared by host id, so which of the automorphic
+// 						 matches is reported depends on the host's id assignment
+template <typename GraphType, typename HostGraphType>
+void SubgraphMatcher<GraphType, HostGraphType>::break_symmetries()
 {
-	//the starting candidates are anything connected to the node w, of node
-	//v mapped to w of the previous depth that we haven't visited
-	//aka successor of node of previous depth that we haven't visited
-	auto parent = g2.findNode(M[rst.indexed_parent(idx)]);
-	auto& node_candidates = g2.out_neighbors(parent->first);
+	auto n = order.size();
+	for(std::size_t pos = 0; pos < n; pos++)
+	{
+		below[pos].clear();
+		above[pos].clear();
+	}
+	automorphisms = 1;
+	if(n < 2) return;
 
-	for(auto& c : node_candidates)
+	std::vector<std::size_t> position(g1.id_bound());
+	for(std::size_t pos = 0; pos < n; pos++)
 	{
-		// if w is in M_inverse then skip since we've already been there
-		if(M_inverse.find(c) != M_inverse.end()) 
+		position[order[pos]] = pos;
+	}
+
+	//every automorphism as the position each position is sent to
+	std::vector<std::vector<std::size_t>> group;
+	SubgraphMatcher<GraphType, GraphType> self(g1, g1);
+	self.run([&](const auto& A) {
+		std::vector<std::size_t> image(n);
+		for(std::size_t pos = 0; pos < n; pos++)
+		{
+			image[pos] = position[A[order[pos]]];
+		}
+		group.push_back(std::move(image));
+		return true;
+	});
+	automorphisms = group.size();
+
+	std::vector<bool> in_orbit(n);
+	while(group.size() > 1)
+	{
+		//the first position some remaining automorphism moves
+		std::size_t v = 0;
+		while(std::all_of(group.begin(), group.end(), [&](const auto& a) { return a[v] == v; }))
+		{
+			v++;
+		}
+
+		//v must take the smallest image of its orbit
+		std::fill(in_orbit.begin(), in_orbit.end(), false);
+		for(const auto& a : group)
+		{
+			in_orbit[a[v]] = true;
+		}
+		for(std::size_t u = 0; u < n; u++)
+		{
+			if(u == v || !in_orbit[u]) continue;
+
+			//checked when the later of the two is mapped
+			if(v < u) below[u].push_back(v);
+			else above[v].push_back(u);
+		}
+
+		//only the automorphisms fixing v are left
+		group.erase(std::remove_if(group.begin(), group.end(), 
+					[&](const auto& a) { return a[v] != v; }), group.end());
+	}
+}
+
+template <typename GraphType, typename HostGraphType>
+std::vector<typename HostGraphType::id_type> SubgraphMatcher<GraphType, HostGraphType>::root_candidates() const
+{
+	if(order.empty()) return {};
+	return candidates(0);
+}
+
+template <typename GraphType, typename HostGraphType>
+std::vector<typename HostGraphType::id_type> SubgraphMatcher<GraphType, HostGraphType>::candidates(std::size_t pos) const
+{
+	std::vector<host_id_type> roots;
+
+	if constexpr(has_label_index_v<HostGraphType>)
+	{
+		//only the nodes sharing the label are ever touched
+		auto candidates = g2.nodes_with_label(labels[pos]);
+		for(auto iter = candidates.begin(); iter != candidates.end(); ++iter)
+		{
+			roots.push_back(iter.id());
+		}
+	}
+	else if constexpr(has_label_column_v<HostGraphType>)
+	{
+		//a linear pass over the label column
+		const auto& column = g2.label_column();
+		for(host_id_type w = 0; w < g2.id_bound(); w++)
+		{
+			if(g2.has_id(w) && column[w] == labels[pos]) roots.push_back(w);
+		}
+	}
+	else
+	{
+		//all nodes are potential candidates, labels are checked one by one
+		for(host_id_type w = 0; w < g2.id_bound(); w++)
+		{
+			if(g2.has_id(w)) roots.push_back(w);
+		}
+	}
+	return roots;
+}
+
+template <typename GraphType, typename HostGraphType>
+bool SubgraphMatcher<GraphType, HostGraphType>::trivially_empty() const
+{
+	return order.empty() || g1.numNodes() > g2.numNodes() || g1.numEdges() > g2.numEdges();
+}
+
+template <typename GraphType, typename HostGraphType>
+bool SubgraphMatcher<GraphType, HostGraphType>::feasible(std::size_t pos, host_id_type w)
+{
+	// if w is already an image we've been there
+	if(M_inverse[w] != GraphType::invalid_id) return false;
+
+	// symmetry breaking, w has to respect the order of the mapped images
+	for(auto q : below[pos])
+	{
+		if(!(M[order[q]] < w)) return false;
+	}
+	for(auto q : above[pos])
+	{
+		if(!(w < M[order[q]])) return false;
+	}
+
+	// if the labels aren't the same skip
+	if constexpr(has_label_column_v<HostGraphType>)
+	{
+		if(!(g2.node_label(w) == labels[pos])) return false;
+	}
+	else
+	{
+		if(!(g2.findNode(g2.node_key(w))->second.getData().type == labels[pos])) return false;
+	}
+
+	// if the degree of v is greater than w, also not a candidate 
+	if(in_degrees[pos] > g2.in_ids(w).size() || out_degrees[pos] > g2.out_ids(w).size())
+		return false;
+
+	// every mapped neighbor of v must be mapped to a neighbor of w
+	auto v = order[pos];
+	for(auto x : g1.in_ids(v))
+	{
+		if(M[x] != unmapped && !g2.adjacent_ids(M[x], w)) return false;
+	}
+	for(auto x : g1.out_ids(v))
+	{
+		if(M[x] != unmapped && !g2.adjacent_ids(w, M[x])) return false;
+	}
+
+	// and the edges to them must carry the labels of the pattern edges
+	if constexpr(match_edge_labels)
+	{
+		for(const auto& check : edge_checks[pos])
+		{
+			auto image = M[order[check.anchor]];
+			const auto* data = check.forward ? g2.edge_data_ids(image, w) : g2.edge_data_ids(w, image);
+			if(!data || !(HostGraphType::edge_label_traits::get(*data) == check.label)) return false;
+		}
+	}
+	return true;
+}
+
+template <typename GraphType, typename HostGraphType>
+template <typename Visitor>
+void SubgraphMatcher<GraphType, HostGraphType>::run(Visitor&& visit)
+{
+	if(trivially_empty()) return;
+
+	auto roots = root_candidates();
+	run(roots.data(), roots.data() + roots.size(), std::forward<Visitor>(visit));
+}
+
+template <typename GraphType, typename HostGraphType>
+template <typename Visitor>
+bool SubgraphMatcher<GraphType, HostGraphType>::run(const host_id_type* first, const host_id_type* last, Visitor&& visit)
+{
+	auto n = order.size();
+	if(trivially_empty()) return true;
+
+	//the flat match state is left clean after every run, so a host that
+	//grew since only needs the new ids added
+	if(M.size() != g1.id_bound()) M.assign(g1.id_bound(), unmapped);
+	if(M_inverse.size() != g2.id_bound()) M_inverse.resize(g2.id_bound(), GraphType::invalid_id);
+
+	//the later components draw from all host vertices with their label
+	if(!seeded)
+	{
+		for(std::size_t pos = 1; pos < n; pos++)
+		{
+			if(anchors[pos].empty()) seeds[pos] = candidates(pos);
+		}
+		seeded = true;
+	}
+
+	std::size_t depth = 0;
+	bool stopped = false;
+	frames[0].next = first;
+	frames[0].last = last;
+	frames[0].assigned = unmapped;
+
+	while(true)
+	{
+		auto& frame = frames[depth];
+		auto v = order[depth];
+		
+		//take back the image this depth tried last
+		if(frame.assigned != unmapped)
+		{
+			M_inverse[frame.assigned] = GraphType::invalid_id;
+			M[v] = unmapped;
+			frame.assigned = unmapped;
+		}
+
+		//advance to the next feasible candidate
+		host_id_type w = unmapped;
+		if(anchors[depth].empty())
+		{
+			while(frame.next != frame.last)
+			{
+				auto c = *frame.next++;
+				if(feasible(depth, c)) { w = c; break; }
+			}
+		}
+		else
+		{
+			while(frame.cur != frame.end)
+			{
+				auto c = *frame.cur;
+				++frame.cur;
+				if(feasible(depth, c)) { w = c; break; }
+			}
+		}
+
+		//out of candidates, backtrack
+		if(w == unmapped)
+		{
+			if(depth == 0) break;
+			depth--;
+			continue;
+		}
+
+		M[v] = w;
+		M_inverse[w] = v;
+		frame.assigned = w;
+
+		if(depth + 1 == n)
+		{
+			if(!visit(static_cast<const match_type&>(M))) 
+			{
+				stopped = true;
+				break;
+			}
+			continue;
+		}
+
+		//the next vertex picks from the smallest neighborhood among the images
+		//of its anchors, or from its seeds if it starts a component
+		depth++;
+		auto& next = frames[depth];
+		next.assigned = unmapped;
+		if(anchors[depth].empty())
+		{
+			next.next = seeds[depth].data();
+			next.last = seeds[depth].data() + seeds[depth].size();
 			continue;
+		}
+		auto fewest = std::numeric_limits<std::size_t>::max();
+		for(auto [q, forward] : anchors[depth])
+		{
+			auto image = M[order[q]];
+			const auto& candidates = forward ? g2.out_ids(image) : g2.in_ids(image);
+			if(candidates.size() < fewest)
+			{
+				fewest = candidates.size();
+				next.cur = candidates.begin();
+				next.end = candidates.end();
+			}
+		}
+	}
+
+	//an early stop leaves images behind on the stack
+	for(std::size_t d = 0; stopped && d <= depth; d++)
+	{
+		if(frames[d].assigned != unmapped)
+		{
+			M_inverse[frames[d].assigned] = GraphType::invalid_id;
+			M[order[d]] = unmapped;
+			frames[d].assigned = unmapped;
+		}
+	}
+	return !stopped;
+}
+
+template <typename GraphType, typename HostGraphType>
+std::vector<typename GraphType::key_type> SubgraphMatcher<GraphType, HostGraphType>::pattern_keys() const
+{
+	std::vector<key_type> keys;
+	keys.reserve(order.size());
+	for(auto v : order)
+	{
+		keys.push_back(g1.node_key(v));
+	}
+	return keys;
+}
+
+template <typename GraphType, typename HostGraphType>
+Mtype<GraphType> SubgraphMatcher<GraphType, HostGraphType>::to_map(const match_type& match) const
+{
+	Mtype<GraphType> result;
+	for(auto v : order)
+	{
+		result.emplace(g1.node_key(v), g2.node_key(match[v]));
+	}
+	return result;
+}
+
+// NOTE: the host graph g2 may be a different representation than the pattern,
+// 			 e.g. a frozen CsrGraph, as long as both share the same key type
+template <typename GraphType, typename HostGraphType>
+Ltype<GraphType> subgraph_isomorphism2(GraphType& g1, HostGraphType& g2)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		// let L be an empty container of dictionaries of nodes to nodes
+		Ltype<GraphType> L{};
+
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+		matcher.run([&](const auto& M) {
+			L.push_back(matcher.to_map(M));
+			return true;
+		});
+		return L;
+	}
+	else
+	{
+		return keyed_subgraph_isomorphism2(g1, g2);
+	}
+}
+
+// Motivation: the streaming form of subgraph_isomorphism2. Each match is
+// 						 handed to visit(MatchView) while the search is paused on
+// 						 it, so counting, sampling or rewriting never materializes
+// 						 the result list. Returning false from visit stops the
+// 						 search, the number of matches visited is returned
+template <typename GraphType, typename HostGraphType, typename Visitor>
+std::size_t subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, Visitor&& visit)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	using key_type = typename GraphType::key_type;
+	
+	std::size_t count = 0;
+	std::vector<std::pair<key_type, key_type>> pairs;
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
 		
-		//check the type
-		auto w = g2.findNode(c);
-		auto& node_w = w->second;
-		auto& node_v = v->second;
+		//the pattern column of the buffer never changes, only the images do
+		const auto& order = matcher.matching_order();
+		pairs.resize(order.size());
+		for(std::size_t i = 0; i < order.size(); i++)
+		{
+			pairs[i].first = g1.node_key(order[i]);
+		}
+
+		matcher.run([&](const auto& M) {
+			for(std::size_t i = 0; i < order.size(); i++)
+			{
+				pairs[i].second = g2.node_key(M[order[i]]);
+			}
+			count++;
+			return visit_match(visit, MatchView<key_type>(pairs.data(), pairs.size()));
+		});
+	}
+	else
+	{
+		keyed_subgraph_isomorphism2(g1, g2, [&](const Mtype<GraphType>& M) {
+			pairs.assign(M.begin(), M.end());
+			count++;
+			return visit_match(visit, MatchView<key_type>(pairs.data(), pairs.size()));
+		});
+	}
+	return count;
+}
+
+// Motivation: passed in place of a visitor or pool to report every distinct
+// 						 embedding once instead of once per automorphism of the
+// 						 pattern, see SubgraphMatcher::break_symmetries
+struct BreakSymmetry {};
+
+inline constexpr BreakSymmetry break_symmetry{};
+
+template <typename GraphType, typename HostGraphType>
+Ltype<GraphType> subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, BreakSymmetry)
+{
+	static_assert(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>,
+			"symmetry breaking needs graphs with dense ids");
+
+	Ltype<GraphType> L{};
+
+	SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+	matcher.break_symmetries();
+	matcher.run([&](const auto& M) {
+		L.push_back(matcher.to_map(M));
+		return true;
+	});
+	return L;
+}
+
+template <typename GraphType, typename HostGraphType, typename Visitor>
+std::size_t subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, Visitor&& visit, BreakSymmetry)
+{
+	static_assert(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>,
+			"symmetry breaking needs graphs with dense ids");
 	
-		// if the types aren't the same skip
-		if(node_v.getData().type != node_w.getData().type)
-			continue;
+	using key_type = typename GraphType::key_type;
+
+	SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+	matcher.break_symmetries();
+	
+	const auto& order = matcher.matching_order();
+	std::vector<std::pair<key_type, key_type>> pairs(order.size());
+	for(std::size_t i = 0; i < order.size(); i++)
+	{
+		pairs[i].first = g1.node_key(order[i]);
+	}
+
+	std::size_t count = 0;
+	matcher.run([&](const auto& M) {
+		for(std::size_t i = 0; i < order.size(); i++)
+		{
+			pairs[i].second = g2.node_key(M[order[i]]);
+		}
+		count++;
+		return visit_match(visit, MatchView<key_type>(pairs.data(), pairs.size()));
+	});
+	return count;
+}
+
+// Motivation: subgraph_isomorphism2 with the matches kept in a MatchSet,
+// 						 one flat array of host keys instead of a map per match.
+// 						 The columns follow the matching order of the dense engine,
+// 						 or ascending pattern keys for the key based one
+template <typename GraphType, typename HostGraphType>
+MatchSet<typename GraphType::key_type> subgraph_match_set(GraphType& g1, HostGraphType& g2)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+	
+	using key_type = typename GraphType::key_type;
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+		MatchSet<key_type> matches(matcher.pattern_keys());
+		
+		const auto& order = matcher.matching_order();
+		matcher.run([&](const auto& M) {
+			auto row = matches.append_row();
+			for(std::size_t i = 0; i < order.size(); i++)
+			{
+				row[i] = g2.node_key(M[order[i]]);
+			}
+			return true;
+		});
+		return matches;
+	}
+	else
+	{
+		std::vector<key_type> columns;
+		for(const auto& [key, node] : g1.getNodeSetRef())
+		{
+			columns.push_back(key);
+		}
+		std::sort(columns.begin(), columns.end());
+		
+		//the maps iterate in key order, the same as the columns
+		MatchSet<key_type> matches(std::move(columns));
+		keyed_subgraph_isomorphism2(g1, g2, [&](const Mtype<GraphType>& M) {
+			auto row = matches.append_row();
+			for(const auto& [v, w] : M)
+			{
+				*row++ = w;
+			}
+			return true;
+		});
+		return matches;
+	}
+}
+
+// Motivation: every root candidate seeds its own search tree, so the roots
+// 						 are spread over the pool and each worker searches its share
+// 						 with a matcher of its own. The per worker match lists are
+// 						 concatenated at the end, in no particular order
+template <typename GraphType, typename HostGraphType>
+Ltype<GraphType> subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, ThreadPool& pool)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		using matcher_type = SubgraphMatcher<GraphType, HostGraphType>;
+
+		//the plan is made once and copied, the copies only share the graphs
+		matcher_type planner(g1, g2);
+		if(planner.trivially_empty()) return {};
+		auto roots = planner.root_candidates();
+
+		std::vector<matcher_type> matchers(pool.size(), planner);
+		std::vector<Ltype<GraphType>> found(pool.size());
+
+		//small chunks keep the stealing fine grained for uneven trees
+		auto grain = std::max<std::size_t>(1, roots.size() / (16 * pool.size()));
+		pool.parallel_for(roots.size(), grain, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+			auto& matcher = matchers[worker];
+			auto& L = found[worker];
+			matcher.run(roots.data() + begin, roots.data() + end, [&](const auto& M) {
+				L.push_back(matcher.to_map(M));
+				return true;
+			});
+		});
+
+		std::size_t total = 0;
+		for(auto& L : found) total += L.size();
+
+		Ltype<GraphType> L{};
+		L.reserve(total);
+		for(auto& part : found)
+		{
+			std::move(part.begin(), part.end(), std::back_inserter(L));
+		}
+		return L;
+	}
+	else
+	{
+		return keyed_subgraph_isomorphism2(g1, g2);
+	}
+}
+
+// Motivation: a rule often only asks whether its pattern occurs, how often,
+// 						 or for its first few occurrences. These stop the search as
+// 						 soon as the answer is known, and count_matches never turns
+// 						 an id match into keys at all
+template <typename GraphType, typename HostGraphType>
+bool match_exists(GraphType& g1, HostGraphType& g2)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	bool found = false;
+	auto stop = [&](const auto&) {
+		found = true;
+		return false;
+	};
 	
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+		matcher.run(stop);
+	}
+	else
+	{
+		keyed_subgraph_isomorphism2(g1, g2, stop);
+	}
+	return found;
+}
+
+template <typename GraphType, typename HostGraphType>
+std::size_t count_matches(GraphType& g1, HostGraphType& g2)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	std::size_t count = 0;
+	auto tally = [&](const auto&) {
+		count++;
+		return true;
+	};
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+		matcher.run(tally);
+	}
+	else
+	{
+		keyed_subgraph_isomorphism2(g1, g2, tally);
+	}
+	return count;
+}
+
+// at most k matches, in the order the search finds them
+template <typename GraphType, typename HostGraphType>
+MatchSet<typename GraphType::key_type> find_first_k(GraphType& g1, HostGraphType& g2, std::size_t k)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+	
+	using key_type = typename GraphType::key_type;
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+		MatchSet<key_type> matches(matcher.pattern_keys());
+		if(k == 0) return matches;
+		
+		matches.reserve(k);
+		const auto& order = matcher.matching_order();
+		matcher.run([&](const auto& M) {
+			auto row = matches.append_row();
+			for(std::size_t i = 0; i < order.size(); i++)
+			{
+				row[i] = g2.node_key(M[order[i]]);
+			}
+			return matches.size() < k;
+		});
+		return matches;
+	}
+	else
+	{
+		std::vector<key_type> columns;
+		for(const auto& [key, node] : g1.getNodeSetRef())
+		{
+			columns.push_back(key);
+		}
+		std::sort(columns.begin(), columns.end());
+		
+		MatchSet<key_type> matches(std::move(columns));
+		if(k == 0) return matches;
+
+		keyed_subgraph_isomorphism2(g1, g2, [&](const Mtype<GraphType>& M) {
+			auto row = matches.append_row();
+			for(const auto& [v, w] : M)
+			{
+				*row++ = w;
+			}
+			return matches.size() < k;
+		});
+		return matches;
+	}
+}
+
+template <typename GraphType, typename HostGraphType>
+std::size_t count_matches(GraphType& g1, HostGraphType& g2, BreakSymmetry)
+{
+	static_assert(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>,
+			"symmetry breaking needs graphs with dense ids");
+
+	std::size_t count = 0;
+	SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+	matcher.break_symmetries();
+	matcher.run([&](const auto&) {
+		count++;
+		return true;
+	});
+	return count;
+}
+
+template <typename GraphType, typename HostGraphType>
+MatchSet<typename GraphType::key_type> subgraph_match_set(GraphType& g1, HostGraphType& g2, BreakSymmetry)
+{
+	static_assert(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>,
+			"symmetry breaking needs graphs with dense ids");
+
+	SubgraphMatcher<GraphType, HostGraphType> matcher(g1, g2);
+	matcher.break_symmetries();
+	MatchSet<typename GraphType::key_type> matches(matcher.pattern_keys());
+	
+	const auto& order = matcher.matching_order();
+	matcher.run([&](const auto& M) {
+		auto row = matches.append_row();
+		for(std::size_t i = 0; i < order.size(); i++)
+		{
+			row[i] = g2.node_key(M[order[i]]);
+		}
+		return true;
+	});
+	return matches;
+}
+
+// subgraph_match_set spread over a pool, the per worker sets share their
+// columns so merging them is a copy of their host arrays
+template <typename GraphType, typename HostGraphType>
+MatchSet<typename GraphType::key_type> subgraph_match_set(GraphType& g1, HostGraphType& g2, ThreadPool& pool)
+{
+	static_assert(std::is_same_v<typename GraphType::key_type, typename HostGraphType::key_type>,
+			"pattern and host graphs must share a key type");
+
+	using key_type = typename GraphType::key_type;
+
+	if constexpr(has_dense_ids_v<GraphType> && has_dense_ids_v<HostGraphType>)
+	{
+		using matcher_type = SubgraphMatcher<GraphType, HostGraphType>;
+
+		matcher_type planner(g1, g2);
+		MatchSet<key_type> matches(planner.pattern_keys());
+		if(planner.trivially_empty()) return matches;
+		auto roots = planner.root_candidates();
+
+		std::vector<matcher_type> matchers(pool.size(), planner);
+		std::vector<MatchSet<key_type>> found(pool.size(), matches);
+		const auto& order = planner.matching_order();
+
+		auto grain = std::max<std::size_t>(1, roots.size() / (16 * pool.size()));
+		pool.parallel_for(roots.size(), grain, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+			auto& part = found[worker];
+			matchers[worker].run(roots.data() + begin, roots.data() + end, [&](const auto& M) {
+				auto row = part.append_row();
+				for(std::size_t i = 0; i < order.size(); i++)
+				{
+					row[i] = g2.node_key(M[order[i]]);
+				}
+				return true;
+			});
+		});
+
+		std::size_t total = 0;
+		for(auto& part : found) total += part.size();
+		
+		matches.reserve(total);
+		for(auto& part : found)
+		{
+			matches.append(part);
+		}
+		return matches;
+	}
+	else
+	{
+		return subgraph_match_set(g1, g2);
+	}
+}
+
+// The original key based matcher, kept for graphs without dense ids. Like
+// the planner it orders every component of a disconnected pattern
+template <typename GraphType, typename HostGraphType>
+Ltype<GraphType> keyed_subgraph_isomorphism2(GraphType& g1, HostGraphType& g2)
+{
+	// let L be an empty container of dictionaries of nodes to nodes
+	Ltype<GraphType> L{};
+
+	keyed_subgraph_isomorphism2(g1, g2, [&](const Mtype<GraphType>& M) {
+		L.push_back(M);
+		return true;
+	});
+	return L;
+}
+
+// calls emit(M) for every match, returns false if emit stopped the search
+template <typename GraphType, typename HostGraphType, typename Emit>
+bool keyed_subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, Emit&& emit)
+{
+	//std::cout << "Running subgraph isomorphism\n";
+
+	// let M be an empty dictionary of nodes to nodes 
+	Mtype<GraphType> M{};
+	Mtype<GraphType> M_inverse{};	
+	//find a dfs orderding for g1, a search from every vertex the earlier
+	//ones did not reach so disconnected patterns are ordered whole
+	std::unordered_set<typename GraphType::key_type> visited;
+	std::vector<std::pair<typename GraphType::key_type, std::size_t>> path;
+	for(auto iter = g1.node_list_begin(); iter != g1.node_list_end(); iter++)
+	{
+		if(visited.find(iter->first) == visited.end())
+			impl_recursive_dfs2(g1, iter->first, visited, path);
+	}
+	
+	if(path.size() == 0) return true;
+
+	//build a tree for the preorder traversal, every later search starts
+	//another root
+	FlatNTree<typename GraphType::key_type> rst(path[0].first);
+	if(path.size() > 1)
+	{
+		for(auto i = 1; i < path.size(); i++)
+		{
+			if(path[i].second == 0)
+			{
+				rst.add_root(path[i].first);
+				continue;
+			}
+
+			//parent is node of previous depth 
+			typename GraphType::key_type parent; 
+			
+			for(auto j = i-1; j >= 0; j--)
+			{
+				if(path[i].second == (path[j].second + 1))
+				{
+					parent = path[j].first;
+					break;
+				}
+				else 
+					parent = path[0].first;
+			}
+			rst.add_node(path[i].first, parent);
+		}
+	}
+	
+	//set v to be the first item in the total orderding of the dfs tree
+	int idx = 0;
+	auto v = g1.findNode(rst.indexed_key(idx));
+	
+	//if g1 has more nodes than g2, can't be a subgraph, but equal we'll let it slide
+	//same with edges
+	if(g1.numNodes() > g2.numNodes() || g1.numEdges() > g2.numEdges())
+		return true;
+
+	//tries w as the image of the first ordered vertex of g1, false once
+	//emit asks to stop
+	auto try_root = [&](auto w)
+	{
+		//if the degree of v is greater than w, also not a candidate 
+		if(preserve_adjacencies2(g1, g2, M, v, w))	
+		{
+			M.insert_or_assign(v->first, w->first);	
+			M_inverse.insert_or_assign(w->first, v->first);
+			
+			if(idx+1 == rst.index.size())
+			{
+				if(!emit(static_cast<const Mtype<GraphType>&>(M))) return false;
+				//a single vertex pattern has to forget the root as well
+				M.erase(v->first);
+				M_inverse.erase(w->first);
+			}
+			else 
+			{
+				int idx_next = idx+1;
+				auto v_prime = g1.findNode(rst.indexed_key(idx_next));
+				if(!extend_subgraph_isomorphism2(g1, g2, M, M_inverse, idx_next, v_prime, emit, rst)) 
+					return false;
+				M.erase(v->first);
+				M_inverse.erase(w->first);
+			}
+		}
+		return true;
+	};
+
+	//all nodes are potential candidates for the first ordered vertex of g1
+	for(auto& n : g2.getNodeSetRef())
+	{
+		//TODO: fix the wierd pointer issue caused by this in preserve_adjacencies2 
+		auto w = g2.findNode(n.first); //my janky fix, but makes no sense since we iter g2
+		auto& node_w = w->second;
+		auto& node_v = v->second;
+
+		//if labels are different not a candidate 
+		if(node_v.getData().type == node_w.getData().type)
+		{
+			if(!try_root(w)) return false;
+		}
+	}
+	return true;
+}
+
+template <typename GraphType, typename HostGraphType, typename NodeTypeIter, typename Emit>
+bool extend_subgraph_isomorphism2(GraphType& g1, HostGraphType& g2, Mtype<GraphType>& M, Mtype<GraphType>& M_inverse, 
+		int idx, NodeTypeIter v, Emit& emit, FlatNTree<typename GraphType::key_type>& rst)
+{
+	//tries the host vertex c, found at w, as the image of v, false once
+	//emit asks to stop
+	auto try_candidate = [&](const auto& c, auto w)
+	{
 		// check to see if adjecencies are preserved 
 		if(preserve_adjacencies2(g1, g2, M, v, w))
 		{
@@ -778,7 +2268,7 @@ void extend_subgraph_isomorphism2(GraphType& g1, GraphType& g2, Mtype<GraphType>
 			// if v is the last vertex the rst, then append M to L 
 			if(idx+1 == rst.index.size())
 			{
-				L.push_back(M); 
+				if(!emit(static_cast<const Mtype<GraphType>&>(M))) return false;
 				M.erase(v->first);
 				M_inverse.erase(c);
 			}
@@ -787,20 +2277,72 @@ void extend_subgraph_isomorphism2(GraphType& g1, GraphType& g2, Mtype<GraphType>
 			{
 				int idx_next = idx+1;
 				auto v_prime = g1.findNode(rst.indexed_key(idx_next));
-				extend_subgraph_isomorphism2(g1, g2, M, M_inverse, idx_next, v_prime, L, rst);
+				if(!extend_subgraph_isomorphism2(g1, g2, M, M_inverse, idx_next, v_prime, emit, rst))
+					return false;
 				//erase from matches on the unwind
 				M.erase(v->first);
 				M_inverse.erase(c);
 			}	
 		}
+		return true;
+	};
+
+	//the root of a later component has no parent to follow, any host vertex
+	//with its label that we haven't visited is a candidate
+	if(rst.indexed_root(idx))
+	{
+		for(auto& n : g2.getNodeSetRef())
+		{
+			if(M_inverse.find(n.first) != M_inverse.end())
+				continue;
+			auto w = g2.findNode(n.first);
+			if(v->second.getData().type != w->second.getData().type)
+				continue;
+			if(!try_candidate(n.first, w)) return false;
+		}
+		return true;
 	}
+
+	//the starting candidates are anything connected to the node w, of node
+	//v mapped to w of the previous depth that we haven't visited
+	//aka successor of node of previous depth that we haven't visited
+	auto parent = g2.findNode(M[rst.indexed_parent(idx)]);
+	const auto& node_candidates = g2.out_neighbors(parent->first);
+
+	for(auto iter = node_candidates.begin(); iter != node_candidates.end(); ++iter)
+	{
+		const auto& c = *iter;
+
+		// if w is in M_inverse then skip since we've already been there
+		if(M_inverse.find(c) != M_inverse.end()) 
+			continue;
+		
+		// if the types aren't the same skip, with a label column before
+		// the candidate node is even looked up
+		if constexpr(has_label_column_v<HostGraphType>)
+		{
+			if(!(g2.node_label(iter.id()) == v->second.getData().type))
+				continue;
+		}
+		
+		auto w = g2.findNode(c);
+		
+		if constexpr(!has_label_column_v<HostGraphType>)
+		{
+			if(v->second.getData().type != w->second.getData().type)
+				continue;
+		}
+	
+		if(!try_candidate(c, w)) return false;
+	}
+	return true;
 }
 
-template <typename GraphType, typename NodeTypeIter>
-bool preserve_adjacencies2(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, NodeTypeIter& v, NodeTypeIter& w)
+template <typename GraphType, typename HostGraphType, typename NodeTypeIter, typename HostNodeTypeIter>
+bool preserve_adjacencies2(GraphType& g1, HostGraphType& g2, Mtype<GraphType>& M, NodeTypeIter& v, HostNodeTypeIter& w)
 {
-	auto node_v = v->second;
-	auto node_w = w->second;
+	const auto& node_v = v->second;
+	const auto& node_w = w->second;
 
 	// if the degree of the nodes aren't the same, no match
 	if(g1.in_degree(node_v) > g2.in_degree(node_w) || g1.out_degree(node_v) > g2.out_degree(node_w))
@@ -812,7 +2354,7 @@ bool preserve_adjacencies2(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, No
 	for(auto& x : g1.in_neighbors(node_v))
 	{
 		// if the src vertex, x, in M and M[x] is not adjecent with w in G2, no match 
-		if(M.find(x) != M.end() && !g2.adjacent(M[x], w->first))
+		if(M.find(x) != M.end() && (!g2.adjacent(M[x], w->first) || !edge_labels_agree(g1, x, v->first, g2, M[x], w->first)))
 		{
 			//std::cout << "Adjacency test failed for in neighbors\n";
 			return false;
@@ -822,7 +2364,7 @@ bool preserve_adjacencies2(GraphType& g1, GraphType& g2, Mtype<GraphType>& M, No
 	for(auto& x : g1.out_neighbors(node_v))
 	{
 		// if the target vertex, x, in M and w is not adjecent with M[x] in G2, no match 
-		if(M.find(x) != M.end() && !g2.adjacent(w->first, M[x]))
+		if(M.find(x) != M.end() && (!g2.adjacent(w->first, M[x]) || !edge_labels_agree(g1, v->first, x, g2, w->first, M[x])))
 		{
 			//std::cout << "Adjacency test failed for out neighbors\n";
 			return false;
@@ -0,0 +1,392 @@
+#ifndef YAGL_CONCURRENT_GRAPH_HPP
+#define YAGL_CONCURRENT_GRAPH_HPP
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional> // for hash
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "YAGL_Node.hpp"
+#include "YAGL_Graph_Traits.hpp"
+#include "YAGL_Graph.hpp"
+
+namespace YAGL
+{
+	// Motivation: particle insertion wants many threads adding nodes and
+	// 						 edges at once, but a Graph has no synchronization and an
+	// 						 edge touches the neighbor sets of two nodes. A concurrent
+	// 						 graph spreads its nodes over shards by key hash, each
+	// 						 shard with its own lock and key map, so threads working on
+	// 						 different nodes rarely meet. An edge locks the shards of
+	// 						 both ends, a node removal the shards of all its neighbors,
+	// 						 always in shard order so no two threads can wait on each
+	// 						 other. Node and edge counts are kept in atomics that are
+	// 						 changed under the same locks as the sets
+	//
+	// NOTE: 			 there are no dense ids, the neighbor sets hold keys since
+	// 						 handing out ids would serialize every addNode. Data is
+	// 						 returned by copy, references could be changed under the
+	// 						 caller. Run the algorithms on the Graph from to_graph()
+	template <typename KeyType, typename DataType, typename Traits = DefaultGraphTraits>
+	class ConcurrentGraph
+	{
+		static_assert(std::is_same_v<typename Traits::edge_data_type, NoEdgeData>,
+				"concurrent graphs do not keep edge data");
+		static_assert(!Traits::change_log && !Traits::journal && !Traits::memory_resource,
+				"concurrent graphs do not record changes or take a memory resource");
+
+		public:
+			using key_type = KeyType;
+			using data_type = DataType;
+			using node_type = Node<key_type, data_type>;
+			using traits_type = Traits;
+
+			using key_set_type = typename Traits::template neighbor_set_type<key_type>;
+			static constexpr bool is_directed = Traits::directed;
+			using in_out_nbr_type = NeighborSets<key_set_type, is_directed>;
+
+			using counting_type = std::size_t;
+			using graph_type = Graph<key_type, data_type, Traits>;
+
+			// zero shards picks a default suited to a few dozen threads
+			explicit ConcurrentGraph(std::size_t num_shards = 0);
+
+			ConcurrentGraph(const ConcurrentGraph&) = delete;
+			ConcurrentGraph& operator=(const ConcurrentGraph&) = delete;
+
+			std::size_t num_shards() const { return shard_count; }
+
+			void addNode(const node_type& node);
+			void addNode(node_type&& node);
+			void removeNode(const KeyType& key);
+
+			// replaces the payload of an existing node, missing keys are ignored
+			void setData(const KeyType& key, const DataType& data);
+
+			// a copy of the payload, nothing if there is no such node
+			std::optional<DataType> getData(const KeyType& key) const;
+			bool contains(const KeyType& key) const;
+
+			void addEdge(const KeyType& key_a, const KeyType& key_b);
+			void removeEdge(const KeyType& key_a, const KeyType& key_b);
+			bool adjacent(const KeyType& key_a, const KeyType& key_b) const;
+
+			// copies of the neighborhood as it was when asked
+			std::vector<key_type> out_neighbors(const KeyType& key) const;
+			std::vector<key_type> in_neighbors(const KeyType& key) const;
+			counting_type degree(const KeyType& key) const;
+
+			counting_type numNodes() const { return num_nodes.load(std::memory_order_relaxed); }
+			counting_type numEdges() const { return num_edges.load(std::memory_order_relaxed); }
+
+			bool isDirected() const { return is_directed; }
+
+			// Motivation: a consistent copy into an ordinary graph, every shard
+			// 						 is locked while it is taken
+			graph_type to_graph() const;
+
+		private:
+			struct Entry
+			{
+				node_type node;
+				in_out_nbr_type nbrs;
+
+				explicit Entry(const node_type& n) : node(n) {}
+				explicit Entry(node_type&& n) : node(std::move(n)) {}
+			};
+
+			using entry_map_type = typename Traits::template map_type<key_type, Entry>;
+			using lock_type = std::unique_lock<std::mutex>;
+
+			// a shard on a cache line of its own, so locking one does not slow
+			// down its neighbors
+			struct alignas(64) Shard
+			{
+				mutable std::mutex lock;
+				entry_map_type nodes;
+			};
+
+			std::size_t shard_count;
+			std::unique_ptr<Shard[]> shards;
+			std::atomic<counting_type> num_nodes;
+			std::atomic<counting_type> num_edges;
+
+			std::size_t shard_of(const KeyType& key) const { return std::hash<KeyType>()(key) % shard_count; }
+			Entry* find(const KeyType& key) const;
+
+			// locks the shards of both ends in shard order, a shared shard once
+			std::pair<lock_type, lock_type> lock_pair(const KeyType& key_a, const KeyType& key_b) const;
+
+			template <typename NodeArg>
+			void insert(NodeArg&& node);
+	};
+
+	template <typename KeyType, typename DataType, typename Traits>
+	ConcurrentGraph<KeyType, DataType, Traits>::ConcurrentGraph(std::size_t num_shards)
+	: shard_count(num_shards ? num_shards : 256), shards(new Shard[shard_count]), num_nodes(0), num_edges(0)
+	{
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename ConcurrentGraph<KeyType, DataType, Traits>::Entry*
+	ConcurrentGraph<KeyType, DataType, Traits>::find(const KeyType& key) const
+	{
+		//the caller holds the lock of the shard
+		auto& nodes = shards[shard_of(key)].nodes;
+		auto iter = nodes.find(key);
+		return iter == nodes.end() ? nullptr : const_cast<Entry*>(&iter->second);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::pair<typename ConcurrentGraph<KeyType, DataType, Traits>::lock_type,
+						typename ConcurrentGraph<KeyType, DataType, Traits>::lock_type>
+	ConcurrentGraph<KeyType, DataType, Traits>::lock_pair(const KeyType& key_a, const KeyType& key_b) const
+	{
+		auto s = shard_of(key_a);
+		auto t = shard_of(key_b);
+		if(t < s) std::swap(s, t);
+
+		lock_type first(shards[s].lock);
+		lock_type second;
+		if(t != s) second = lock_type(shards[t].lock);
+		return {std::move(first), std::move(second)};
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename NodeArg>
+	void ConcurrentGraph<KeyType, DataType, Traits>::insert(NodeArg&& node)
+	{
+		auto& shard = shards[shard_of(node.getKey())];
+		std::lock_guard<std::mutex> guard(shard.lock);
+
+		//an existing node only has its data replaced and keeps its edges
+		auto iter = shard.nodes.find(node.getKey());
+		if(iter != shard.nodes.end())
+		{
+			iter->second.node = std::forward<NodeArg>(node);
+			return;
+		}
+		KeyType key = node.getKey();
+		shard.nodes.emplace(key, Entry(std::forward<NodeArg>(node)));
+		num_nodes.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::addNode(const node_type& node)
+	{
+		insert(node);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::addNode(node_type&& node)
+	{
+		insert(std::move(node));
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::removeNode(const KeyType& key)
+	{
+		auto own = shard_of(key);
+		while(true)
+		{
+			//find the shards of the neighbors first, then lock them all in order
+			std::vector<std::size_t> needed{own};
+			{
+				std::lock_guard<std::mutex> guard(shards[own].lock);
+				auto entry = find(key);
+				if(!entry) return; //cannot remove what does not exist
+
+				for(const auto& u : entry->nbrs.out()) needed.push_back(shard_of(u));
+				if constexpr(is_directed)
+				{
+					for(const auto& u : entry->nbrs.in()) needed.push_back(shard_of(u));
+				}
+			}
+			std::sort(needed.begin(), needed.end());
+			needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+
+			std::vector<lock_type> guards;
+			guards.reserve(needed.size());
+			for(auto s : needed)
+			{
+				guards.emplace_back(shards[s].lock);
+			}
+
+			//the neighborhood may have changed in between, start over if it
+			//grew into a shard that is not locked
+			auto entry = find(key);
+			if(!entry) return;
+
+			auto locked = [&](const KeyType& u) {
+				return std::binary_search(needed.begin(), needed.end(), shard_of(u));
+			};
+			bool covered = std::all_of(entry->nbrs.out().begin(), entry->nbrs.out().end(), locked);
+			if constexpr(is_directed)
+			{
+				covered = covered && std::all_of(entry->nbrs.in().begin(), entry->nbrs.in().end(), locked);
+			}
+			if(!covered) continue;
+
+			//a loop shows up in both sets of a directed node but is one edge
+			counting_type removed = entry->nbrs.out().size();
+			for(const auto& u : entry->nbrs.out())
+			{
+				if(!(u == key)) find(u)->nbrs.in().erase(key);
+			}
+			if constexpr(is_directed)
+			{
+				removed += entry->nbrs.in().size() - entry->nbrs.out().count(key);
+				for(const auto& u : entry->nbrs.in())
+				{
+					if(!(u == key)) find(u)->nbrs.out().erase(key);
+				}
+			}
+
+			shards[own].nodes.erase(key);
+			num_nodes.fetch_sub(1, std::memory_order_relaxed);
+			num_edges.fetch_sub(removed, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::setData(const KeyType& key, const DataType& data)
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		if(auto entry = find(key)) entry->node.getData() = data;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::optional<DataType> ConcurrentGraph<KeyType, DataType, Traits>::getData(const KeyType& key) const
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		auto entry = find(key);
+		if(!entry) return std::nullopt;
+		return entry->node.getData();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	bool ConcurrentGraph<KeyType, DataType, Traits>::contains(const KeyType& key) const
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		return find(key) != nullptr;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::addEdge(const KeyType& key_a, const KeyType& key_b)
+	{
+		auto guards = lock_pair(key_a, key_b);
+		auto entry_a = find(key_a);
+		auto entry_b = find(key_b);
+		if(!entry_a || !entry_b)
+		{
+			return; // don't add anything
+		}
+
+		//the out set of a decides whether the edge is new, the other set
+		//only mirrors it
+		if(entry_a->nbrs.out().insert(key_b).second)
+		{
+			entry_b->nbrs.in().insert(key_a);
+			num_edges.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void ConcurrentGraph<KeyType, DataType, Traits>::removeEdge(const KeyType& key_a, const KeyType& key_b)
+	{
+		auto guards = lock_pair(key_a, key_b);
+		auto entry_a = find(key_a);
+		auto entry_b = find(key_b);
+		if(!entry_a || !entry_b)
+		{
+			return; //cannot remove what does not exist
+		}
+
+		if(entry_a->nbrs.out().erase(key_b))
+		{
+			entry_b->nbrs.in().erase(key_a);
+			num_edges.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	bool ConcurrentGraph<KeyType, DataType, Traits>::adjacent(const KeyType& key_a, const KeyType& key_b) const
+	{
+		//the out set of a alone says whether the edge is there
+		std::lock_guard<std::mutex> guard(shards[shard_of(key_a)].lock);
+		auto entry = find(key_a);
+		return entry && entry->nbrs.out().count(key_b);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::vector<KeyType> ConcurrentGraph<KeyType, DataType, Traits>::out_neighbors(const KeyType& key) const
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		auto entry = find(key);
+		if(!entry) return {};
+		return std::vector<KeyType>(entry->nbrs.out().begin(), entry->nbrs.out().end());
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::vector<KeyType> ConcurrentGraph<KeyType, DataType, Traits>::in_neighbors(const KeyType& key) const
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		auto entry = find(key);
+		if(!entry) return {};
+		return std::vector<KeyType>(entry->nbrs.in().begin(), entry->nbrs.in().end());
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename ConcurrentGraph<KeyType, DataType, Traits>::counting_type
+	ConcurrentGraph<KeyType, DataType, Traits>::degree(const KeyType& key) const
+	{
+		std::lock_guard<std::mutex> guard(shards[shard_of(key)].lock);
+		auto entry = find(key);
+		return entry ? entry->nbrs.degree() : 0;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename ConcurrentGraph<KeyType, DataType, Traits>::graph_type
+	ConcurrentGraph<KeyType, DataType, Traits>::to_graph() const
+	{
+		std::vector<lock_type> guards;
+		guards.reserve(shard_count);
+		for(std::size_t s = 0; s < shard_count; s++)
+		{
+			guards.emplace_back(shards[s].lock);
+		}
+
+		std::vector<node_type> nodes;
+		std::vector<std::pair<key_type, key_type>> edges;
+		nodes.reserve(numNodes());
+		edges.reserve(numEdges());
+		for(std::size_t s = 0; s < shard_count; s++)
+		{
+			for(const auto& [key, entry] : shards[s].nodes)
+			{
+				nodes.push_back(entry.node);
+				for(const auto& nbr : entry.nbrs.out())
+				{
+					edges.emplace_back(key, nbr);
+				}
+			}
+		}
+
+		//the bulk loader drops the second copy of every undirected edge
+		graph_type graph;
+		graph.bulk_load(nodes, edges);
+		return graph;
+	}
+
+} // end namespace YAGL
+
+#endif
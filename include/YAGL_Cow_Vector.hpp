@@ -0,0 +1,130 @@
+#ifndef YAGL_COW_VECTOR_HPP
+#define YAGL_COW_VECTOR_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace YAGL
+{
+	// Motivation: a vector whose copies share their storage. Elements live in
+	// 						 fixed size chunks behind shared pointers and the list of
+	// 						 chunks is shared as well, so a copy is one pointer copy.
+	// 						 Reads go through both levels, a write first unshares the
+	// 						 chunk list and then the one chunk it lands in, so a copy
+	// 						 that is written to pays for the chunks it touches and
+	// 						 keeps sharing the rest with the original
+	//
+	// NOTE: 			 elements are only reachable by index, references handed
+	// 						 out by mutate are invalidated by the next copy of the
+	// 						 vector. Copies may be read and written on different
+	// 						 threads, but one vector must not be used from two
+	template <typename T, std::size_t ChunkSize = 64>
+	class CowVector
+	{
+		static_assert(ChunkSize > 0, "chunks need room for at least one element");
+
+		public:
+			using value_type = T;
+			using size_type = std::size_t;
+			static constexpr size_type chunk_size = ChunkSize;
+
+			CowVector() : count(0) {}
+
+			size_type size() const { return count; }
+			bool empty() const { return count == 0; }
+
+			const T& operator[](size_type i) const { return (*(*chunks)[i / ChunkSize])[i % ChunkSize]; }
+
+			// a writable element, its chunk is cloned first if another copy
+			// still shares it
+			T& mutate(size_type i) { return own_chunk(i / ChunkSize)[i % ChunkSize]; }
+
+			template <typename ... Args>
+			T& emplace_back(Args&& ... args);
+			void push_back(const T& value) { emplace_back(value); }
+			void push_back(T&& value) { emplace_back(std::move(value)); }
+
+			void clear();
+
+			// whether element i of both vectors is kept in the same chunk, the
+			// element has not been written to by either since they were copied
+			bool shares(const CowVector& other, size_type i) const;
+
+		private:
+			using chunk_type = std::vector<T>;
+			using chunk_list_type = std::vector<std::shared_ptr<chunk_type>>;
+
+			std::shared_ptr<chunk_list_type> chunks;
+			size_type count;
+
+			chunk_list_type& own_chunks();
+			chunk_type& own_chunk(size_type c);
+	};
+
+	template <typename T, std::size_t ChunkSize>
+	typename CowVector<T, ChunkSize>::chunk_list_type& CowVector<T, ChunkSize>::own_chunks()
+	{
+		if(!chunks)
+		{
+			chunks = std::make_shared<chunk_list_type>();
+		}
+		else if(chunks.use_count() > 1)
+		{
+			//the chunks themselves stay shared, copying the list only adds
+			//one more owner to each
+			chunks = std::make_shared<chunk_list_type>(*chunks);
+		}
+		return *chunks;
+	}
+
+	template <typename T, std::size_t ChunkSize>
+	typename CowVector<T, ChunkSize>::chunk_type& CowVector<T, ChunkSize>::own_chunk(size_type c)
+	{
+		auto& chunk = own_chunks()[c];
+		if(chunk.use_count() > 1)
+		{
+			auto copy = std::make_shared<chunk_type>();
+			copy->reserve(ChunkSize);
+			copy->insert(copy->end(), chunk->begin(), chunk->end());
+			chunk = std::move(copy);
+		}
+		return *chunk;
+	}
+
+	template <typename T, std::size_t ChunkSize>
+	template <typename ... Args>
+	T& CowVector<T, ChunkSize>::emplace_back(Args&& ... args)
+	{
+		if(count % ChunkSize == 0)
+		{
+			auto& list = own_chunks();
+			list.push_back(std::make_shared<chunk_type>());
+			list.back()->reserve(ChunkSize);
+		}
+		auto& chunk = own_chunk(count / ChunkSize);
+		count++;
+		return chunk.emplace_back(std::forward<Args>(args)...);
+	}
+
+	template <typename T, std::size_t ChunkSize>
+	void CowVector<T, ChunkSize>::clear()
+	{
+		//other copies keep their chunks alive
+		chunks.reset();
+		count = 0;
+	}
+
+	template <typename T, std::size_t ChunkSize>
+	bool CowVector<T, ChunkSize>::shares(const CowVector& other, size_type i) const
+	{
+		if(i >= count || i >= other.count) return false;
+		return (*chunks)[i / ChunkSize] == (*other.chunks)[i / ChunkSize];
+	}
+
+} // end namespace YAGL
+
+#endif
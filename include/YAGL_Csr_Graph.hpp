@@ -0,0 +1,458 @@
+#ifndef YAGL_CSR_GRAPH_HPP
+#define YAGL_CSR_GRAPH_HPP
+
+#pragma once
+
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <utility> // for pair
+#include <algorithm> // for sort and binary_search
+#include <cstdint>
+#include <limits>
+
+#include "YAGL_Node.hpp"
+#include "YAGL_Key_Range.hpp"
+
+namespace YAGL
+{
+	template <typename KeyType, typename DataType>
+	class CsrGraph;
+
+	template <typename KeyType, typename DataType>
+	std::ostream& operator<<(std::ostream& os, CsrGraph<KeyType, DataType>& graph);
+
+	// Motivation: an immutable compressed sparse row snapshot of a graph. Every
+	// 						 vertex gets a dense id in [0, numNodes()) and its neighbors
+	// 						 live in one contiguous, sorted slice of a shared array, so
+	// 						 read only passes stream through memory instead of chasing
+	// 						 hash buckets.
+	//
+	// NOTE: 			 the topology is frozen at construction, node payloads may
+	// 						 still be modified through findNode or operator[]
+	template <typename KeyType, typename DataType>
+	class CsrGraph
+	{
+		public:
+			using key_type = KeyType;
+			using data_type = DataType;
+			using node_type = Node<key_type, data_type>;
+
+			using id_type = std::uint32_t;
+			using offset_type = std::size_t;
+			static constexpr id_type invalid_id = std::numeric_limits<id_type>::max();
+
+			// nodes are stored by dense id but keep the (key, node) pairing of the
+			// dynamic graph so the generic algorithms can walk either one
+			using node_list_type = std::vector<std::pair<key_type, node_type>>;
+			using key_list_type = std::vector<key_type>;
+			using id_list_type = std::vector<id_type>;
+			using offset_list_type = std::vector<offset_type>;
+			using id_map_type = std::unordered_map<key_type, id_type>;
+
+			using counting_type = typename node_list_type::size_type;
+
+			using node_iterator = typename node_list_type::iterator;
+			using const_node_iterator = typename node_list_type::const_iterator;
+
+			using id_range_type = IdSpan<id_type>;
+			using node_set_type = KeyRange<const id_type*, key_type>;
+			using node_set_nbr_iterator = typename node_set_type::iterator;
+
+		private:
+			node_list_type node_list;
+			key_list_type key_list;
+			id_map_type id_map;
+
+			offset_list_type out_offsets;
+			id_list_type out_targets;
+
+			// only populated for directed sources, undirected graphs reuse the out arrays
+			offset_list_type in_offsets;
+			id_list_type in_targets;
+
+			bool undirected;
+			counting_type num_edges;
+
+			template <typename NbrRange>
+			void append_neighbors(NbrRange&& nbrs, offset_list_type& offsets, id_list_type& targets);
+
+			// in plus out when directed, like NeighborSets::degree
+			offset_type id_degree(id_type id) const;
+
+		public:
+			CsrGraph();
+
+			template <typename GraphType>
+			explicit CsrGraph(GraphType& graph);
+
+			node_iterator node_list_begin();
+			node_iterator node_list_end();
+
+			node_list_type& getNodeSetRef();
+
+			node_iterator findNode(KeyType k);
+
+			// dense id interface
+			id_type id_bound() const;
+			id_type node_id(const KeyType& key) const;
+			const KeyType& node_key(id_type id) const;
+			bool has_id(id_type id) const;
+
+			id_range_type out_ids(id_type id) const;
+			id_range_type in_ids(id_type id) const;
+
+			bool adjacent_ids(id_type id_a, id_type id_b) const;
+
+			// key and node interface, mirrors Graph
+			node_set_type out_neighbors(const Node<KeyType, DataType>& node) const;
+			node_set_type in_neighbors(const Node<KeyType, DataType>& node) const;
+
+			node_set_type out_neighbors(KeyType key) const;
+			node_set_type in_neighbors(KeyType key) const;
+
+			node_set_nbr_iterator out_neighbors_begin(KeyType key) const;
+			node_set_nbr_iterator out_neighbors_end(KeyType key) const;
+
+			node_set_nbr_iterator in_neighbors_begin(KeyType key) const;
+			node_set_nbr_iterator in_neighbors_end(KeyType key) const;
+
+			bool adjacent(const KeyType& key_a, const KeyType& key_b) const;
+
+			counting_type numNodes() const;
+
+			counting_type numEdges() const;
+
+			counting_type in_degree(const Node<KeyType, DataType>& node) const;
+
+			counting_type out_degree(const Node<KeyType, DataType>& node) const;
+
+			counting_type degree(const Node<KeyType, DataType>& node) const;
+
+			counting_type min_degree() const;
+
+			counting_type max_degree() const;
+
+			double avg_degree() const;
+
+			bool isDirected() const;
+
+			bool isUndirected() const;
+
+			DataType& operator[](KeyType k) { return findNode(k)->second.getData(); }
+
+			friend std::ostream &operator<<<>(std::ostream& os, CsrGraph<KeyType, DataType>& graph);
+	};
+
+	template <typename KeyType, typename DataType>
+	CsrGraph<KeyType, DataType>::CsrGraph() : out_offsets(1, 0), undirected(true), num_edges(0)
+	{
+
+	}
+
+	template <typename KeyType, typename DataType>
+	template <typename GraphType>
+	CsrGraph<KeyType, DataType>::CsrGraph(GraphType& graph)
+	: undirected(graph.isUndirected()), num_edges(graph.numEdges())
+	{
+		auto n = graph.numNodes();
+
+		node_list.reserve(n);
+		key_list.reserve(n);
+		id_map.reserve(n);
+
+		//first pass hands out the dense ids in iteration order
+		for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+		{
+			auto id = static_cast<id_type>(key_list.size());
+			node_list.emplace_back(iter->first, iter->second);
+			key_list.push_back(iter->first);
+			id_map.emplace(iter->first, id);
+		}
+
+		//second pass lays the neighborhoods out back to back
+		out_offsets.reserve(n+1);
+		out_offsets.push_back(0);
+		for(const auto& key : key_list)
+		{
+			append_neighbors(graph.out_neighbors(key), out_offsets, out_targets);
+		}
+
+		if(!undirected)
+		{
+			in_offsets.reserve(n+1);
+			in_offsets.push_back(0);
+			for(const auto& key : key_list)
+			{
+				append_neighbors(graph.in_neighbors(key), in_offsets, in_targets);
+			}
+		}
+	}
+
+	template <typename KeyType, typename DataType>
+	template <typename NbrRange>
+	void CsrGraph<KeyType, DataType>::append_neighbors(NbrRange&& nbrs,
+			offset_list_type& offsets, id_list_type& targets)
+	{
+		auto first = targets.size();
+		for(const auto& k : nbrs)
+		{
+			targets.push_back(id_map.find(k)->second);
+		}
+		//sorted slices let adjacency checks binary search
+		std::sort(targets.begin() + first, targets.end());
+		offsets.push_back(targets.size());
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_iterator CsrGraph<KeyType, DataType>::node_list_begin()
+	{
+		return node_list.begin();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_iterator CsrGraph<KeyType, DataType>::node_list_end()
+	{
+		return node_list.end();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_list_type& CsrGraph<KeyType, DataType>::getNodeSetRef()
+	{
+		return node_list;
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_iterator CsrGraph<KeyType, DataType>::findNode(KeyType k)
+	{
+		auto id = node_id(k);
+		if(id == invalid_id) return node_list.end();
+		return node_list.begin() + id;
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::id_type CsrGraph<KeyType, DataType>::id_bound() const
+	{
+		return static_cast<id_type>(key_list.size());
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::id_type
+	CsrGraph<KeyType, DataType>::node_id(const KeyType& key) const
+	{
+		auto iter = id_map.find(key);
+		if(iter == id_map.end()) return invalid_id;
+		return iter->second;
+	}
+
+	template <typename KeyType, typename DataType>
+	const KeyType& CsrGraph<KeyType, DataType>::node_key(id_type id) const
+	{
+		return key_list[id];
+	}
+
+	template <typename KeyType, typename DataType>
+	bool CsrGraph<KeyType, DataType>::has_id(id_type id) const
+	{
+		return id < key_list.size();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::id_range_type
+	CsrGraph<KeyType, DataType>::out_ids(id_type id) const
+	{
+		const id_type* base = out_targets.data();
+		return {base + out_offsets[id], base + out_offsets[id+1]};
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::id_range_type
+	CsrGraph<KeyType, DataType>::in_ids(id_type id) const
+	{
+		if(undirected) return out_ids(id);
+		const id_type* base = in_targets.data();
+		return {base + in_offsets[id], base + in_offsets[id+1]};
+	}
+
+	template <typename KeyType, typename DataType>
+	bool CsrGraph<KeyType, DataType>::adjacent_ids(id_type id_a, id_type id_b) const
+	{
+		auto nbrs = out_ids(id_a);
+		return std::binary_search(nbrs.begin(), nbrs.end(), id_b);
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_type
+	CsrGraph<KeyType, DataType>::out_neighbors(const Node<KeyType, DataType>& node) const
+	{
+		return out_neighbors(node.getKey());
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_type
+	CsrGraph<KeyType, DataType>::in_neighbors(const Node<KeyType, DataType>& node) const
+	{
+		return in_neighbors(node.getKey());
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_type
+	CsrGraph<KeyType, DataType>::out_neighbors(KeyType key) const
+	{
+		auto nbrs = out_ids(node_id(key));
+		return {nbrs.begin(), nbrs.end(), nbrs.size(), key_list.data()};
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_type
+	CsrGraph<KeyType, DataType>::in_neighbors(KeyType key) const
+	{
+		auto nbrs = in_ids(node_id(key));
+		return {nbrs.begin(), nbrs.end(), nbrs.size(), key_list.data()};
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_nbr_iterator
+	CsrGraph<KeyType, DataType>::out_neighbors_begin(KeyType key) const
+	{
+		return out_neighbors(key).begin();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_nbr_iterator
+	CsrGraph<KeyType, DataType>::out_neighbors_end(KeyType key) const
+	{
+		return out_neighbors(key).end();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_nbr_iterator
+	CsrGraph<KeyType, DataType>::in_neighbors_begin(KeyType key) const
+	{
+		return in_neighbors(key).begin();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::node_set_nbr_iterator
+	CsrGraph<KeyType, DataType>::in_neighbors_end(KeyType key) const
+	{
+		return in_neighbors(key).end();
+	}
+
+	template <typename KeyType, typename DataType>
+	bool CsrGraph<KeyType, DataType>::adjacent(const KeyType& key_a, const KeyType& key_b) const
+	{
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+
+		if(id_a == invalid_id || id_b == invalid_id)
+			return false;
+
+		return adjacent_ids(id_a, id_b);
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type CsrGraph<KeyType, DataType>::numNodes() const
+	{
+		return node_list.size();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type CsrGraph<KeyType, DataType>::numEdges() const
+	{
+		return num_edges;
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type
+	CsrGraph<KeyType, DataType>::in_degree(const Node<KeyType, DataType>& node) const
+	{
+		return in_ids(node_id(node.getKey())).size();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type
+	CsrGraph<KeyType, DataType>::out_degree(const Node<KeyType, DataType>& node) const
+	{
+		return out_ids(node_id(node.getKey())).size();
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type
+	CsrGraph<KeyType, DataType>::degree(const Node<KeyType, DataType>& node) const
+	{
+		return id_degree(node_id(node.getKey()));
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::offset_type CsrGraph<KeyType, DataType>::id_degree(id_type id) const
+	{
+		//degrees are just differences of neighboring offsets
+		offset_type d = out_offsets[id+1] - out_offsets[id];
+		if(!undirected) d += in_offsets[id+1] - in_offsets[id];
+		return d;
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type CsrGraph<KeyType, DataType>::min_degree() const
+	{
+		if(node_list.empty()) return 0;
+
+		offset_type smallest = id_degree(0);
+		for(id_type i = 1; i < id_bound(); i++)
+		{
+			smallest = std::min(smallest, id_degree(i));
+		}
+		return smallest;
+	}
+
+	template <typename KeyType, typename DataType>
+	typename CsrGraph<KeyType, DataType>::counting_type CsrGraph<KeyType, DataType>::max_degree() const
+	{
+		if(node_list.empty()) return 0;
+
+		offset_type largest = 0;
+		for(id_type i = 0; i < id_bound(); i++)
+		{
+			largest = std::max(largest, id_degree(i));
+		}
+		return largest;
+	}
+
+	template <typename KeyType, typename DataType>
+	double CsrGraph<KeyType, DataType>::avg_degree() const
+	{
+		if(node_list.empty()) return 0;
+
+		return static_cast<double>(out_targets.size() + in_targets.size()) / numNodes();
+	}
+
+	template <typename KeyType, typename DataType>
+	bool CsrGraph<KeyType, DataType>::isDirected() const
+	{
+		return !undirected;
+	}
+
+	template <typename KeyType, typename DataType>
+	bool CsrGraph<KeyType, DataType>::isUndirected() const
+	{
+		return undirected;
+	}
+
+	template <typename KeyType, typename DataType>
+	std::ostream& operator<<(std::ostream& os, CsrGraph<KeyType, DataType>& graph)
+	{
+		os << "Current CSR Graph Info: {\n"
+			 << "\tUndirected: " << graph.isUndirected() << "\n"
+			 << "\t# of Nodes: " << graph.numNodes() << "\n"
+			 << "\t# of Edges: " << graph.numEdges() << "\n"
+			 << "\tMin Degree: " << graph.min_degree() << "\n"
+			 << "\tMax Degree: " << graph.max_degree() << "\n"
+			 << "\tAvg Degree: " << graph.avg_degree() << "\n"
+			 << "}\n";
+		return os;
+	}
+
+} // end namespace YAGL
+
+#endif
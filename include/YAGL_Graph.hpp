@@ -7,21 +7,46 @@
 #include <unordered_map> 
 #include <unordered_set>
 #include <utility> // for pair 
+#include <tuple> // for get on edge ranges
+#include <iterator> // for distance
 #include <algorithm> // for the min_element
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <cmath> // for ceil
+#include <type_traits> // for conditional
 
 #include "YAGL_Node.hpp"
 #include "YAGL_Edge.hpp"
+#include "YAGL_Key_Range.hpp"
+#include "YAGL_Graph_Traits.hpp"
+#include "YAGL_Csr_Graph.hpp"
+#include "YAGL_Journal.hpp"
+#include "YAGL_Thread_Pool.hpp"
 
 namespace YAGL 
 {
 
-	template <typename KeyType, typename DataType>
+	template <typename KeyType, typename DataType, typename Traits = DefaultGraphTraits>
 	class Graph;
 
+	// Motivation: a step of a simulation adds and removes thousands of
+	// 						 independent nodes and edges, see Graph::apply. Edge
+	// 						 removals are applied first, then node removals, node
+	// 						 additions and edge additions, each list in any order
 	template <typename KeyType, typename DataType>
-	std::ostream& operator<<(std::ostream& os, Graph<KeyType, DataType> &graph);
+	struct MutationBatch
+	{
+		std::vector<Node<KeyType, DataType>> add_nodes;
+		std::vector<KeyType> remove_nodes;
+		std::vector<std::pair<KeyType, KeyType>> add_edges;
+		std::vector<std::pair<KeyType, KeyType>> remove_edges;
+	};
 
-	template <typename KeyType, typename DataType>
+	template <typename KeyType, typename DataType, typename Traits>
+	std::ostream& operator<<(std::ostream& os, Graph<KeyType, DataType, Traits> &graph);
+
+	template <typename KeyType, typename DataType, typename Traits>
 	class Graph
 	{
 		// define types and iterators publicly
@@ -31,28 +56,97 @@ namespace YAGL
 			using node_type = Node<key_type, data_type>;
 			using edge_type = Edge<key_type, data_type>;
 			
-			// Motivation: unordered_set allows for amortized time
-			// 						 constant lookup, and ensures keys are unique
+			// Motivation: every node gets a small dense integer id when it is
+			// 						 added, the adjacency is stored in terms of those ids so the
+			// 						 neighbor sets hold 4 byte ints instead of full keys and
+			// 						 algorithms can index flat arrays instead of hashing
+			//
+			// NOTE: 			 ids of removed nodes are recycled by later additions
+			using id_type = std::uint32_t;
+			static constexpr id_type invalid_id = std::numeric_limits<id_type>::max();
+			
+			// Motivation: the neighbor container comes from the traits, the
+			// 						 default unordered_set allows for amortized time
+			// 						 constant lookup, and ensures ids are unique
+			using traits_type = Traits;
+			using id_set_type = typename Traits::template neighbor_set_type<id_type>;
+			
+			// Motivation: the public neighbor view translates ids back into keys
 			//
 			// NOTE: 			 key_types should be hashable and comparable
 			// 						 and provide this if not available by default
-			using node_set_type = std::unordered_set<key_type>;
+			using node_set_type = KeyRange<typename id_set_type::const_iterator, key_type>;
 			using edge_set_type = std::unordered_set<key_type>;
 			
-			// Motivation: easy way to find what goes in and what comes out 
-			using in_out_nbr_type = std::pair<node_set_type, node_set_type>;
+			// Motivation: easy way to find what goes in and what comes out,
+			// 						 undirected graphs share one set between the two
+			static constexpr bool is_directed = Traits::directed;
+			using in_out_nbr_type = NeighborSets<id_set_type, is_directed>;
 			
-			// Motivation: simliar to the node and edge_set types
-			using adjacency_list_type = std::unordered_map<key_type, in_out_nbr_type>;
-			using node_list_type = std::unordered_map<key_type, node_type>;
-			using edge_list_type = std::unordered_multimap<key_type, edge_type>;
+			// Motivation: the adjacency is indexed directly by id, the node and
+			// 						 id lists are the only places that hash keys and their map
+			// 						 type comes from the traits
+			//
+			// NOTE: 			 node iterator stability follows the map policy, see the
+			// 						 traits for what each one guarantees
+			using adjacency_list_type = typename Traits::template vector_type<in_out_nbr_type>;
+			using node_list_type = typename Traits::template map_type<key_type, node_type>;
+			using edge_list_type = typename Traits::template multimap_type<key_type, edge_type>;
+			using id_list_type = typename Traits::template map_type<key_type, id_type>;
+			using key_list_type = typename Traits::template vector_type<key_type>;
+			using free_list_type = typename Traits::template vector_type<id_type>;
+			
+			// Motivation: labels can be kept as a column by id, see the traits
+			using label_traits = NodeLabel<data_type>;
+			using label_type = typename label_traits::type;
+			using label_list_type = typename Traits::template vector_type<label_type>;
+			static constexpr bool has_label_column = Traits::label_column && label_traits::enabled;
+			static constexpr bool has_label_index = has_label_column && Traits::label_index;
+			
+			// the ids of each label live together in one bucket
+			using label_bucket_type = typename Traits::template vector_type<id_type>;
+			using label_index_type = std::conditional_t<has_label_index, 
+				  typename Traits::template map_type<label_type, label_bucket_type>, NoLabel>;
+			using label_set_type = KeyRange<const id_type*, key_type>;
+			
+			// Motivation: edge payloads come from the traits, see EdgeDataTraits.
+			// 						 They live in one map keyed by both endpoint ids packed
+			// 						 into a single word, the source id in the high half, or
+			// 						 the smaller one when undirected
+			using edge_data_type = typename Traits::edge_data_type;
+			using edge_label_traits = EdgeLabel<edge_data_type>;
+			using edge_id_type = std::uint64_t;
+			static constexpr bool has_edge_data = !std::is_same_v<edge_data_type, NoEdgeData>;
+			static constexpr bool has_edge_labels = has_edge_data && edge_label_traits::enabled;
+			using edge_data_list_type = std::conditional_t<has_edge_data, 
+				  typename Traits::template map_type<edge_id_type, edge_data_type>, NoEdgeData>;
+
+			// the keys touched since the log was last cleared, see ChangeLogTraits
+			static constexpr bool has_change_log = Traits::change_log;
+
+			// what changed and when, see JournalTraits
+			static constexpr bool has_journal = Traits::journal;
+			using journal_type = std::conditional_t<has_journal,
+				  Journal<key_type, data_type, edge_data_type, is_directed>, NoJournal>;
+			using epoch_type = std::uint64_t;
+
+			// every container allocates from one resource, see PmrGraphTraits
+			static constexpr bool has_memory_resource = Traits::memory_resource;
 
 			// by default count with the containers size_type
 			using counting_type = typename node_list_type::size_type;
+			using degree_list_type = typename Traits::template vector_type<counting_type>;
 
 			//TODO: define any useful iterators
-			using node_iterator = typename node_list_type::iterator;
+			// NOTE: 			 with a label column payloads are only written through
+			// 						 addNode, emplaceNode and setData, which keep the column up
+			// 						 to date, so node iterators, getNodeSetRef and operator[]
+			// 						 hand out const payloads
+			using node_iterator = std::conditional_t<has_label_column, 
+				  typename node_list_type::const_iterator, typename node_list_type::iterator>;
 			using const_node_iterator = typename node_list_type::const_iterator;
+			using node_list_ref_type = std::conditional_t<has_label_column, const node_list_type&, node_list_type&>;
+			using data_ref_type = std::conditional_t<has_label_column, const DataType&, DataType&>;
 
 			using edge_iterator = typename edge_list_type::iterator;
 			using const_edge_iterator = typename edge_list_type::const_iterator;
@@ -68,14 +162,106 @@ namespace YAGL
 			edge_list_type edge_list;
 			adjacency_list_type adjacency_list;	
 			
+			// id bookkeeping, key_list and id_used are indexed by id
+			id_list_type id_list;
+			key_list_type key_list;
+			typename Traits::template vector_type<bool> id_used;
+			free_list_type free_list;
+			
+			// only filled when the traits ask for a label column
+			label_list_type label_list;
+			
+			// and with a label index, label_pos is each id's slot in its bucket
+			label_index_type label_index;
+			free_list_type label_pos;
+			
+			// only filled when the traits give edges a payload
+			edge_data_list_type edge_payloads;
+			
+			// only filled when the traits ask for a change log or a journal
+			key_list_type change_list;
+			journal_type journal_list;
+			
 			bool undirected;
 			counting_type num_edges;
+			
+			// degree_counts[d] is the number of nodes of degree d, kept up to
+			// date by every change so the statistics never scan the graph
+			degree_list_type degree_counts;
+			counting_type degree_nodes;
+			counting_type degree_total;
+			counting_type lowest_degree;
+			counting_type highest_degree;
+			
+			// capacity tuning, applied to every neighbor set handed out. The
+			// edges asked for are kept until there are nodes to spread them over
+			counting_type degree_hint;
+			counting_type edge_hint;
+			float load_factor;
+			
+			id_type acquire_id(const KeyType& key);
+			void release_id(id_type id);
+			void prepare_neighbors(id_type id);
+			void spread_edge_hint();
+			
+			// a container on the given resource, or a default one when the
+			// container takes no resource
+			template <typename Container>
+			static Container on_resource(std::pmr::memory_resource* resource);
+			void store_label(id_type id, const DataType& data);
+			void index_label(id_type id);
+			void unindex_label(id_type id);
+			void touch(id_type id);
+			void count_degree(counting_type d);
+			void uncount_degree(counting_type d);
+			void drop_degree(counting_type d);
+			void settle_degree_bounds();
+			void move_degree(id_type id, counting_type old_degree);
+			void recount_degrees();
+			void journal_node(ChangeKind kind, id_type id, const DataType* data = nullptr);
+			void journal_edge(ChangeKind kind, id_type id_a, id_type id_b, const edge_data_type* data = nullptr);
+
+			void link(id_type id_a, id_type id_b);
+			void unlink(id_type id_a, id_type id_b);
+
+			node_set_type make_range(const id_set_type& ids) const;
+			
+			// one end of an edge as seen from its owner, out says which set of
+			// a directed owner it lives in
+			struct HalfEdge
+			{
+				id_type owner;
+				id_type nbr;
+				bool out;
+
+				bool operator<(const HalfEdge& b) const { return std::tie(owner, nbr, out) < std::tie(b.owner, b.nbr, b.out); }
+				bool operator==(const HalfEdge& b) const { return owner == b.owner && nbr == b.nbr && out == b.out; }
+			};
+			
+			void push_half_edges(std::vector<HalfEdge>& half_edges, id_type id_a, id_type id_b) const;
+			
+			template <typename EdgeRange>
+			std::vector<HalfEdge> make_half_edges(const EdgeRange& edges, ThreadPool* pool) const;
+			
+			void apply_half_edges(std::vector<HalfEdge>& half_edges, bool insert, ThreadPool* pool);
+			void apply_batch(const MutationBatch<KeyType, DataType>& batch, ThreadPool* pool);
+			
+			// runs fn(worker, begin, end) over [0, n) on the pool, or all at once
+			template <typename Fn>
+			static void for_chunks(std::size_t n, std::size_t grain, ThreadPool* pool, Fn&& fn);
 
 		public:
 			Graph();
 
 			Graph(const DataType placeholder);
 			
+			// NOTE: 			 only available with a memory resource, every container
+			// 						 of the graph allocates from resource
+			explicit Graph(std::pmr::memory_resource* resource);
+			
+			// the resource the graph allocates from, only with a memory resource
+			std::pmr::memory_resource* memory_resource() const;
+			
 			node_iterator node_list_begin();
 			node_iterator node_list_end();
 
@@ -100,16 +286,62 @@ namespace YAGL
 			node_set_nbr_iterator in_neighbors_end(KeyType key);
 			
 
-			node_set_type& out_neighbors(const Node<KeyType, DataType>& node);
-			node_set_type& in_neighbors(const Node<KeyType, DataType>& node);
+			// NOTE: 			 views over the neighbor ids, not the sets themselves.
+			// 						 Any addNode, removeNode, addEdge or removeEdge may
+			// 						 invalidate them like iterators, copy what has to outlive
+			// 						 a change
+			node_set_type out_neighbors(const Node<KeyType, DataType>& node);
+			node_set_type in_neighbors(const Node<KeyType, DataType>& node);
 
 			//Key accessible versions
-			node_set_type& out_neighbors(KeyType key);
-			node_set_type& in_neighbors(KeyType key);
+			node_set_type out_neighbors(KeyType key);
+			node_set_type in_neighbors(KeyType key);
 			
 			bool adjacent(const KeyType& key_a, const KeyType& key_b);
 			bool adjacent(const Node<KeyType, DataType>& node_a, Node<KeyType, DataType>& node_b);
 
+			//Dense id accessible versions
+			id_type id_bound() const;
+			id_type node_id(const KeyType& key) const;
+			const KeyType& node_key(id_type id) const;
+			bool has_id(id_type id) const;
+
+			const id_set_type& out_ids(id_type id) const;
+			const id_set_type& in_ids(id_type id) const;
+
+			bool adjacent_ids(id_type id_a, id_type id_b) const;
+
+			// the key of the edge from id_a to id_b in the edge payload map
+			static edge_id_type edge_id(id_type id_a, id_type id_b);
+			
+			// NOTE: 			 only available with edge data, nullptr if the ids are not
+			// 						 adjacent or their edge was added without a payload
+			const edge_data_type* edge_data_ids(id_type id_a, id_type id_b) const;
+			
+			// NOTE: 			 only available with a label column, entries of released
+			// 						 ids hold stale labels so check has_id when scanning
+			const label_type& node_label(id_type id) const;
+			const label_list_type& label_column() const;
+			
+			// NOTE: 			 only available with a label index, the returned range is
+			// 						 invalidated by any change to the nodes of the graph
+			label_set_type nodes_with_label(const label_type& label) const;
+			counting_type label_count(const label_type& label) const;
+
+			// NOTE: 			 only available with a change log, the keys of the nodes
+			// 						 added, removed, given new data or edges since the last
+			// 						 clear_changes(), in the order they were touched
+			const key_list_type& changed_nodes() const;
+			void clear_changes();
+
+			// NOTE: 			 only available with a journal, the epoch of the latest
+			// 						 change and the changes after an earlier one. The
+			// 						 journal itself is handed out to truncate or compact it
+			epoch_type epoch() const;
+			auto changes_since(epoch_type e) const;
+			journal_type& journal();
+			const journal_type& journal() const;
+
 			void setEdgeset(/* Needs to take in an edge set*/);
 			
 			void getEdgeset();
@@ -122,6 +354,16 @@ namespace YAGL
 			
 			void addEdge(const KeyType key_a, const KeyType key_b);
 
+			// Motivation: adds the edge if needed and sets its payload, only
+			// 						 available with edge data
+			void addEdge(const KeyType key_a, const KeyType key_b, const edge_data_type& data);
+
+			// replaces the payload of an existing edge, missing edges are ignored
+			void setEdgeData(const KeyType& key_a, const KeyType& key_b, const edge_data_type& data);
+
+			// nullptr if there is no edge or it has no payload
+			const edge_data_type* getEdgeData(const KeyType& key_a, const KeyType& key_b) const;
+
 			void removeEdge(const Node<KeyType, DataType>& node_a, const Node<KeyType, DataType>& node_b);
 			
 			void removeEdge(const KeyType key_a, const KeyType key_b);
@@ -130,12 +372,56 @@ namespace YAGL
 
 			node_list_type getNodeSet();
 			
-			node_list_type& getNodeSetRef();
+			node_list_ref_type getNodeSetRef();
 
 			void addNode(const Node<KeyType, DataType>& node);
 			
+			void addNode(Node<KeyType, DataType>&& node);
+			
+			// Motivation: constructs the payload in place from args, like
+			// 						 try_emplace an existing node is left untouched
+			template <typename ... Args>
+			std::pair<node_iterator, bool> emplaceNode(const KeyType& key, Args&& ... args);
+			
 			void removeNode(const Node<KeyType, DataType>& node);
 			
+			// Motivation: replaces the payload of an existing node and keeps any
+			// 						 label column or index in sync, missing keys are ignored
+			void setData(const KeyType& key, const DataType& data);
+			void setData(const KeyType& key, DataType&& data);
+			
+			// Motivation: loading a large graph one addEdge at a time hashes
+			// 						 both endpoints and touches four sets per edge. The bulk
+			// 						 loader maps every edge to ids once, sorts and dedupes the
+			// 						 half edges and fills each neighborhood in a single sweep
+			//
+			// NOTE: 			 nodes is a range of Nodes and edges a range of key pairs
+			// 						 (anything std::get<0> and std::get<1> work on). Like
+			// 						 addEdge(key, key), edges to unknown keys are skipped
+			template <typename NodeRange, typename EdgeRange>
+			void bulk_load(const NodeRange& nodes, const EdgeRange& edges);
+			
+			// Motivation: builds a graph straight from a list of key pairs, every
+			// 						 key that shows up gets a node holding a copy of data
+			template <typename EdgeRange>
+			static Graph from_edge_list(const EdgeRange& edges, const DataType& data = DataType());
+			
+			// Motivation: applying a batch one call at a time hashes every key
+			// 						 and edits the sets in whatever order the calls come in.
+			// 						 apply maps the keys to ids up front, sorts the ends of
+			// 						 every edge by the node that owns them and edits each
+			// 						 node's sets in one go. Owners are disjoint, so with a
+			// 						 pool they are edited in parallel without locks, and the
+			// 						 edge count, degrees, log and journal are brought up to
+			// 						 date once at the end
+			//
+			// NOTE: 			 see MutationBatch for the order things happen in. Node
+			// 						 additions go through addNode on the calling thread, and
+			// 						 a graph with a memory resource applies everything there
+			// 						 since arenas are rarely safe to share between threads
+			void apply(const MutationBatch<KeyType, DataType>& batch);
+			void apply(const MutationBatch<KeyType, DataType>& batch, ThreadPool& pool);
+			
 			node_iterator findNode(KeyType k);
 
 			counting_type numNodes();
@@ -153,525 +439,1454 @@ namespace YAGL
 			counting_type max_degree();
 
 			double avg_degree();
+			
+			// Motivation: the smallest degree at least a fraction p of the nodes
+			// 						 do not exceed, p = 0.5 is the median. Walks the degree
+			// 						 histogram, so it costs with the degree range and not
+			// 						 with the number of nodes
+			counting_type degree_percentile(double p) const;
+			
+			// the number of nodes of each degree, from zero up to max_degree()
+			const degree_list_type& degree_histogram() const { return degree_counts; }
 
 			bool isDirected();
 
 			bool isUndirected();
 			
 			void clear();
+			
+			// Motivation: growing graphs rehash and reallocate over and over,
+			// 						 callers that know the final size can pay for it once
+			void reserve_nodes(counting_type n);
+			
+			// NOTE: 			 spreads 2m neighbor slots evenly over the reserved nodes,
+			// 						 nodes added afterwards get the same per node capacity.
+			// 						 Called before reserve_nodes on an empty graph the slots
+			// 						 are spread by the next reserve_nodes, nodes added one by
+			// 						 one without it get no neighbor reservation
+			void reserve_edges(counting_type m);
+			
+			// releases spare capacity in every container, ids are not renumbered
+			void shrink_to_fit();
+			
+			// NOTE: 			 applies to the node tables and to hash based neighbor sets
+			void max_load_factor(float ml);
+			float max_load_factor() const;
 
-            DataType& operator[](KeyType k) { return findNode(k)->second.getData(); }
+			// Motivation: read heavy algorithm passes can run on a compact,
+			// 						 cache friendly copy of the current topology
+			CsrGraph<KeyType, DataType> freeze();
 
-			friend std::ostream &operator<<<>(std::ostream& os, Graph<KeyType, DataType>& graph);
+            data_ref_type operator[](KeyType k) { return findNode(k)->second.getData(); }
+
+			friend std::ostream &operator<<<>(std::ostream& os, Graph<KeyType, DataType, Traits>& graph);
 	};
 	
-	template <typename KeyType, typename DataType>
-	Graph<KeyType, DataType>::Graph() : undirected(true), num_edges(0)
+	template <typename KeyType, typename DataType, typename Traits>
+	Graph<KeyType, DataType, Traits>::Graph() 
+	: undirected(!is_directed), num_edges(0), degree_nodes(0), degree_total(0), lowest_degree(0), highest_degree(0), 
+		degree_hint(0), edge_hint(0), load_factor(1.0f)
 	{
 		//std::cout << "Default graph constructor!\n";
 	}
 
-	template <typename KeyType, typename DataType>
-	Graph<KeyType, DataType>::Graph(const DataType placeholder)
+	template <typename KeyType, typename DataType, typename Traits>
+	Graph<KeyType, DataType, Traits>::Graph(const DataType placeholder)
+	: undirected(!is_directed), num_edges(0), degree_nodes(0), degree_total(0), lowest_degree(0), highest_degree(0), 
+		degree_hint(0), edge_hint(0), load_factor(1.0f)
 	{
 		std::cout << "Overloaded graph const!\n";
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_iterator Graph<KeyType, DataType>::node_list_begin()
+	template <typename KeyType, typename DataType, typename Traits>
+	Graph<KeyType, DataType, Traits>::Graph(std::pmr::memory_resource* resource)
+	: node_list(on_resource<node_list_type>(resource)), edge_list(on_resource<edge_list_type>(resource)), 
+		adjacency_list(on_resource<adjacency_list_type>(resource)), id_list(on_resource<id_list_type>(resource)), 
+		key_list(on_resource<key_list_type>(resource)), id_used(on_resource<decltype(id_used)>(resource)), 
+		free_list(on_resource<free_list_type>(resource)), label_list(on_resource<label_list_type>(resource)), 
+		label_index(on_resource<label_index_type>(resource)), label_pos(on_resource<free_list_type>(resource)), 
+		edge_payloads(on_resource<edge_data_list_type>(resource)), change_list(on_resource<key_list_type>(resource)), 
+		undirected(!is_directed), num_edges(0), degree_counts(on_resource<degree_list_type>(resource)), 
+		degree_nodes(0), degree_total(0), lowest_degree(0), highest_degree(0), 
+		degree_hint(0), edge_hint(0), load_factor(1.0f)
+	{
+		static_assert(has_memory_resource, "graphs need PmrGraphTraits to allocate from a memory resource");
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::pmr::memory_resource* Graph<KeyType, DataType, Traits>::memory_resource() const
+	{
+		static_assert(has_memory_resource, "graphs need PmrGraphTraits to allocate from a memory resource");
+		//copies move to the default resource, so ask a container instead of
+		//keeping the pointer around
+		return id_list.get_allocator().resource();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename Container>
+	Container Graph<KeyType, DataType, Traits>::on_resource(std::pmr::memory_resource* resource)
+	{
+		if constexpr(std::is_constructible_v<Container, std::pmr::memory_resource*>)
+		{
+			return Container(resource);
+		}
+		else
+		{
+			return Container();
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::id_type Graph<KeyType, DataType, Traits>::acquire_id(const KeyType& key)
+	{
+		id_type id;
+		//reuse a released id before growing the id space
+		if(!free_list.empty())
+		{
+			id = free_list.back();
+			free_list.pop_back();
+			key_list[id] = key;
+			id_used[id] = true;
+		}
+		else
+		{
+			id = static_cast<id_type>(key_list.size());
+			key_list.push_back(key);
+			id_used.push_back(true);
+			if constexpr(has_memory_resource)
+			{
+				//the sets take the resource along, a plain element would not
+				adjacency_list.emplace_back(memory_resource());
+			}
+			else
+			{
+				adjacency_list.emplace_back();
+			}
+			if constexpr(has_label_column)
+			{
+				label_list.emplace_back();
+			}
+			if constexpr(has_label_index)
+			{
+				label_pos.push_back(invalid_id);
+			}
+		}
+		id_list.emplace(key, id);
+		prepare_neighbors(id);
+		count_degree(0);
+		return id;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::prepare_neighbors(id_type id)
+	{
+		adjacency_list[id].for_each([&](id_set_type& nbrs) {
+			if constexpr(has_load_factor_v<id_set_type>)
+			{
+				nbrs.max_load_factor(load_factor);
+			}
+			if constexpr(has_reserve_v<id_set_type>)
+			{
+				if(degree_hint) nbrs.reserve(degree_hint);
+			}
+		});
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::store_label(id_type id, const DataType& data)
+	{
+		if constexpr(has_label_index)
+		{
+			unindex_label(id);
+			label_list[id] = label_traits::get(data);
+			index_label(id);
+		}
+		else if constexpr(has_label_column)
+		{
+			label_list[id] = label_traits::get(data);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::index_label(id_type id)
+	{
+		auto& bucket = label_index[label_list[id]];
+		label_pos[id] = static_cast<id_type>(bucket.size());
+		bucket.push_back(id);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::unindex_label(id_type id)
+	{
+		auto pos = label_pos[id];
+		if(pos == invalid_id) return;
+
+		//move the last id of the bucket into the hole
+		auto iter = label_index.find(label_list[id]);
+		auto& bucket = iter->second;
+		auto last = bucket.back();
+		bucket[pos] = last;
+		label_pos[last] = pos;
+		bucket.pop_back();
+		label_pos[id] = invalid_id;
+
+		if(bucket.empty())
+		{
+			label_index.erase(label_list[id]);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::touch(id_type id)
+	{
+		if constexpr(has_change_log)
+		{
+			change_list.push_back(key_list[id]);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::count_degree(counting_type d)
+	{
+		if(d >= degree_counts.size()) degree_counts.resize(d + 1, 0);
+		degree_counts[d]++;
+		degree_total += d;
+
+		if(degree_nodes++ == 0)
+		{
+			lowest_degree = highest_degree = d;
+		}
+		else
+		{
+			lowest_degree = std::min(lowest_degree, d);
+			highest_degree = std::max(highest_degree, d);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::uncount_degree(counting_type d)
+	{
+		drop_degree(d);
+		if(degree_counts[d] == 0) settle_degree_bounds();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::drop_degree(counting_type d)
+	{
+		//leaves the bounds where they were, they may point at an empty degree
+		//until settle_degree_bounds
+		degree_counts[d]--;
+		degree_total -= d;
+		degree_nodes--;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::settle_degree_bounds()
+	{
+		if(degree_nodes == 0)
+		{
+			degree_counts.clear();
+			lowest_degree = highest_degree = 0;
+			return;
+		}
+
+		//the bounds walk to the nearest degree still taken, a single edge
+		//moves a node by one degree so the walk is short, batches settle
+		//once after moving all of their nodes
+		while(degree_counts[highest_degree] == 0) highest_degree--;
+		while(degree_counts[lowest_degree] == 0) lowest_degree++;
+		degree_counts.resize(highest_degree + 1);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::move_degree(id_type id, counting_type old_degree)
+	{
+		//counting the new degree first keeps the node in the bounds
+		count_degree(adjacency_list[id].degree());
+		uncount_degree(old_degree);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::recount_degrees()
+	{
+		degree_counts.clear();
+		degree_nodes = degree_total = 0;
+		lowest_degree = highest_degree = 0;
+		for(id_type id = 0; id < id_bound(); id++)
+		{
+			if(id_used[id]) count_degree(adjacency_list[id].degree());
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::journal_node(ChangeKind kind, id_type id, const DataType* data)
+	{
+		if constexpr(has_journal)
+		{
+			journal_list.record(kind, key_list[id], KeyType(), data);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::journal_edge(ChangeKind kind, id_type id_a, id_type id_b, 
+																								const edge_data_type* data)
+	{
+		if constexpr(has_journal)
+		{
+			journal_list.record(kind, key_list[id_a], key_list[id_b], nullptr, data);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::release_id(id_type id)
+	{
+		if constexpr(has_label_index)
+		{
+			unindex_label(id);
+		}
+		id_list.erase(key_list[id]);
+		uncount_degree(adjacency_list[id].degree());
+		adjacency_list[id].for_each([](id_set_type& nbrs) { nbrs.clear(); });
+		id_used[id] = false;
+		free_list.push_back(id);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::link(id_type id_a, id_type id_b)
+	{
+		//we don't do any constraint checks for self-directed edges 
+		//the out set of a decides whether the edge is new, the other set
+		//only mirrors it
+		auto degree_a = adjacency_list[id_a].degree();
+		auto degree_b = adjacency_list[id_b].degree();
+		if(adjacency_list[id_a].out().insert(id_b).second)
+		{
+			adjacency_list[id_b].in().insert(id_a);
+			num_edges++;
+			move_degree(id_a, degree_a);
+			if(id_b != id_a) move_degree(id_b, degree_b);
+			touch(id_a);
+			touch(id_b);
+			journal_edge(ChangeKind::add_edge, id_a, id_b);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::unlink(id_type id_a, id_type id_b)
+	{
+		auto degree_a = adjacency_list[id_a].degree();
+		auto degree_b = adjacency_list[id_b].degree();
+		if(adjacency_list[id_a].out().erase(id_b))
+		{
+			adjacency_list[id_b].in().erase(id_a);
+			num_edges--;
+			move_degree(id_a, degree_a);
+			if(id_b != id_a) move_degree(id_b, degree_b);
+			touch(id_a);
+			touch(id_b);
+			journal_edge(ChangeKind::remove_edge, id_a, id_b);
+			if constexpr(has_edge_data)
+			{
+				edge_payloads.erase(edge_id(id_a, id_b));
+			}
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_type 
+	Graph<KeyType, DataType, Traits>::make_range(const id_set_type& ids) const
+	{
+		return {ids.begin(), ids.end(), ids.size(), key_list.data()};
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_iterator Graph<KeyType, DataType, Traits>::node_list_begin()
 	{
 		return node_list.begin();		
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_iterator Graph<KeyType, DataType>::node_list_end()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_iterator Graph<KeyType, DataType, Traits>::node_list_end()
 	{
 		return node_list.end();	
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::edge_iterator Graph<KeyType, DataType>::edge_list_begin()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::edge_iterator Graph<KeyType, DataType, Traits>::edge_list_begin()
 	{
 		return edge_list.begin();	
 	}
 
-template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::edge_iterator Graph<KeyType, DataType>::edge_list_end()
+template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::edge_iterator Graph<KeyType, DataType, Traits>::edge_list_end()
 	{
 		return edge_list.end();	
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::adjacency_iterator Graph<KeyType, DataType>::adjacency_list_begin()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::adjacency_iterator Graph<KeyType, DataType, Traits>::adjacency_list_begin()
 	{
 		return adjacency_list.begin();	
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::adjacency_iterator Graph<KeyType, DataType>::adjacency_list_end()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::adjacency_iterator Graph<KeyType, DataType, Traits>::adjacency_list_end()
 	{
 		return adjacency_list.end();	
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator 
-	Graph<KeyType, DataType>::out_neighbors_begin(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator 
+	Graph<KeyType, DataType, Traits>::out_neighbors_begin(const Node<KeyType, DataType> &node)
 	{
 		return out_neighbors(node).begin();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator
-	Graph<KeyType, DataType>::out_neighbors_end(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator
+	Graph<KeyType, DataType, Traits>::out_neighbors_end(const Node<KeyType, DataType> &node)
 	{
 		return out_neighbors(node).end();
 	}
 	
-	template <typename KeyType, typename DataType>
-	bool Graph<KeyType, DataType>::adjacent(const KeyType& key_a, const KeyType& key_b)
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::adjacent(const KeyType& key_a, const KeyType& key_b)
 	{
-		auto& node = findNode(key_a)->second;
-		auto& nbrs = out_neighbors(node);
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
 
-		if(nbrs.find(key_b) != nbrs.end())
-			return true;
-		else 
+		if(id_a == invalid_id || id_b == invalid_id)
 			return false;
+
+		return adjacent_ids(id_a, id_b);
 	}
 	
-	template<typename KeyType, typename DataType>
-	bool Graph<KeyType, DataType>::adjacent(const Node<KeyType, DataType>& node_a, Node<KeyType, DataType>& node_b)
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::adjacent(const Node<KeyType, DataType>& node_a, Node<KeyType, DataType>& node_b)
 	{
 		return true;
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator 
-	Graph<KeyType, DataType>::out_neighbors_begin(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator 
+	Graph<KeyType, DataType, Traits>::out_neighbors_begin(KeyType key)
 	{
 		return out_neighbors(key).begin();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator
-	Graph<KeyType, DataType>::out_neighbors_end(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator
+	Graph<KeyType, DataType, Traits>::out_neighbors_end(KeyType key)
 	{
 		return out_neighbors(key).end();
 	}
 
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_type& 
-	Graph<KeyType, DataType>::out_neighbors(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_type 
+	Graph<KeyType, DataType, Traits>::out_neighbors(const Node<KeyType, DataType> &node)
 	{
-		return adjacency_list.find(node.getKey())->second.first; 
+		return make_range(out_ids(node_id(node.getKey()))); 
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_type& 
-	Graph<KeyType, DataType>::out_neighbors(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_type 
+	Graph<KeyType, DataType, Traits>::out_neighbors(KeyType key)
 	{
-		auto node = findNode(key)->second;
-		return adjacency_list.find(node.getKey())->second.first; 
+		return make_range(out_ids(node_id(key))); 
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator 
-	Graph<KeyType, DataType>::in_neighbors_begin(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator 
+	Graph<KeyType, DataType, Traits>::in_neighbors_begin(const Node<KeyType, DataType> &node)
 	{
 		return in_neighbors(node).begin();
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator
-	Graph<KeyType, DataType>::in_neighbors_end(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator
+	Graph<KeyType, DataType, Traits>::in_neighbors_end(const Node<KeyType, DataType> &node)
 	{
 		return in_neighbors(node).end();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator 
-	Graph<KeyType, DataType>::in_neighbors_begin(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator 
+	Graph<KeyType, DataType, Traits>::in_neighbors_begin(KeyType key)
 	{
 		return in_neighbors(key).begin();
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_nbr_iterator
-	Graph<KeyType, DataType>::in_neighbors_end(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_nbr_iterator
+	Graph<KeyType, DataType, Traits>::in_neighbors_end(KeyType key)
 	{
 		return in_neighbors(key).end();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_type&
-	Graph<KeyType, DataType>::in_neighbors(const Node<KeyType, DataType> &node)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_type
+	Graph<KeyType, DataType, Traits>::in_neighbors(const Node<KeyType, DataType> &node)
 	{
-		return adjacency_list.find(node.getKey())->second.second;
+		return make_range(in_ids(node_id(node.getKey())));
 	}	
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_set_type&
-	Graph<KeyType, DataType>::in_neighbors(KeyType key)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_set_type
+	Graph<KeyType, DataType, Traits>::in_neighbors(KeyType key)
 	{
-		auto node = findNode(key)->second;
-		return adjacency_list.find(node.getKey())->second.second;
+		return make_range(in_ids(node_id(key)));
 	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::id_type Graph<KeyType, DataType, Traits>::id_bound() const
+	{
+		return static_cast<id_type>(key_list.size());
+	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::setEdgeset()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::id_type 
+	Graph<KeyType, DataType, Traits>::node_id(const KeyType& key) const
 	{
+		auto iter = id_list.find(key);
+		if(iter == id_list.end()) return invalid_id;
+		return iter->second;
+	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	const KeyType& Graph<KeyType, DataType, Traits>::node_key(id_type id) const
+	{
+		return key_list[id];
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::getEdgeset()
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::has_id(id_type id) const
 	{
+		return id < id_used.size() && id_used[id];
+	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::id_set_type& 
+	Graph<KeyType, DataType, Traits>::out_ids(id_type id) const
+	{
+		return adjacency_list[id].out();
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::getEdge()
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::id_set_type& 
+	Graph<KeyType, DataType, Traits>::in_ids(id_type id) const
 	{
+		return adjacency_list[id].in();
+	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::adjacent_ids(id_type id_a, id_type id_b) const
+	{
+		const auto& nbrs = adjacency_list[id_a].out();
+		return nbrs.find(id_b) != nbrs.end();
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::setEdge()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::edge_id_type 
+	Graph<KeyType, DataType, Traits>::edge_id(id_type id_a, id_type id_b)
 	{
+		//an undirected edge has the same key from either end
+		if constexpr(!is_directed)
+		{
+			if(id_b < id_a) std::swap(id_a, id_b);
+		}
+		return (static_cast<edge_id_type>(id_a) << 32) | id_b;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::edge_data_type* 
+	Graph<KeyType, DataType, Traits>::edge_data_ids(id_type id_a, id_type id_b) const
+	{
+		static_assert(has_edge_data, "edge payloads need EdgeDataTraits");
 
+		auto iter = edge_payloads.find(edge_id(id_a, id_b));
+		return iter == edge_payloads.end() ? nullptr : &iter->second;
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::addEdge(const Node<KeyType, DataType>& node_a,
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::label_type& Graph<KeyType, DataType, Traits>::node_label(id_type id) const
+	{
+		static_assert(has_label_column, "node labels need LabelColumnTraits and a labeled payload");
+		return label_list[id];
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::label_list_type& Graph<KeyType, DataType, Traits>::label_column() const
+	{
+		static_assert(has_label_column, "node labels need LabelColumnTraits and a labeled payload");
+		return label_list;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::label_set_type 
+	Graph<KeyType, DataType, Traits>::nodes_with_label(const label_type& label) const
+	{
+		static_assert(has_label_index, "label lookups need LabelIndexTraits and a labeled payload");
+		auto iter = label_index.find(label);
+		if(iter == label_index.end()) return label_set_type();
+
+		const auto& bucket = iter->second;
+		return label_set_type(bucket.data(), bucket.data() + bucket.size(), bucket.size(), key_list.data());
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::label_count(const label_type& label) const
+	{
+		static_assert(has_label_index, "label lookups need LabelIndexTraits and a labeled payload");
+		auto iter = label_index.find(label);
+		return iter == label_index.end() ? 0 : iter->second.size();
+	}
+
+
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::key_list_type& 
+	Graph<KeyType, DataType, Traits>::changed_nodes() const
+	{
+		static_assert(has_change_log, "changed nodes need ChangeLogTraits");
+		return change_list;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::clear_changes()
+	{
+		change_list.clear();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::epoch_type Graph<KeyType, DataType, Traits>::epoch() const
+	{
+		static_assert(has_journal, "epochs need JournalTraits");
+		return journal_list.epoch();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	auto Graph<KeyType, DataType, Traits>::changes_since(epoch_type e) const
+	{
+		static_assert(has_journal, "changes need JournalTraits");
+		return journal_list.changes_since(e);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::journal_type& Graph<KeyType, DataType, Traits>::journal()
+	{
+		static_assert(has_journal, "the journal needs JournalTraits");
+		return journal_list;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::journal_type& Graph<KeyType, DataType, Traits>::journal() const
+	{
+		static_assert(has_journal, "the journal needs JournalTraits");
+		return journal_list;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setEdgeset()
+	{
+
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::getEdgeset()
+	{
+
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::getEdge()
+	{
+
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setEdge()
+	{
+
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::addEdge(const Node<KeyType, DataType>& node_a,
 																				 const Node<KeyType, DataType>& node_b)
 	{
 		//we don't do any constraint checks for self-directed edges 
-		auto iter_a = findNode(node_a.getKey());
-		if(iter_a == node_list_end())
+		auto id_a = node_id(node_a.getKey());
+		if(id_a == invalid_id)
 		{
 			addNode(node_a);
+			id_a = node_id(node_a.getKey());
 		}
 
-		auto iter_b = findNode(node_b.getKey());
-		if(iter_b == node_list_end())
+		auto id_b = node_id(node_b.getKey());
+		if(id_b == invalid_id)
 		{
 			addNode(node_b);
+			id_b = node_id(node_b.getKey());
 		}
 		
-		auto old_size_a = out_neighbors(node_a).size();
-		auto old_size_b = out_neighbors(node_b).size();
-
-		out_neighbors(node_a).insert(node_b.getKey());
-		in_neighbors(node_a).insert(node_b.getKey());
-
-		out_neighbors(node_b).insert(node_a.getKey());
-		in_neighbors(node_b).insert(node_a.getKey());
-
-		auto new_size_a = out_neighbors(node_a).size();
-		auto new_size_b = out_neighbors(node_b).size();
-		
-		if(new_size_a > old_size_a && new_size_b > old_size_b) 
-		{
-			num_edges++;
-		}
-
+		link(id_a, id_b);
 	}
 	
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::addEdge(const KeyType key_a,
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::addEdge(const KeyType key_a,
 																				 const KeyType key_b)
 	{
 		//we don't do any constraint checks for self-directed edges 
-		auto iter_a = findNode(key_a);
-		if(iter_a == node_list_end())
+		auto id_a = node_id(key_a);
+		if(id_a == invalid_id)
 		{
 			return; // don't add anything	
 		}
 
-		auto iter_b = findNode(key_b);
-		if(iter_b == node_list_end())
+		auto id_b = node_id(key_b);
+		if(id_b == invalid_id)
 		{
 			return; // don't add anything	
 		}
 		
-		auto node_a = iter_a->second;
-		auto node_b = iter_b->second;
-
-		auto old_size_a = out_neighbors(node_a).size();
-		auto old_size_b = out_neighbors(node_b).size();
-
-		out_neighbors(node_a).insert(node_b.getKey());
-		in_neighbors(node_a).insert(node_b.getKey());
+		link(id_a, id_b);
+	}
 
-		out_neighbors(node_b).insert(node_a.getKey());
-		in_neighbors(node_b).insert(node_a.getKey());
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::addEdge(const KeyType key_a, const KeyType key_b, 
+																				 const edge_data_type& data)
+	{
+		static_assert(has_edge_data, "edge payloads need EdgeDataTraits");
+		
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		if(id_a == invalid_id || id_b == invalid_id)
+		{
+			return; // don't add anything	
+		}
+		
+		link(id_a, id_b);
+		edge_payloads.insert_or_assign(edge_id(id_a, id_b), data);
+		touch(id_a);
+		touch(id_b);
+		journal_edge(ChangeKind::set_edge_data, id_a, id_b, &data);
+	}
 
-		auto new_size_a = out_neighbors(node_a).size();
-		auto new_size_b = out_neighbors(node_b).size();
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setEdgeData(const KeyType& key_a, const KeyType& key_b, 
+																						 const edge_data_type& data)
+	{
+		static_assert(has_edge_data, "edge payloads need EdgeDataTraits");
 		
-		if(new_size_a > old_size_a && new_size_b > old_size_b) 
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		if(id_a == invalid_id || id_b == invalid_id || !adjacent_ids(id_a, id_b))
 		{
-			num_edges++;
+			return;
 		}
+		edge_payloads.insert_or_assign(edge_id(id_a, id_b), data);
+		touch(id_a);
+		touch(id_b);
+		journal_edge(ChangeKind::set_edge_data, id_a, id_b, &data);
+	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	const typename Graph<KeyType, DataType, Traits>::edge_data_type* 
+	Graph<KeyType, DataType, Traits>::getEdgeData(const KeyType& key_a, const KeyType& key_b) const
+	{
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		if(id_a == invalid_id || id_b == invalid_id)
+		{
+			return nullptr;
+		}
+		return edge_data_ids(id_a, id_b);
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::removeEdge(const Node<KeyType, DataType>& node_a,
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::removeEdge(const Node<KeyType, DataType>& node_a,
 																						const Node<KeyType, DataType>& node_b)
+	{
+		removeEdge(node_a.getKey(), node_b.getKey());
+	}
+	
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::removeEdge(const KeyType key_a,
+																						const KeyType key_b)
 	{
 		//we don't do any constraint checks for self-directed edges 
-		auto iter_a = findNode(node_a.getKey());
-		if(iter_a == node_list_end())
+		auto id_a = node_id(key_a);
+		if(id_a == invalid_id)
 		{
 			return; //cannot remove what does not exist
 		}
 
-		auto iter_b = findNode(node_b.getKey());
-		if(iter_b == node_list_end())
+		auto id_b = node_id(key_b);
+		if(id_b == invalid_id)
 		{
 			return; //cannot remove what does not exist
 		}
 		
-		auto old_size_a = out_neighbors(node_a).size();
-		auto old_size_b = out_neighbors(node_b).size();
+		unlink(id_a, id_b);
+	}
+
 
-		out_neighbors(node_a).erase(node_b.getKey());
-		in_neighbors(node_a).erase(node_b.getKey());
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setNodeSet()
+	{
 
-		out_neighbors(node_b).erase(node_a.getKey());
-		in_neighbors(node_b).erase(node_a.getKey());
+	}
 
-		auto new_size_a = out_neighbors(node_a).size();
-		auto new_size_b = out_neighbors(node_b).size();
-		
-		if(new_size_a < old_size_a && new_size_b < old_size_b) 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_list_type Graph<KeyType, DataType, Traits>::getNodeSet()
+	{
+		return node_list;
+	}
+	
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_list_ref_type Graph<KeyType, DataType, Traits>::getNodeSetRef()
+	{
+		return node_list;
+	}
+
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::addNode(const Node<KeyType, DataType>& node)
+	{
+		//node_list.insert({node.getKey(), node});
+		auto [iter, inserted] = node_list.insert_or_assign(node.getKey(), node);
+		//an existing node only has its data replaced and keeps its id
+		if(inserted)
 		{
-			num_edges--;
+			store_label(acquire_id(node.getKey()), node.getData());
 		}
+		else if constexpr(has_label_column)
+		{
+			store_label(node_id(node.getKey()), node.getData());
+		}
+		touch(node_id(node.getKey()));
+		journal_node(inserted ? ChangeKind::add_node : ChangeKind::set_data, node_id(node.getKey()), &node.getData());
 	}
-	
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::removeEdge(const KeyType key_a,
-																						const KeyType key_b)
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::addNode(Node<KeyType, DataType>&& node)
 	{
-		//we don't do any constraint checks for self-directed edges 
-		auto iter_a = findNode(key_a);
-		if(iter_a == node_list_end())
+		//the key is copied out first since the node is moved from
+		KeyType key = node.getKey();
+		auto [iter, inserted] = node_list.insert_or_assign(key, std::move(node));
+		if(inserted)
 		{
-			return; //cannot remove what does not exist
+			store_label(acquire_id(key), iter->second.getData());
 		}
+		else if constexpr(has_label_column)
+		{
+			store_label(node_id(key), iter->second.getData());
+		}
+		touch(node_id(key));
+		journal_node(inserted ? ChangeKind::add_node : ChangeKind::set_data, node_id(key), &iter->second.getData());
+	}
 
-		auto iter_b = findNode(key_b);
-		if(iter_b == node_list_end())
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename ... Args>
+	std::pair<typename Graph<KeyType, DataType, Traits>::node_iterator, bool> 
+	Graph<KeyType, DataType, Traits>::emplaceNode(const KeyType& key, Args&& ... args)
+	{
+		auto result = node_list.try_emplace(key, key, std::in_place, std::forward<Args>(args)...);
+		if(result.second)
 		{
-			return; //cannot remove what does not exist
+			store_label(acquire_id(key), result.first->second.getData());
+			touch(node_id(key));
+			journal_node(ChangeKind::add_node, node_id(key), &result.first->second.getData());
+		}
+		return result;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename NodeRange, typename EdgeRange>
+	void Graph<KeyType, DataType, Traits>::bulk_load(const NodeRange& nodes, const EdgeRange& edges)
+	{
+		//size the node containers once for everything that is coming
+		reserve_nodes(node_list.size() + static_cast<std::size_t>(std::distance(std::begin(nodes), std::end(nodes))));
+
+		for(const auto& node : nodes)
+		{
+			addNode(node);
+		}
+
+		//every edge becomes a half edge (owner, neighbor) keyed by id, two
+		//when undirected so each end owns one
+		typename Traits::template vector_type<std::pair<id_type, id_type>> half_edges(free_list.get_allocator());
+		half_edges.reserve(2 * static_cast<std::size_t>(std::distance(std::begin(edges), std::end(edges))));
+		for(const auto& edge : edges)
+		{
+			auto id_a = node_id(std::get<0>(edge));
+			auto id_b = node_id(std::get<1>(edge));
+			if(id_a == invalid_id || id_b == invalid_id)
+			{
+				continue; // don't add anything
+			}
+			half_edges.emplace_back(id_a, id_b);
+			if constexpr(!is_directed)
+			{
+				half_edges.emplace_back(id_b, id_a);
+			}
 		}
 		
-		auto node_a = iter_a->second;
-		auto node_b = iter_b->second;
+		//sorting groups each owner's neighbors together and makes duplicates adjacent
+		std::sort(half_edges.begin(), half_edges.end());
+		half_edges.erase(std::unique(half_edges.begin(), half_edges.end()), half_edges.end());
 
-		auto old_size_a = out_neighbors(node_a).size();
-		auto old_size_b = out_neighbors(node_b).size();
+		counting_type added = 0;
+		for(std::size_t first = 0; first < half_edges.size(); )
+		{
+			auto owner = half_edges[first].first;
+			auto last = first;
+			while(last < half_edges.size() && half_edges[last].first == owner) last++;
 
-		out_neighbors(node_a).erase(node_b.getKey());
-		in_neighbors(node_a).erase(node_b.getKey());
+			auto& nbrs = adjacency_list[owner].out();
+			if constexpr(has_reserve_v<id_set_type>)
+			{
+				nbrs.reserve(nbrs.size() + (last - first));
+			}
+			
+			for(auto i = first; i < last; i++)
+			{
+				auto nbr = half_edges[i].second;
+				if(!nbrs.insert(nbr).second) continue;
+				touch(owner);
+				touch(nbr);
+
+				//an undirected edge is counted once, from its smaller endpoint
+				if constexpr(is_directed)
+				{
+					adjacency_list[nbr].in().insert(owner);
+					added++;
+					journal_edge(ChangeKind::add_edge, owner, nbr);
+				}
+				else if(owner <= nbr)
+				{
+					added++;
+					journal_edge(ChangeKind::add_edge, owner, nbr);
+				}
+			}
+			first = last;
+		}
+		num_edges += added;
 
-		out_neighbors(node_b).erase(node_a.getKey());
-		in_neighbors(node_b).erase(node_a.getKey());
+		//cheaper to count the degrees again than to follow every edge
+		recount_degrees();
+	}
 
-		auto new_size_a = out_neighbors(node_a).size();
-		auto new_size_b = out_neighbors(node_b).size();
-		
-		if(new_size_a < old_size_a && new_size_b < old_size_b) 
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename Fn>
+	void Graph<KeyType, DataType, Traits>::for_chunks(std::size_t n, std::size_t grain, ThreadPool* pool, Fn&& fn)
+	{
+		if(pool && !has_memory_resource)
 		{
-			num_edges--;
+			pool->parallel_for(n, grain, fn);
+		}
+		else if(n)
+		{
+			fn(0, 0, n);
 		}
 	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::push_half_edges(std::vector<HalfEdge>& half_edges, id_type id_a, id_type id_b) const
+	{
+		//undirected ends both live in the one set of their owner
+		half_edges.push_back({id_a, id_b, true});
+		half_edges.push_back({id_b, id_a, !is_directed});
+	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::setNodeSet()
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename EdgeRange>
+	std::vector<typename Graph<KeyType, DataType, Traits>::HalfEdge> 
+	Graph<KeyType, DataType, Traits>::make_half_edges(const EdgeRange& edges, ThreadPool* pool) const
 	{
+		//the lookups only read the id map, so they can be split up
+		std::vector<HalfEdge> half_edges(2 * edges.size());
+		for_chunks(edges.size(), 4096, pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+			for(auto i = begin; i < end; i++)
+			{
+				auto id_a = node_id(std::get<0>(edges[i]));
+				auto id_b = node_id(std::get<1>(edges[i]));
+				if(id_a == invalid_id || id_b == invalid_id) id_a = id_b = invalid_id;
+				half_edges[2 * i] = {id_a, id_b, true};
+				half_edges[2 * i + 1] = {id_b, id_a, !is_directed};
+			}
+		});
 
+		//edges to unknown keys are skipped like in addEdge
+		half_edges.erase(std::remove_if(half_edges.begin(), half_edges.end(),
+					[](const HalfEdge& h) { return h.owner == invalid_id; }), half_edges.end());
+		return half_edges;
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_list_type Graph<KeyType, DataType>::getNodeSet()
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::apply_half_edges(std::vector<HalfEdge>& half_edges, bool insert, ThreadPool* pool)
 	{
-		return node_list;
+		//sorting groups each owner's ends together and makes duplicates adjacent
+		std::sort(half_edges.begin(), half_edges.end());
+		half_edges.erase(std::unique(half_edges.begin(), half_edges.end()), half_edges.end());
+
+		std::vector<std::size_t> groups;
+		for(std::size_t i = 0; i < half_edges.size(); i++)
+		{
+			if(i == 0 || half_edges[i].owner != half_edges[i - 1].owner) groups.push_back(i);
+		}
+		groups.push_back(half_edges.size());
+		auto num_groups = groups.size() - 1;
+
+		std::vector<counting_type> old_degree(num_groups);
+		std::vector<char> changed(half_edges.size(), 0);
+		std::vector<counting_type> counted(pool ? pool->size() : 1, 0);
+
+		//each group only touches the sets of its owner
+		for_chunks(num_groups, 256, pool, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+			for(auto g = begin; g < end; g++)
+			{
+				auto owner = half_edges[groups[g]].owner;
+				auto& nbrs = adjacency_list[owner];
+				old_degree[g] = nbrs.degree();
+
+				if constexpr(has_reserve_v<id_set_type>)
+				{
+					if(insert)
+					{
+						counting_type outs = 0;
+						for(auto i = groups[g]; i < groups[g + 1]; i++) outs += half_edges[i].out;
+						nbrs.out().reserve(nbrs.out().size() + outs);
+						if constexpr(is_directed)
+						{
+							nbrs.in().reserve(nbrs.in().size() + (groups[g + 1] - groups[g] - outs));
+						}
+					}
+				}
+
+				for(auto i = groups[g]; i < groups[g + 1]; i++)
+				{
+					const auto& h = half_edges[i];
+					auto& set = h.out ? nbrs.out() : nbrs.in();
+					changed[i] = insert ? set.insert(h.nbr).second : set.erase(h.nbr) != 0;
+
+					//an undirected edge is counted once, from its smaller end
+					if(changed[i] && h.out && (is_directed || h.owner <= h.nbr)) counted[worker]++;
+				}
+			}
+		});
+
+		counting_type total = 0;
+		for(auto c : counted) total += c;
+		num_edges = insert ? num_edges + total : num_edges - total;
+
+		//a group can move its owner by many degrees, walking the bounds for
+		//each would cost up to the largest degree per node
+		for(std::size_t g = 0; g < num_groups; g++)
+		{
+			auto owner = half_edges[groups[g]].owner;
+			auto degree = adjacency_list[owner].degree();
+			if(degree == old_degree[g]) continue;
+			count_degree(degree);
+			drop_degree(old_degree[g]);
+		}
+		settle_degree_bounds();
+
+		if constexpr(has_change_log || has_journal || has_edge_data)
+		{
+			for(std::size_t i = 0; i < half_edges.size(); i++)
+			{
+				const auto& h = half_edges[i];
+				if(!changed[i] || !h.out || (!is_directed && h.nbr < h.owner)) continue;
+
+				touch(h.owner);
+				touch(h.nbr);
+				journal_edge(insert ? ChangeKind::add_edge : ChangeKind::remove_edge, h.owner, h.nbr);
+				if constexpr(has_edge_data)
+				{
+					if(!insert) edge_payloads.erase(edge_id(h.owner, h.nbr));
+				}
+			}
+		}
 	}
-	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_list_type& Graph<KeyType, DataType>::getNodeSetRef()
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::apply_batch(const MutationBatch<KeyType, DataType>& batch, ThreadPool* pool)
 	{
-		return node_list;
+		std::vector<id_type> removed;
+		for(const auto& key : batch.remove_nodes)
+		{
+			auto id = node_id(key);
+			if(id != invalid_id) removed.push_back(id);
+		}
+		std::sort(removed.begin(), removed.end());
+		removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+		//removed nodes take their edges along with the ones asked for
+		auto half_edges = make_half_edges(batch.remove_edges, pool);
+		for(auto id : removed)
+		{
+			for(auto u : out_ids(id)) push_half_edges(half_edges, id, u);
+			if constexpr(is_directed)
+			{
+				for(auto u : in_ids(id)) push_half_edges(half_edges, u, id);
+			}
+		}
+		apply_half_edges(half_edges, false, pool);
+
+		for(auto id : removed)
+		{
+			KeyType key = key_list[id];
+			touch(id);
+			journal_node(ChangeKind::remove_node, id);
+			release_id(id);
+			node_list.erase(key);
+		}
+
+		for(const auto& node : batch.add_nodes)
+		{
+			addNode(node);
+		}
+
+		half_edges = make_half_edges(batch.add_edges, pool);
+		apply_half_edges(half_edges, true, pool);
 	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::apply(const MutationBatch<KeyType, DataType>& batch)
+	{
+		apply_batch(batch, nullptr);
+	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::addNode(const Node<KeyType, DataType>& node)
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::apply(const MutationBatch<KeyType, DataType>& batch, ThreadPool& pool)
 	{
-		//node_list.insert({node.getKey(), node});
-		node_list.insert_or_assign(node.getKey(), node);
-		adjacency_list[node.getKey()]; //TODO: is there a better way to default initialize
+		apply_batch(batch, &pool);
 	}
 
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::removeNode(const Node<KeyType, DataType>& node)
+	template <typename KeyType, typename DataType, typename Traits>
+	template <typename EdgeRange>
+	Graph<KeyType, DataType, Traits> 
+	Graph<KeyType, DataType, Traits>::from_edge_list(const EdgeRange& edges, const DataType& data)
+	{
+		Graph graph;
+
+		//nodes are added in order of first appearance
+		std::vector<Node<KeyType, DataType>> nodes;
+		std::unordered_set<KeyType> seen;
+		for(const auto& edge : edges)
+		{
+			if(seen.insert(std::get<0>(edge)).second) nodes.emplace_back(std::get<0>(edge), data);
+			if(seen.insert(std::get<1>(edge)).second) nodes.emplace_back(std::get<1>(edge), data);
+		}
+
+		graph.bulk_load(nodes, edges);
+		return graph;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::removeNode(const Node<KeyType, DataType>& node)
 	{
-		auto out_set = out_neighbors(node);
-		auto in_set = in_neighbors(node);
-		for(auto& elem : out_set)
+		auto id = node_id(node.getKey());
+		if(id == invalid_id)
+		{
+			return; //cannot remove what does not exist
+		}
+
+		//copy the neighborhood first since unlinking edits the sets
+		free_list_type nbrs(out_ids(id).begin(), out_ids(id).end(), free_list.get_allocator());
+		for(auto u : nbrs)
 		{
-			auto n =findNode(elem)->second;
-			removeEdge(n, node);
+			unlink(id, u);
 		}
-		for(auto& elem : in_set)
+		if constexpr(is_directed)
 		{
-			//TODO: is this redundant?
-			auto n =findNode(elem)->second;
-			removeEdge(n, node);
+			nbrs.assign(in_ids(id).begin(), in_ids(id).end());
+			for(auto u : nbrs)
+			{
+				unlink(u, id);
+			}
 		}
 
-		//TODO: add removal of edges pointing to it
-		adjacency_list.erase(node.getKey());
+		touch(id);
+		journal_node(ChangeKind::remove_node, id);
+		release_id(id);
 
 		node_list.erase(node.getKey());
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::node_iterator Graph<KeyType, DataType>::findNode(KeyType k)
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setData(const KeyType& key, const DataType& data)
+	{
+		auto iter = node_list.find(key);
+		if(iter == node_list.end()) return;
+
+		iter->second.getData() = data;
+		if constexpr(has_label_column)
+		{
+			store_label(node_id(key), iter->second.getData());
+		}
+		touch(node_id(key));
+		journal_node(ChangeKind::set_data, node_id(key), &iter->second.getData());
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::setData(const KeyType& key, DataType&& data)
+	{
+		auto iter = node_list.find(key);
+		if(iter == node_list.end()) return;
+
+		iter->second.getData() = std::move(data);
+		if constexpr(has_label_column)
+		{
+			store_label(node_id(key), iter->second.getData());
+		}
+		touch(node_id(key));
+		journal_node(ChangeKind::set_data, node_id(key), &iter->second.getData());
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::node_iterator Graph<KeyType, DataType, Traits>::findNode(KeyType k)
 	{
 			return node_list.find(k);
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type Graph<KeyType, DataType>::numNodes()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type Graph<KeyType, DataType, Traits>::numNodes()
 	{
 		return node_list.size(); 
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type Graph<KeyType, DataType>::numEdges()
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type Graph<KeyType, DataType, Traits>::numEdges()
 	{
 		return num_edges;
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type 
-	Graph<KeyType, DataType>::in_degree(const Node<KeyType, DataType> &node) 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::in_degree(const Node<KeyType, DataType> &node) 
 	{
-		return in_neighbors(node).size();
+		return in_ids(node_id(node.getKey())).size();
 	}
 
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type 
-	Graph<KeyType, DataType>::out_degree(const Node<KeyType, DataType> &node) 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::out_degree(const Node<KeyType, DataType> &node) 
 	{
-		return out_neighbors(node).size();
+		return out_ids(node_id(node.getKey())).size();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type 
-	Graph<KeyType, DataType>::degree(const Node<KeyType, DataType> &node) 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::degree(const Node<KeyType, DataType> &node) 
 	{
-		return out_neighbors(node).size();
+		return adjacency_list[node_id(node.getKey())].degree();
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type 
-	Graph<KeyType, DataType>::min_degree() 
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::min_degree() 
 	{
-		//same as std::min_element
-		auto first = adjacency_list_begin();
-		auto last = adjacency_list_end();
-		
-		if(first == last) return 0;
+		return lowest_degree;
+	}
+	
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::max_degree() 
+	{
+		return highest_degree;
+	}
+	
+	template <typename KeyType, typename DataType, typename Traits>
+	double Graph<KeyType, DataType, Traits>::avg_degree() 
+	{
+		if(node_list.empty()) return 0;
 		
-		auto smallest = first;
+		return static_cast<double>(degree_total) / numNodes();
+	}
 
-		for(; first != last; ++first)
+	template <typename KeyType, typename DataType, typename Traits>
+	typename Graph<KeyType, DataType, Traits>::counting_type 
+	Graph<KeyType, DataType, Traits>::degree_percentile(double p) const
+	{
+		if(degree_nodes == 0) return 0;
+
+		//the rank of the node the percentile lands on, at least the first
+		auto rank = static_cast<counting_type>(std::ceil(std::clamp(p, 0.0, 1.0) * degree_nodes));
+		rank = std::max<counting_type>(rank, 1);
+
+		counting_type seen = 0;
+		for(auto d = lowest_degree; d < highest_degree; d++)
 		{
-			if(first->second.first.size() < smallest->second.first.size())
-			{
-				smallest = first;
-			}
+			seen += degree_counts[d];
+			if(seen >= rank) return d;
 		}
-
-		return smallest->second.first.size();
+		return highest_degree;
 	}
 	
-	template <typename KeyType, typename DataType>
-	typename Graph<KeyType, DataType>::counting_type 
-	Graph<KeyType, DataType>::max_degree() 
+
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::isDirected()
 	{
-		//same as std::max_element
-		auto first = adjacency_list_begin();
-		auto last = adjacency_list_end();
-		
-		if(first == last) return 0;
-		
-		auto largest = first;
+		return !undirected;
+	}
 
-		for(; first != last; ++first)
+	template <typename KeyType, typename DataType, typename Traits>
+	bool Graph<KeyType, DataType, Traits>::isUndirected()
+	{
+		return undirected;
+	}
+	
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::clear()
+	{
+		//every node goes away
+		if constexpr(has_change_log)
 		{
-			if(first->second.first.size() > largest->second.first.size())
+			for(id_type id = 0; id < id_bound(); id++)
 			{
-				largest = first;
+				if(id_used[id]) touch(id);
 			}
 		}
+		if constexpr(has_journal)
+		{
+			journal_list.record(ChangeKind::clear, KeyType());
+		}
+		node_list.clear();
+		edge_list.clear();
+		adjacency_list.clear();
+		id_list.clear();
+		key_list.clear();
+		id_used.clear();
+		free_list.clear();
+		label_list.clear();
+		label_pos.clear();
+		if constexpr(has_label_index)
+		{
+			label_index.clear();
+		}
+		if constexpr(has_edge_data)
+		{
+			edge_payloads.clear();
+		}
+		num_edges = 0;
+		recount_degrees();
+	}
 
-		return largest->second.first.size();
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::reserve_nodes(counting_type n)
+	{
+		node_list.reserve(n);
+		id_list.reserve(n);
+		key_list.reserve(n);
+		id_used.reserve(n);
+		adjacency_list.reserve(n);
+		if constexpr(has_label_column)
+		{
+			label_list.reserve(n);
+		}
+		if constexpr(has_label_index)
+		{
+			label_pos.reserve(n);
+		}
+		if(edge_hint) spread_edge_hint();
 	}
-	
-	template <typename KeyType, typename DataType>
-	double Graph<KeyType, DataType>::avg_degree() 
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::reserve_edges(counting_type m)
 	{
-		auto first = adjacency_list_begin();
-		auto last = adjacency_list_end();
-		
-		if(first == last) return 0;
+		edge_hint = m;
+		spread_edge_hint();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::spread_edge_hint()
+	{
+		//nothing to spread the edges over until nodes are reserved or added,
+		//reserve_nodes comes back here
+		auto n = adjacency_list.capacity();
+		if(n == 0) return;
 		
-		double sum = 0;
+		//each edge takes a slot in two neighbor sets
+		auto slots = is_directed ? edge_hint : 2*edge_hint;
+		degree_hint = (slots + n - 1) / n;
 
-		for(; first != last; ++first)
+		for(id_type id = 0; id < id_bound(); id++)
 		{
-			sum += first->second.first.size();
+			if(id_used[id]) prepare_neighbors(id);
 		}
-		
-		sum /= numNodes();
-		
-		return sum;
 	}
-	
 
-	template <typename KeyType, typename DataType>
-	bool Graph<KeyType, DataType>::isDirected()
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::shrink_to_fit()
 	{
-		return !undirected;
+		for(auto& sets : adjacency_list)
+		{
+			sets.for_each([](id_set_type& nbrs) {
+				if constexpr(has_load_factor_v<id_set_type>)
+				{
+					nbrs.rehash(0);
+				}
+				else if constexpr(has_shrink_to_fit_v<id_set_type>)
+				{
+					nbrs.shrink_to_fit();
+				}
+			});
+		}
+		//rehash(0) drops to the smallest bucket count the load factor allows
+		node_list.rehash(0);
+		id_list.rehash(0);
+		key_list.shrink_to_fit();
+		id_used.shrink_to_fit();
+		adjacency_list.shrink_to_fit();
+		free_list.shrink_to_fit();
+		label_list.shrink_to_fit();
+		label_pos.shrink_to_fit();
+		if constexpr(has_label_index)
+		{
+			for(auto& [label, bucket] : label_index)
+			{
+				bucket.shrink_to_fit();
+			}
+		}
+		if constexpr(has_edge_data)
+		{
+			edge_payloads.rehash(0);
+		}
+		degree_hint = edge_hint = 0;
 	}
 
-	template <typename KeyType, typename DataType>
-	bool Graph<KeyType, DataType>::isUndirected()
+	template <typename KeyType, typename DataType, typename Traits>
+	void Graph<KeyType, DataType, Traits>::max_load_factor(float ml)
 	{
-		return undirected;
+		load_factor = ml;
+		node_list.max_load_factor(ml);
+		id_list.max_load_factor(ml);
+		if constexpr(has_load_factor_v<id_set_type>)
+		{
+			for(auto& sets : adjacency_list)
+			{
+				sets.for_each([&](id_set_type& nbrs) { nbrs.max_load_factor(ml); });
+			}
+		}
 	}
-	
-	template <typename KeyType, typename DataType>
-	void Graph<KeyType, DataType>::clear()
+
+	template <typename KeyType, typename DataType, typename Traits>
+	float Graph<KeyType, DataType, Traits>::max_load_factor() const
 	{
-		node_list.clear();
-		edge_list.clear();
-		adjacency_list.clear();
-		num_edges = 0;
+		return load_factor;
 	}
 
+	template <typename KeyType, typename DataType, typename Traits>
+	CsrGraph<KeyType, DataType> Graph<KeyType, DataType, Traits>::freeze()
+	{
+		return CsrGraph<KeyType, DataType>(*this);
+	}
 
-	template <typename KeyType, typename DataType>
-	std::ostream& operator<<(std::ostream& os, Graph<KeyType, DataType>& graph)
+
+	template <typename KeyType, typename DataType, typename Traits>
+	std::ostream& operator<<(std::ostream& os, Graph<KeyType, DataType, Traits>& graph)
 	{
 		os << "Current Graph Info: {\n" 
 			 << "\tUndirected: " << graph.isUndirected() << "\n"
@@ -0,0 +1,304 @@
+#ifndef YAGL_GRAPH_TRAITS_HPP
+#define YAGL_GRAPH_TRAITS_HPP
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <memory_resource>
+#include <cstddef>
+#include <type_traits>
+#include <utility> // for declval
+
+#include "YAGL_Small_Sorted_Set.hpp"
+#include "YAGL_Robin_Hood_Map.hpp"
+
+namespace YAGL
+{
+	// Motivation: the storage choices of a Graph are bundled into one traits
+	// 						 type so new policies can be added without growing the
+	// 						 template parameter list. Derive from the defaults and
+	// 						 override only what needs to change.
+
+	// the edge payload of graphs whose edges carry none
+	struct NoEdgeData {};
+
+	// Hash based neighbor sets, constant time lookups at any degree. The key
+	// to node and key to id maps are std::unordered_map, references to nodes
+	// stay valid until that node is removed
+	struct DefaultGraphTraits
+	{
+		template <typename IdType>
+		using neighbor_set_type = std::unordered_set<IdType>;
+
+		template <typename K, typename V>
+		using map_type = std::unordered_map<K, V>;
+
+		template <typename K, typename V>
+		using multimap_type = std::unordered_multimap<K, V>;
+
+		// the id indexed arrays, adjacency, keys and so on
+		template <typename T>
+		using vector_type = std::vector<T>;
+
+		// containers allocate from the global heap
+		static constexpr bool memory_resource = false;
+
+		// node labels are only read from the payloads
+		static constexpr bool label_column = false;
+		static constexpr bool label_index = false;
+
+		// edges are plain adjacency
+		using edge_data_type = NoEdgeData;
+
+		// and go both ways
+		static constexpr bool directed = false;
+
+		// changes are not recorded
+		static constexpr bool change_log = false;
+		static constexpr bool journal = false;
+	};
+
+	// Sorted small buffer neighbor sets, up to N neighbors are stored inline
+	// and larger neighborhoods spill to a single heap array. Best suited to
+	// sparse graphs where most degrees stay below N
+	template <std::size_t N = 4>
+	struct SmallNeighborTraits : DefaultGraphTraits
+	{
+		template <typename IdType>
+		using neighbor_set_type = SmallSortedSet<IdType, N>;
+	};
+
+	// Open addressing key maps, one flat array per map instead of one heap
+	// node per element. Faster to build, look up and copy, but any addNode or
+	// removeNode may move other nodes, so node iterators and references must
+	// not be held across mutations of the graph
+	struct RobinHoodGraphTraits : DefaultGraphTraits
+	{
+		template <typename K, typename V>
+		using map_type = RobinHoodMap<K, V>;
+	};
+
+	// Both flat policies at once, for large sparse graphs that are built once
+	// and then mostly queried
+	template <std::size_t N = 4>
+	struct FlatGraphTraits : SmallNeighborTraits<N>
+	{
+		template <typename K, typename V>
+		using map_type = RobinHoodMap<K, V>;
+	};
+
+	// Motivation: every addNode allocates a map node and an empty neighbor
+	// 						 set and every addEdge a set node at each end, clear hands
+	// 						 them back one at a time. With polymorphic allocators all
+	// 						 of the graph's maps, arrays and neighbor sets allocate from
+	// 						 the memory resource given to the constructor, so short
+	// 						 lived pattern or scratch graphs can live in a monotonic
+	// 						 arena that is released in one go
+	//
+	// NOTE: 			 the resource has to outlive the graph. Copies allocate from
+	// 						 the default resource, like any other pmr container
+	struct PmrGraphTraits : DefaultGraphTraits
+	{
+		template <typename IdType>
+		using neighbor_set_type = std::pmr::unordered_set<IdType>;
+
+		template <typename K, typename V>
+		using map_type = std::pmr::unordered_map<K, V>;
+
+		template <typename K, typename V>
+		using multimap_type = std::pmr::unordered_multimap<K, V>;
+
+		template <typename T>
+		using vector_type = std::pmr::vector<T>;
+
+		static constexpr bool memory_resource = true;
+	};
+
+	// Motivation: label scans in the matchers only need one field of every
+	// 						 payload, but reading it out of the node map drags each
+	// 						 whole node through cache. With a label column the graph
+	// 						 keeps a copy of every label in a flat array indexed by
+	// 						 id, next to the key array, so a scan is a linear pass
+	// 						 over contiguous memory. Add it to any other policy with
+	// 						 LabelColumnTraits<RobinHoodGraphTraits> and so on
+	//
+	// NOTE: 			 the column is refreshed by addNode, emplaceNode and
+	// 						 setData, the only ways to write a payload. operator[],
+	// 						 findNode and the node iterators hand out const payloads
+	// 						 so a label can not go stale behind the column's back
+	template <typename Base = DefaultGraphTraits>
+	struct LabelColumnTraits : Base
+	{
+		static constexpr bool label_column = true;
+	};
+
+	// Motivation: matching a pattern whose labels are rare still scans the
+	// 						 whole label column to find its candidates. The label index
+	// 						 additionally keeps the ids of every label together, so the
+	// 						 candidates for a label are found with one lookup. Adds and
+	// 						 removals are constant time, a node is swapped out of its
+	// 						 bucket instead of shifting the rest
+	//
+	// NOTE: 			 the same caveat as the label column applies, labels change
+	// 						 through addNode, emplaceNode or setData
+	template <typename Base = DefaultGraphTraits>
+	struct LabelIndexTraits : LabelColumnTraits<Base>
+	{
+		static constexpr bool label_index = true;
+	};
+
+	// Motivation: edge types used to be modeled as extra nodes in between,
+	// 						 which triples the size of a host. With edge data every
+	// 						 edge carries a payload of its own, kept in one map keyed by
+	// 						 the packed ids of its endpoints next to the adjacency
+	//
+	// NOTE: 			 payloads are set with addEdge(a, b, data) or setEdgeData,
+	// 						 an edge added without one has no payload at all
+	template <typename EdgeData, typename Base = DefaultGraphTraits>
+	struct EdgeDataTraits : Base
+	{
+		using edge_data_type = EdgeData;
+	};
+
+	// Motivation: consumers that keep results derived from a graph, like
+	// 						 the matches of a pattern, only need to revisit the part
+	// 						 that changed. With a change log the graph records the key
+	// 						 of every node it adds, removes, relabels or links and
+	// 						 hands the list out through changed_nodes()
+	//
+	// NOTE: 			 a key shows up once per change and removed keys stay in
+	// 						 the log, it grows until clear_changes() is called
+	template <typename Base = DefaultGraphTraits>
+	struct ChangeLogTraits : Base
+	{
+		static constexpr bool change_log = true;
+	};
+
+	// Motivation: the change log only says which nodes changed, a journal
+	// 						 records what changed, see YAGL_Journal.hpp. Every node
+	// 						 and edge added or removed and every new payload becomes
+	// 						 an entry with its own epoch
+	template <typename Base = DefaultGraphTraits>
+	struct JournalTraits : Base
+	{
+		static constexpr bool journal = true;
+	};
+
+	// Motivation: a directed graph keeps the out and in neighbors of every
+	// 						 node apart, addEdge(a, b) only touches the out set of a
+	// 						 and the in set of b. Undirected graphs keep one set per
+	// 						 node that serves as both
+	//
+	// NOTE: 			 edge payloads of directed graphs belong to one direction,
+	// 						 getEdgeData(b, a) does not see the payload of a to b
+	template <typename Base = DefaultGraphTraits>
+	struct DirectedTraits : Base
+	{
+		static constexpr bool directed = true;
+	};
+
+	// Motivation: how to read the label out of a payload, by default any
+	// 						 payload with a type member is labeled by it. Specialize
+	// 						 for payloads that keep their label elsewhere
+	struct NoLabel {};
+
+	template <typename DataType, typename = void>
+	struct NodeLabel
+	{
+		static constexpr bool enabled = false;
+		using type = NoLabel;
+	};
+
+	template <typename DataType>
+	struct NodeLabel<DataType, std::void_t<decltype(std::declval<const DataType&>().type)>>
+	{
+		static constexpr bool enabled = true;
+		using type = std::decay_t<decltype(std::declval<const DataType&>().type)>;
+
+		static const type& get(const DataType& data) { return data.type; }
+	};
+
+	// edge payloads are labeled the same way unless specialized on their own
+	template <typename EdgeData, typename = void>
+	struct EdgeLabel : NodeLabel<EdgeData> {};
+
+	// Motivation: not every neighbor container can preallocate, detect the
+	// 						 ones that can so bulk operations may size them up front
+	template <typename SetType, typename = void>
+	struct has_reserve : std::false_type {};
+
+	template <typename SetType>
+	struct has_reserve<SetType, std::void_t<
+		decltype(std::declval<SetType&>().reserve(std::size_t{}))>> : std::true_type {};
+
+	template <typename SetType>
+	inline constexpr bool has_reserve_v = has_reserve<SetType>::value;
+
+	template <typename SetType, typename = void>
+	struct has_shrink_to_fit : std::false_type {};
+
+	template <typename SetType>
+	struct has_shrink_to_fit<SetType, std::void_t<
+		decltype(std::declval<SetType&>().shrink_to_fit())>> : std::true_type {};
+
+	template <typename SetType>
+	inline constexpr bool has_shrink_to_fit_v = has_shrink_to_fit<SetType>::value;
+
+	// hash based containers are shrunk with a rehash and tuned by load factor
+	template <typename SetType, typename = void>
+	struct has_load_factor : std::false_type {};
+
+	template <typename SetType>
+	struct has_load_factor<SetType, std::void_t<
+		decltype(std::declval<SetType&>().max_load_factor(1.0f)),
+		decltype(std::declval<SetType&>().rehash(std::size_t{}))>> : std::true_type {};
+
+	template <typename SetType>
+	inline constexpr bool has_load_factor_v = has_load_factor<SetType>::value;
+
+	// the neighbors of one node, separate out and in sets when directed and
+	// a single set otherwise. for_each visits every distinct set once
+	template <typename SetType, bool Directed>
+	struct NeighborSets
+	{
+		SetType out_set;
+		SetType in_set;
+
+		NeighborSets() = default;
+		explicit NeighborSets(std::pmr::memory_resource* resource) : out_set(resource), in_set(resource) {}
+
+		SetType& out() { return out_set; }
+		SetType& in() { return in_set; }
+		const SetType& out() const { return out_set; }
+		const SetType& in() const { return in_set; }
+
+		std::size_t degree() const { return out_set.size() + in_set.size(); }
+
+		template <typename Fn>
+		void for_each(Fn&& fn) { fn(out_set); fn(in_set); }
+	};
+
+	template <typename SetType>
+	struct NeighborSets<SetType, false>
+	{
+		SetType both;
+
+		NeighborSets() = default;
+		explicit NeighborSets(std::pmr::memory_resource* resource) : both(resource) {}
+
+		SetType& out() { return both; }
+		SetType& in() { return both; }
+		const SetType& out() const { return both; }
+		const SetType& in() const { return both; }
+
+		std::size_t degree() const { return both.size(); }
+
+		template <typename Fn>
+		void for_each(Fn&& fn) { fn(both); }
+	};
+
+} // end namespace YAGL
+
+#endif
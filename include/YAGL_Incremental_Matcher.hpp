@@ -0,0 +1,328 @@
+#ifndef YAGL_INCREMENTAL_MATCHER_HPP
+#define YAGL_INCREMENTAL_MATCHER_HPP
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "YAGL_Algorithms.hpp"
+#include "YAGL_Match.hpp"
+
+namespace YAGL
+{
+	// the matches of one pattern an update brought in and took away, both
+	// with the pattern's columns
+	template <typename KeyType>
+	struct MatchChanges
+	{
+		MatchSet<KeyType> added;
+		MatchSet<KeyType> invalidated;
+	};
+
+	// Motivation: a rewrite step only touches a handful of nodes, but
+	// 						 matching the patterns again afterwards searches the whole
+	// 						 host. A match that uses none of the changed nodes can not
+	// 						 have changed, its nodes, labels and the edges between them
+	// 						 are all the same, so only the matches through a changed
+	// 						 node need another look. The incremental matcher keeps the
+	// 						 matches of its patterns indexed by host key and, given the
+	// 						 changed keys, drops the matches through them and searches
+	// 						 again with every pattern vertex pinned to every changed
+	// 						 node. Those searches stay within the pattern's reach of
+	// 						 the change, so an update costs with the size of the change
+	// 						 and not of the host
+	//
+	// NOTE: 			 patterns are copied when they are added. The changed keys
+	// 						 come from the caller or from the host's change log, see
+	// 						 ChangeLogTraits, and have to cover every node added,
+	// 						 removed, relabeled or given or relieved of an edge since
+	// 						 the last update. Matches are stored with their columns in
+	// 						 the order of the pattern keys
+	template <typename HostGraphType, typename PatternGraphType = HostGraphType>
+	class IncrementalMatcher
+	{
+		public:
+			using key_type = typename HostGraphType::key_type;
+			using changes_type = MatchChanges<key_type>;
+			using size_type = std::size_t;
+
+			explicit IncrementalMatcher(HostGraphType& graph) : host(graph) {}
+
+			IncrementalMatcher(const IncrementalMatcher&) = delete;
+			IncrementalMatcher& operator=(const IncrementalMatcher&) = delete;
+
+			// registers a pattern and matches it against the current host,
+			// returns its index in the updates
+			size_type add_pattern(const PatternGraphType& pattern);
+
+			size_type num_patterns() const { return patterns.size(); }
+
+			// the current matches of a pattern
+			MatchSet<key_type> matches(size_type pattern) const;
+			size_type match_count(size_type pattern) const { return patterns[pattern]->count; }
+
+			// brings the matches up to date with the host after the given keys
+			// changed, returns what changed for each pattern
+			template <typename KeyRange>
+			std::vector<changes_type> update(const KeyRange& changed);
+
+			// the same with the keys from the host's change log, which is cleared
+			std::vector<changes_type> update();
+
+		private:
+			using pattern_id_type = typename PatternGraphType::id_type;
+			using host_id_type = typename HostGraphType::id_type;
+			using matcher_type = SubgraphMatcher<PatternGraphType, HostGraphType>;
+			using row_list_type = std::vector<size_type>;
+
+			struct Pattern
+			{
+				PatternGraphType graph;
+
+				// the pattern keys in column order and their ids
+				std::vector<key_type> columns;
+				std::vector<pattern_id_type> column_ids;
+
+				// one matcher per pattern vertex, rooted there
+				std::vector<matcher_type> rooted;
+
+				// the matches as rows of host keys, rows of dropped matches are
+				// reused by later ones
+				std::vector<key_type> rows;
+				std::vector<bool> live;
+				std::vector<size_type> free_rows;
+				size_type count = 0;
+
+				// the rows each host key shows up in, entries of dropped or reused
+				// rows are skipped and pruned when the list has to grow
+				std::unordered_map<key_type, row_list_type> rows_of;
+
+				explicit Pattern(const PatternGraphType& pattern) : graph(pattern) {}
+
+				const key_type* row(size_type r) const { return rows.data() + r * columns.size(); }
+				bool holds(size_type r, const key_type& key) const;
+
+				void store(const key_type* hosts);
+				void drop(size_type r);
+			};
+
+			HostGraphType& host;
+			std::vector<std::unique_ptr<Pattern>> patterns;
+
+			changes_type update(Pattern& pattern, const std::vector<key_type>& keys);
+	};
+
+	template <typename HostGraphType, typename PatternGraphType>
+	bool IncrementalMatcher<HostGraphType, PatternGraphType>::Pattern::holds(size_type r, const key_type& key) const
+	{
+		auto first = row(r);
+		return live[r] && std::find(first, first + columns.size(), key) != first + columns.size();
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	void IncrementalMatcher<HostGraphType, PatternGraphType>::Pattern::store(const key_type* hosts)
+	{
+		auto n = columns.size();
+		size_type r;
+		if(!free_rows.empty())
+		{
+			r = free_rows.back();
+			free_rows.pop_back();
+			live[r] = true;
+		}
+		else
+		{
+			r = live.size();
+			rows.resize(rows.size() + n);
+			live.push_back(true);
+		}
+		std::copy(hosts, hosts + n, rows.begin() + r * n);
+		count++;
+
+		for(size_type c = 0; c < n; c++)
+		{
+			auto& list = rows_of[hosts[c]];
+			//prune before growing so lists of long lived keys stay bounded
+			if(list.size() == list.capacity())
+			{
+				const auto& key = hosts[c];
+				list.erase(std::remove_if(list.begin(), list.end(),
+							[&](size_type s) { return !holds(s, key); }), list.end());
+				std::sort(list.begin(), list.end());
+				list.erase(std::unique(list.begin(), list.end()), list.end());
+			}
+			list.push_back(r);
+		}
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	void IncrementalMatcher<HostGraphType, PatternGraphType>::Pattern::drop(size_type r)
+	{
+		live[r] = false;
+		free_rows.push_back(r);
+		count--;
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	typename IncrementalMatcher<HostGraphType, PatternGraphType>::size_type
+	IncrementalMatcher<HostGraphType, PatternGraphType>::add_pattern(const PatternGraphType& pattern)
+	{
+		auto& p = *patterns.emplace_back(std::make_unique<Pattern>(pattern));
+
+		for(auto iter = p.graph.node_list_begin(); iter != p.graph.node_list_end(); iter++)
+		{
+			p.columns.push_back(iter->first);
+		}
+		std::sort(p.columns.begin(), p.columns.end());
+
+		p.rooted.reserve(p.columns.size());
+		for(const auto& key : p.columns)
+		{
+			p.column_ids.push_back(p.graph.node_id(key));
+			p.rooted.emplace_back(p.graph, host, p.column_ids.back());
+		}
+
+		//the first matches come from a full search
+		std::vector<key_type> hosts(p.columns.size());
+		matcher_type matcher(p.graph, host);
+		matcher.run([&](const auto& M) {
+			for(size_type c = 0; c < hosts.size(); c++)
+			{
+				hosts[c] = host.node_key(M[p.column_ids[c]]);
+			}
+			p.store(hosts.data());
+			return true;
+		});
+		return patterns.size() - 1;
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	MatchSet<typename HostGraphType::key_type>
+	IncrementalMatcher<HostGraphType, PatternGraphType>::matches(size_type pattern) const
+	{
+		const auto& p = *patterns[pattern];
+		MatchSet<key_type> result(p.columns);
+		result.reserve(p.count);
+		for(size_type r = 0; r < p.live.size(); r++)
+		{
+			if(p.live[r]) result.push_back(p.row(r), p.row(r) + p.columns.size());
+		}
+		return result;
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	template <typename KeyRange>
+	std::vector<typename IncrementalMatcher<HostGraphType, PatternGraphType>::changes_type>
+	IncrementalMatcher<HostGraphType, PatternGraphType>::update(const KeyRange& changed)
+	{
+		//a key changed twice is looked at once
+		std::vector<key_type> keys;
+		std::unordered_set<key_type> seen;
+		for(const auto& key : changed)
+		{
+			if(seen.insert(key).second) keys.push_back(key);
+		}
+
+		std::vector<changes_type> result;
+		result.reserve(patterns.size());
+		for(auto& p : patterns)
+		{
+			result.push_back(update(*p, keys));
+		}
+		return result;
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	std::vector<typename IncrementalMatcher<HostGraphType, PatternGraphType>::changes_type>
+	IncrementalMatcher<HostGraphType, PatternGraphType>::update()
+	{
+		static_assert(HostGraphType::has_change_log, "updates from the host need ChangeLogTraits");
+		auto keys = host.changed_nodes();
+		host.clear_changes();
+		return update(keys);
+	}
+
+	template <typename HostGraphType, typename PatternGraphType>
+	typename IncrementalMatcher<HostGraphType, PatternGraphType>::changes_type
+	IncrementalMatcher<HostGraphType, PatternGraphType>::update(Pattern& p, const std::vector<key_type>& keys)
+	{
+		auto n = p.columns.size();
+		changes_type changes{MatchSet<key_type>(p.columns), MatchSet<key_type>(p.columns)};
+		if(n == 0) return changes;
+
+		//every stored match through a changed key comes out
+		std::set<std::vector<key_type>> before;
+		for(const auto& key : keys)
+		{
+			auto iter = p.rows_of.find(key);
+			if(iter == p.rows_of.end()) continue;
+
+			for(auto r : iter->second)
+			{
+				if(!p.holds(r, key)) continue;
+				before.emplace(p.row(r), p.row(r) + n);
+				p.drop(r);
+			}
+			p.rows_of.erase(iter);
+		}
+
+		//and the current matches through one go in. A match through several
+		//changed nodes is kept by the search pinned to the first of them
+		std::unordered_map<host_id_type, size_type> rank;
+		std::vector<host_id_type> pinned;
+		for(const auto& key : keys)
+		{
+			auto id = host.node_id(key);
+			if(id == HostGraphType::invalid_id) continue;
+			rank.emplace(id, pinned.size());
+			pinned.push_back(id);
+		}
+
+		std::set<std::vector<key_type>> after;
+		std::vector<key_type> hosts(n);
+		for(auto& matcher : p.rooted)
+		{
+			matcher.reseed();
+		}
+		for(size_type i = 0; i < pinned.size(); i++)
+		{
+			for(auto& matcher : p.rooted)
+			{
+				matcher.run(&pinned[i], &pinned[i] + 1, [&](const auto& M) {
+					for(auto u : p.column_ids)
+					{
+						auto iter = rank.find(M[u]);
+						if(iter != rank.end() && iter->second < i) return true;
+					}
+					for(size_type c = 0; c < n; c++)
+					{
+						hosts[c] = host.node_key(M[p.column_ids[c]]);
+					}
+					after.insert(hosts);
+					return true;
+				});
+			}
+		}
+
+		//matches found again were never gone
+		for(const auto& row : after)
+		{
+			p.store(row.data());
+			if(before.erase(row) == 0) changes.added.push_back(row.begin(), row.end());
+		}
+		for(const auto& row : before)
+		{
+			changes.invalidated.push_back(row.begin(), row.end());
+		}
+		return changes;
+	}
+
+} // end namespace YAGL
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef YAGL_JOURNAL_HPP
+#define YAGL_JOURNAL_HPP
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for hash
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "YAGL_Key_Range.hpp"
+
+namespace YAGL
+{
+	// the journal of graphs that keep none
+	struct NoJournal {};
+
+	enum class ChangeKind
+	{
+		add_node,
+		remove_node,
+		set_data,
+		add_edge,
+		remove_edge,
+		set_edge_data,
+		clear
+	};
+
+	// one change to a graph, edges name both ends and nodes only key_a. The
+	// payload is kept for added nodes and new data so a change can be
+	// replayed on another graph
+	template <typename KeyType, typename DataType, typename EdgeDataType>
+	struct Change
+	{
+		using epoch_type = std::uint64_t;
+
+		epoch_type epoch;
+		ChangeKind kind;
+		KeyType key_a;
+		KeyType key_b;
+		std::optional<DataType> data;
+		std::optional<EdgeDataType> edge_data;
+	};
+
+	// Motivation: caches derived from a graph, degree statistics, component
+	// 						 labels or a CSR snapshot, want to know what changed since
+	// 						 they were built instead of building again. The journal
+	// 						 records every change with a monotonic epoch, a consumer
+	// 						 remembers the epoch it has seen and asks for the changes
+	// 						 since. The same list can be shipped and replayed on a
+	// 						 copy of the graph with apply_changes
+	//
+	// NOTE: 			 the journal grows with every change. Once all consumers
+	// 						 have caught up to an epoch, truncate drops what they have
+	// 						 seen. compact squashes a stretch of changes into its net
+	// 						 effect, see below
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	class Journal
+	{
+		public:
+			using change_type = Change<KeyType, DataType, EdgeDataType>;
+			using epoch_type = typename change_type::epoch_type;
+			using change_range_type = IdSpan<change_type>;
+			using size_type = std::size_t;
+
+			// the epoch of the latest change, zero before the first
+			epoch_type epoch() const { return current; }
+
+			// the oldest epoch changes_since can start from
+			epoch_type base() const { return first; }
+
+			size_type size() const { return entries.size(); }
+
+			// the changes after epoch e in the order they happened, e must not be
+			// older than base(). The range is invalidated by the next change
+			change_range_type changes_since(epoch_type e) const;
+
+			void record(ChangeKind kind, const KeyType& key_a, const KeyType& key_b = KeyType(),
+					const DataType* data = nullptr, const EdgeDataType* edge_data = nullptr);
+
+			// forgets the changes up to epoch e, base() moves up to e
+			void truncate(epoch_type e);
+
+			// replaces the changes up to epoch e with their net effect, all of
+			// them stamped with e. Replaying them on the graph as of base() still
+			// leads to the graph as of e, but a consumer in between has to catch
+			// up before the compaction
+			void compact(epoch_type e);
+
+		private:
+			std::vector<change_type> entries;
+			epoch_type current = 0;
+			epoch_type first = 0;
+
+			// the changes up to e, the end of the stretch compaction works on
+			size_type upper(epoch_type e) const;
+
+			// an edge is the same from either end when undirected
+			std::pair<KeyType, KeyType> edge_key(const change_type& c) const;
+
+			struct pair_hash
+			{
+				std::size_t operator()(const std::pair<KeyType, KeyType>& p) const
+				{
+					auto a = std::hash<KeyType>()(p.first);
+					return a ^ (std::hash<KeyType>()(p.second) + 0x9e3779b9 + (a << 6) + (a >> 2));
+				}
+			};
+	};
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	typename Journal<KeyType, DataType, EdgeDataType, Directed>::size_type
+	Journal<KeyType, DataType, EdgeDataType, Directed>::upper(epoch_type e) const
+	{
+		return std::upper_bound(entries.begin(), entries.end(), e,
+				[](epoch_type x, const change_type& c) { return x < c.epoch; }) - entries.begin();
+	}
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	typename Journal<KeyType, DataType, EdgeDataType, Directed>::change_range_type
+	Journal<KeyType, DataType, EdgeDataType, Directed>::changes_since(epoch_type e) const
+	{
+		auto begin = entries.data() + upper(e);
+		return change_range_type(begin, entries.data() + entries.size());
+	}
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	void Journal<KeyType, DataType, EdgeDataType, Directed>::record(ChangeKind kind,
+			const KeyType& key_a, const KeyType& key_b, const DataType* data, const EdgeDataType* edge_data)
+	{
+		auto& c = entries.emplace_back();
+		c.epoch = ++current;
+		c.kind = kind;
+		c.key_a = key_a;
+		c.key_b = key_b;
+		if(data) c.data = *data;
+		if(edge_data) c.edge_data = *edge_data;
+	}
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	void Journal<KeyType, DataType, EdgeDataType, Directed>::truncate(epoch_type e)
+	{
+		if(e <= first) return;
+		entries.erase(entries.begin(), entries.begin() + upper(e));
+		first = std::min(e, current);
+	}
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	std::pair<KeyType, KeyType> Journal<KeyType, DataType, EdgeDataType, Directed>::edge_key(const change_type& c) const
+	{
+		if constexpr(!Directed)
+		{
+			if(c.key_b < c.key_a) return {c.key_b, c.key_a};
+		}
+		return {c.key_a, c.key_b};
+	}
+
+	template <typename KeyType, typename DataType, typename EdgeDataType, bool Directed>
+	void Journal<KeyType, DataType, EdgeDataType, Directed>::compact(epoch_type e)
+	{
+		auto n = upper(e);
+		std::vector<bool> dropped(n, false);
+
+		auto is_edge = [](ChangeKind k) {
+			return k == ChangeKind::add_edge || k == ChangeKind::remove_edge || k == ChangeKind::set_edge_data;
+		};
+
+		//nothing before the last clear survives it
+		for(size_type i = n; i-- > 0; )
+		{
+			if(entries[i].kind == ChangeKind::clear)
+			{
+				std::fill(dropped.begin(), dropped.begin() + i, true);
+				break;
+			}
+		}
+
+		//a node added and removed again takes everything about it in between
+		//along, the edges to it only existed while it did
+		std::unordered_map<KeyType, std::vector<size_type>> mentions;
+		std::unordered_map<KeyType, size_type> born;
+		for(size_type i = 0; i < n; i++)
+		{
+			if(dropped[i]) continue;
+			const auto& c = entries[i];
+			if(c.kind == ChangeKind::clear)
+			{
+				mentions.clear();
+				born.clear();
+				continue;
+			}
+
+			mentions[c.key_a].push_back(i);
+			if(is_edge(c.kind) && !(c.key_a == c.key_b)) mentions[c.key_b].push_back(i);
+
+			if(c.kind == ChangeKind::add_node)
+			{
+				born[c.key_a] = mentions[c.key_a].size() - 1;
+			}
+			else if(c.kind == ChangeKind::remove_node)
+			{
+				auto iter = born.find(c.key_a);
+				if(iter == born.end()) continue;
+
+				auto& list = mentions[c.key_a];
+				for(auto p = iter->second; p < list.size(); p++)
+				{
+					dropped[list[p]] = true;
+				}
+				born.erase(iter);
+			}
+		}
+
+		//an edge added and removed again cancels out, like the payloads it
+		//was given in between. Only the last payload of an edge matters, as
+		//does only the last data of a node, which is folded into its addition
+		using edge_key_type = std::pair<KeyType, KeyType>;
+		std::unordered_map<edge_key_type, size_type, pair_hash> edge_added;
+		std::unordered_map<edge_key_type, size_type, pair_hash> edge_payload;
+		std::unordered_map<KeyType, size_type> node_added;
+		std::unordered_map<KeyType, size_type> node_data;
+		for(size_type i = 0; i < n; i++)
+		{
+			if(dropped[i]) continue;
+			auto& c = entries[i];
+			switch(c.kind)
+			{
+				case ChangeKind::clear:
+					edge_added.clear(); edge_payload.clear();
+					node_added.clear(); node_data.clear();
+					break;
+				case ChangeKind::add_edge:
+					edge_added[edge_key(c)] = i;
+					break;
+				case ChangeKind::set_edge_data:
+				{
+					auto [iter, fresh] = edge_payload.try_emplace(edge_key(c), i);
+					if(!fresh) { dropped[iter->second] = true; iter->second = i; }
+					break;
+				}
+				case ChangeKind::remove_edge:
+				{
+					auto key = edge_key(c);
+					auto payload = edge_payload.find(key);
+					if(payload != edge_payload.end()) { dropped[payload->second] = true; edge_payload.erase(payload); }
+
+					auto added = edge_added.find(key);
+					if(added != edge_added.end()) { dropped[added->second] = true; dropped[i] = true; edge_added.erase(added); }
+					break;
+				}
+				case ChangeKind::add_node:
+					node_added[c.key_a] = i;
+					break;
+				case ChangeKind::set_data:
+				{
+					auto added = node_added.find(c.key_a);
+					if(added != node_added.end())
+					{
+						entries[added->second].data = std::move(c.data);
+						dropped[i] = true;
+						break;
+					}
+					auto [iter, fresh] = node_data.try_emplace(c.key_a, i);
+					if(!fresh) { dropped[iter->second] = true; iter->second = i; }
+					break;
+				}
+				case ChangeKind::remove_node:
+				{
+					auto data = node_data.find(c.key_a);
+					if(data != node_data.end()) { dropped[data->second] = true; node_data.erase(data); }
+					node_added.erase(c.key_a);
+					break;
+				}
+			}
+		}
+
+		//squeeze the survivors together, all as of epoch e
+		size_type kept = 0;
+		for(size_type i = 0; i < n; i++)
+		{
+			if(dropped[i]) continue;
+			if(kept != i) entries[kept] = std::move(entries[i]);
+			entries[kept++].epoch = std::min(e, current);
+		}
+		entries.erase(entries.begin() + kept, entries.begin() + n);
+	}
+
+	// Motivation: replays a list of changes, from a journal or shipped from
+	// 						 another process, on a graph that was in the state they
+	// 						 started from
+	template <typename GraphType, typename ChangeRange>
+	void apply_changes(GraphType& graph, const ChangeRange& changes)
+	{
+		for(const auto& c : changes)
+		{
+			switch(c.kind)
+			{
+				case ChangeKind::add_node:
+					graph.addNode(typename GraphType::node_type(c.key_a, *c.data));
+					break;
+				case ChangeKind::remove_node:
+				{
+					auto iter = graph.findNode(c.key_a);
+					if(iter != graph.node_list_end()) graph.removeNode(iter->second);
+					break;
+				}
+				case ChangeKind::set_data:
+					graph.setData(c.key_a, *c.data);
+					break;
+				case ChangeKind::add_edge:
+					graph.addEdge(c.key_a, c.key_b);
+					break;
+				case ChangeKind::remove_edge:
+					graph.removeEdge(c.key_a, c.key_b);
+					break;
+				case ChangeKind::set_edge_data:
+					if constexpr(GraphType::has_edge_data)
+					{
+						graph.setEdgeData(c.key_a, c.key_b, *c.edge_data);
+					}
+					break;
+				case ChangeKind::clear:
+					graph.clear();
+					break;
+			}
+		}
+	}
+
+} // end namespace YAGL
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef YAGL_KEY_RANGE_HPP
+#define YAGL_KEY_RANGE_HPP
+
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+
+namespace YAGL
+{
+	// Motivation: internally neighbors are stored as dense integer ids, but the
+	// 						 public interface hands out keys. A KeyIterator wraps any id
+	// 						 iterator and translates each id into its key on dereference
+	// 						 with a single array load, no hashing involved
+	//
+	// NOTE: 			 keys is indexed by id, a plain key array by default or
+	// 						 anything else with an operator[] returning a key reference
+	template <typename IdIterator, typename KeyType, typename KeyLookup = const KeyType*>
+	class KeyIterator
+	{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = KeyType;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const KeyType*;
+			using reference = const KeyType&;
+
+			KeyIterator() : iter(), keys() {}
+
+			KeyIterator(IdIterator i, KeyLookup k) : iter(i), keys(k) {}
+
+			reference operator*() const { return keys[*iter]; }
+			pointer operator->() const { return &keys[*iter]; }
+
+			KeyIterator& operator++() { ++iter; return *this; }
+			KeyIterator operator++(int) { auto tmp = *this; ++iter; return tmp; }
+
+			bool operator==(const KeyIterator& b) const { return iter == b.iter; }
+			bool operator!=(const KeyIterator& b) const { return iter != b.iter; }
+
+			//the underlying id for callers that want to skip the translation
+			auto id() const { return *iter; }
+
+		private:
+			IdIterator iter;
+			KeyLookup keys;
+	};
+
+	// Motivation: a lightweight, non-owning view over a neighborhood that
+	// 						 behaves like the old node sets for iteration, size checks
+	// 						 and find or count by key
+	//
+	// NOTE: 			 a view, not a copy, it is invalidated like an iterator by
+	// 						 any change to the graph it came from. find and count walk
+	// 						 the neighborhood, the graph's adjacent is the constant
+	// 						 time membership test
+	template <typename IdIterator, typename KeyType, typename KeyLookup = const KeyType*>
+	class KeyRange
+	{
+		public:
+			using key_type = KeyType;
+			using iterator = KeyIterator<IdIterator, KeyType, KeyLookup>;
+			using const_iterator = iterator;
+			using size_type = std::size_t;
+
+			KeyRange() : first(), last(), length(0) {}
+
+			KeyRange(IdIterator f, IdIterator l, size_type n, KeyLookup keys)
+			: first(f, keys), last(l, keys), length(n) {}
+
+			iterator begin() const { return first; }
+			iterator end() const { return last; }
+
+			size_type size() const { return length; }
+			bool empty() const { return length == 0; }
+
+			iterator find(const KeyType& key) const
+			{
+				for(auto iter = first; iter != last; ++iter)
+				{
+					if(*iter == key) return iter;
+				}
+				return last;
+			}
+			size_type count(const KeyType& key) const { return find(key) == last ? 0 : 1; }
+
+		private:
+			iterator first;
+			iterator last;
+			size_type length;
+	};
+
+	// Motivation: contiguous slice of an id array, used by the CSR layout
+	template <typename IdType>
+	class IdSpan
+	{
+		public:
+			using value_type = IdType;
+			using iterator = const IdType*;
+			using const_iterator = const IdType*;
+			using size_type = std::size_t;
+
+			IdSpan() : first(nullptr), last(nullptr) {}
+
+			IdSpan(const IdType* f, const IdType* l) : first(f), last(l) {}
+
+			iterator begin() const { return first; }
+			iterator end() const { return last; }
+
+			size_type size() const { return static_cast<size_type>(last - first); }
+			bool empty() const { return first == last; }
+
+		private:
+			const IdType* first;
+			const IdType* last;
+	};
+
+} // end namespace YAGL
+
+#endif
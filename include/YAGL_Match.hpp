@@ -0,0 +1,256 @@
+#ifndef YAGL_MATCH_HPP
+#define YAGL_MATCH_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <functional> // for invoke
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace YAGL
+{
+	// Motivation: a match handed to a visitor only lives until the visitor
+	// 						 returns, so there is no reason to build a map for it. A
+	// 						 MatchView is a non-owning span of (pattern key, host key)
+	// 						 pairs over a buffer the matcher reuses for every match
+	//
+	// NOTE: 			 the pairs come in the matcher's own order, not sorted by
+	// 						 pattern key, use host() to look a pattern key up. Copy
+	// 						 the pairs out if the match has to outlive the visit
+	template <typename KeyType>
+	class MatchView
+	{
+		public:
+			using key_type = KeyType;
+			using value_type = std::pair<KeyType, KeyType>;
+			using iterator = const value_type*;
+			using const_iterator = const value_type*;
+			using size_type = std::size_t;
+
+			MatchView() : first(nullptr), count(0) {}
+
+			MatchView(const value_type* f, size_type n) : first(f), count(n) {}
+
+			iterator begin() const { return first; }
+			iterator end() const { return first + count; }
+
+			size_type size() const { return count; }
+			bool empty() const { return count == 0; }
+
+			const value_type& operator[](size_type i) const { return first[i]; }
+
+			// the image of a pattern key or nullptr if it is not part of the
+			// match, a linear scan since patterns are small
+			const KeyType* host(const KeyType& pattern_key) const
+			{
+				for(auto p = begin(); p != end(); ++p)
+				{
+					if(p->first == pattern_key) return &p->second;
+				}
+				return nullptr;
+			}
+
+		private:
+			const value_type* first;
+			size_type count;
+	};
+
+	// Motivation: visitors either return whether to keep going or nothing at
+	// 						 all, in which case every match is visited
+	template <typename Visitor, typename... Args>
+	bool visit_match(Visitor& visit, Args&&... args)
+	{
+		if constexpr(std::is_void_v<std::invoke_result_t<Visitor&, Args...>>)
+		{
+			std::invoke(visit, std::forward<Args>(args)...);
+			return true;
+		}
+		else
+		{
+			return static_cast<bool>(std::invoke(visit, std::forward<Args>(args)...));
+		}
+	}
+
+	// one match of a MatchSet, the host keys of a row next to the shared
+	// pattern keys of its columns
+	template <typename KeyType>
+	class MatchRow
+	{
+		public:
+			using key_type = KeyType;
+			using size_type = std::size_t;
+
+			MatchRow() : pattern(nullptr), hosts(nullptr), count(0) {}
+
+			MatchRow(const KeyType* p, const KeyType* h, size_type n) : pattern(p), hosts(h), count(n) {}
+
+			size_type size() const { return count; }
+
+			// the pattern key and host key of column c
+			const KeyType& pattern_key(size_type c) const { return pattern[c]; }
+			const KeyType& operator[](size_type c) const { return hosts[c]; }
+
+			const KeyType* begin() const { return hosts; }
+			const KeyType* end() const { return hosts + count; }
+
+			// the image of a pattern key or nullptr if it is not a column
+			const KeyType* host(const KeyType& pattern_key) const
+			{
+				for(size_type c = 0; c < count; c++)
+				{
+					if(pattern[c] == pattern_key) return &hosts[c];
+				}
+				return nullptr;
+			}
+
+			std::map<KeyType, KeyType> to_map() const
+			{
+				std::map<KeyType, KeyType> result;
+				for(size_type c = 0; c < count; c++)
+				{
+					result.emplace(pattern[c], hosts[c]);
+				}
+				return result;
+			}
+
+		private:
+			const KeyType* pattern;
+			const KeyType* hosts;
+			size_type count;
+	};
+
+	// Motivation: a list of std::maps spends a tree node per mapped pair and
+	// 						 a tree per match. Every match of one pattern maps the same
+	// 						 pattern keys, so a MatchSet stores those once as its
+	// 						 columns and keeps all the host keys in one contiguous
+	// 						 array, row after row with a stride of the pattern size
+	//
+	// NOTE: 			 the column order is fixed when the set is made, for sets
+	// 						 filled by the matchers it is their matching order. Rows
+	// 						 are views into the set and are invalidated when it grows
+	template <typename KeyType>
+	class MatchSet
+	{
+		public:
+			using key_type = KeyType;
+			using row_type = MatchRow<KeyType>;
+			using size_type = std::size_t;
+			using legacy_type = std::vector<std::map<KeyType, KeyType>>;
+
+			class const_iterator
+			{
+				public:
+					using iterator_category = std::forward_iterator_tag;
+					using value_type = row_type;
+					using difference_type = std::ptrdiff_t;
+					using pointer = void;
+					using reference = row_type;
+
+					const_iterator() : set(nullptr), i(0) {}
+
+					const_iterator(const MatchSet* s, size_type n) : set(s), i(n) {}
+
+					row_type operator*() const { return (*set)[i]; }
+
+					const_iterator& operator++() { ++i; return *this; }
+					const_iterator operator++(int) { auto tmp = *this; ++i; return tmp; }
+
+					bool operator==(const const_iterator& b) const { return i == b.i; }
+					bool operator!=(const const_iterator& b) const { return i != b.i; }
+
+				private:
+					const MatchSet* set;
+					size_type i;
+			};
+			using iterator = const_iterator;
+
+			MatchSet() = default;
+
+			explicit MatchSet(std::vector<KeyType> pattern_keys) : pattern(std::move(pattern_keys)) {}
+
+			// the pattern keys in column order
+			const std::vector<KeyType>& columns() const { return pattern; }
+
+			size_type stride() const { return pattern.size(); }
+
+			// the number of matches, a set of an empty pattern holds none
+			size_type size() const { return pattern.empty() ? 0 : hosts.size() / pattern.size(); }
+			bool empty() const { return hosts.empty(); }
+
+			void reserve(size_type matches) { hosts.reserve(matches * pattern.size()); }
+			void clear() { hosts.clear(); }
+
+			// the column of a pattern key, stride() if it is not one
+			size_type column(const KeyType& pattern_key) const
+			{
+				for(size_type c = 0; c < pattern.size(); c++)
+				{
+					if(pattern[c] == pattern_key) return c;
+				}
+				return pattern.size();
+			}
+
+			row_type operator[](size_type i) const
+			{
+				return row_type(pattern.data(), hosts.data() + i * pattern.size(), pattern.size());
+			}
+
+			const_iterator begin() const { return const_iterator(this, 0); }
+			const_iterator end() const { return const_iterator(this, size()); }
+
+			// appends a row of host keys given in column order
+			template <typename HostIter>
+			void push_back(HostIter first, HostIter last) { hosts.insert(hosts.end(), first, last); }
+
+			// appends a row in place, the returned stride() keys are filled by
+			// the caller before the set is touched again
+			KeyType* append_row()
+			{
+				hosts.resize(hosts.size() + pattern.size());
+				return hosts.data() + hosts.size() - pattern.size();
+			}
+
+			// appends a match given as pairs in any order, every pattern key of
+			// the match has to be one of the columns
+			void push_back(const MatchView<KeyType>& match)
+			{
+				auto row = append_row();
+				for(const auto& [v, w] : match)
+				{
+					row[column(v)] = w;
+				}
+			}
+
+			// appends the rows of another set with the same columns
+			void append(const MatchSet& other)
+			{
+				hosts.insert(hosts.end(), other.hosts.begin(), other.hosts.end());
+			}
+
+			// the raw host keys, row after row
+			const std::vector<KeyType>& data() const { return hosts; }
+
+			// conversion to the list of maps the Ltype interface returns
+			legacy_type to_legacy() const
+			{
+				legacy_type result;
+				result.reserve(size());
+				for(auto row : *this)
+				{
+					result.push_back(row.to_map());
+				}
+				return result;
+			}
+
+		private:
+			std::vector<KeyType> pattern;
+			std::vector<KeyType> hosts;
+	};
+
+} // end namespace YAGL
+
+#endif
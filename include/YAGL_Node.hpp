@@ -4,6 +4,8 @@
 #pragma once 
 
 #include <iostream>
+#include <type_traits> // for is_aggregate
+#include <utility> // for move and in_place
 
 namespace YAGL
 {
@@ -21,10 +23,18 @@ namespace YAGL
 			using key_type = KeyType;
 			
 			Node(const KeyType, const DataType& data);
+			Node(const KeyType, DataType&& data);
+			
+			// Motivation: builds the payload directly inside the node, aggregate
+			// 						 payloads like { type } structs from their fields
+			template <typename ... Args>
+			Node(const KeyType, std::in_place_t, Args&& ... args);
+			
 			~Node() = default;
 
 			const KeyType& getKey() const;
 			DataType& getData();
+			const DataType& getData() const;
 
 			bool operator==(const Node<KeyType, DataType>& b) const;
 			bool operator<(const Node<KeyType, DataType>& b) const;
@@ -34,15 +44,49 @@ namespace YAGL
 		private:
 			KeyType key;
 			DataType data;	
+
+			// a prvalue, so the payload is still built in place
+			template <typename ... Args>
+			static DataType make_data(Args&& ... args);
 	};
 
 	template <typename KeyType, typename DataType>
 	Node<KeyType, DataType>::Node(const KeyType k, const DataType& d)
-	: key(k), data(d) //TODO: possibly make it a move
+	: key(k), data(d)
 	{
 		
 	}
 
+	template <typename KeyType, typename DataType>
+	Node<KeyType, DataType>::Node(const KeyType k, DataType&& d)
+	: key(k), data(std::move(d))
+	{
+
+	}
+
+	template <typename KeyType, typename DataType>
+	template <typename ... Args>
+	Node<KeyType, DataType>::Node(const KeyType k, std::in_place_t, Args&& ... args)
+	: key(k), data(make_data(std::forward<Args>(args)...))
+	{
+
+	}
+
+	template <typename KeyType, typename DataType>
+	template <typename ... Args>
+	DataType Node<KeyType, DataType>::make_data(Args&& ... args)
+	{
+		//parentheses do not initialize aggregates before C++20
+		if constexpr(std::is_aggregate_v<DataType>)
+		{
+			return DataType{std::forward<Args>(args)...};
+		}
+		else
+		{
+			return DataType(std::forward<Args>(args)...);
+		}
+	}
+
 	template <typename KeyType, typename DataType>
 	const KeyType& Node<KeyType, DataType>::getKey() const
 	{
@@ -55,6 +99,12 @@ namespace YAGL
 		return data;
 	}
 
+	template <typename KeyType, typename DataType>
+	const DataType& Node<KeyType, DataType>::getData() const
+	{
+		return data;
+	}
+
 	template <typename KeyType, typename DataType>
 	bool Node<KeyType, DataType>::operator==(const Node<KeyType, DataType>& b) const
 	{
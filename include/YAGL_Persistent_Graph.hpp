@@ -0,0 +1,474 @@
+#ifndef YAGL_PERSISTENT_GRAPH_HPP
+#define YAGL_PERSISTENT_GRAPH_HPP
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for hash
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "YAGL_Node.hpp"
+#include "YAGL_Key_Range.hpp"
+#include "YAGL_Graph_Traits.hpp"
+#include "YAGL_Cow_Vector.hpp"
+#include "YAGL_Graph.hpp"
+
+namespace YAGL
+{
+	// Motivation: simulations snapshot their graph every few steps to roll
+	// 						 back to, and a Graph copy rebuilds every map and neighbor
+	// 						 set. A persistent graph keeps its nodes, their neighbor
+	// 						 sets and its key to id table in copy on write chunks, see
+	// 						 CowVector, so a copy is a handful of pointer copies. The
+	// 						 two copies share all of their storage until one of them
+	// 						 changes, and then only the chunks holding the changed
+	// 						 nodes are cloned, an edge clones at most two. The key
+	// 						 table grows one bucket at a time by linear hashing, so a
+	// 						 growth clones the chunk of the bucket it splits and the
+	// 						 last one, the rest stay shared as well
+	//
+	// NOTE: 			 ids are dense and recycled like those of a Graph. The
+	// 						 neighbor sets come from the traits and are cloned with
+	// 						 their chunk, small sorted sets keep that cheap. Label
+	// 						 columns are not kept, edge data, change logs and journals
+	// 						 are not available, convert with to_graph() to run the
+	// 						 matchers on a snapshot
+	template <typename KeyType, typename DataType, typename Traits = DefaultGraphTraits, std::size_t ChunkSize = 64>
+	class PersistentGraph
+	{
+		static_assert(std::is_same_v<typename Traits::edge_data_type, NoEdgeData>,
+				"persistent graphs do not keep edge data");
+		static_assert(!Traits::change_log && !Traits::journal,
+				"persistent graphs do not record their changes, diff snapshots instead");
+
+		public:
+			using key_type = KeyType;
+			using data_type = DataType;
+			using node_type = Node<key_type, data_type>;
+			using traits_type = Traits;
+
+			using id_type = std::uint32_t;
+			static constexpr id_type invalid_id = std::numeric_limits<id_type>::max();
+
+			using id_set_type = typename Traits::template neighbor_set_type<id_type>;
+			static constexpr bool is_directed = Traits::directed;
+			using in_out_nbr_type = NeighborSets<id_set_type, is_directed>;
+
+			using counting_type = std::size_t;
+			using graph_type = Graph<key_type, data_type, Traits>;
+
+		private:
+			// a used slot holds its node, a free one the next free id
+			struct Slot
+			{
+				std::optional<node_type> node;
+				in_out_nbr_type nbrs;
+				id_type next_free = invalid_id;
+			};
+
+			using slot_list_type = CowVector<Slot, ChunkSize>;
+			using bucket_type = std::vector<id_type>;
+			using bucket_list_type = CowVector<bucket_type, ChunkSize>;
+
+		public:
+			// the keys are spread over chunks, neighbor ranges look them up
+			// through the slots instead of a flat key array
+			struct KeyLookup
+			{
+				const slot_list_type* slots = nullptr;
+				const KeyType& operator[](id_type id) const { return (*slots)[id].node->getKey(); }
+			};
+
+			using node_set_type = KeyRange<typename id_set_type::const_iterator, key_type, KeyLookup>;
+
+			PersistentGraph() : free_head(invalid_id), bucket_base(0), bucket_split(0), num_nodes(0), num_edges(0) {}
+
+			// a persistent copy of an ordinary graph
+			explicit PersistentGraph(graph_type& graph);
+
+			// an ordinary graph with the same nodes and edges, ids are not kept
+			graph_type to_graph() const;
+
+			void addNode(const node_type& node);
+			void removeNode(const node_type& node);
+
+			// Motivation: replaces the payload of an existing node, missing keys
+			// 						 are ignored
+			void setData(const KeyType& key, const DataType& data);
+
+			// nullptr if there is no such node, invalidated by any change
+			const node_type* findNode(const KeyType& key) const;
+
+			void addEdge(const KeyType& key_a, const KeyType& key_b);
+			void removeEdge(const KeyType& key_a, const KeyType& key_b);
+			bool adjacent(const KeyType& key_a, const KeyType& key_b) const;
+
+			node_set_type out_neighbors(const KeyType& key) const;
+			node_set_type in_neighbors(const KeyType& key) const;
+
+			//Dense id accessible versions
+			id_type id_bound() const { return static_cast<id_type>(slots.size()); }
+			id_type node_id(const KeyType& key) const;
+			const KeyType& node_key(id_type id) const { return slots[id].node->getKey(); }
+			bool has_id(id_type id) const { return id < id_bound() && slots[id].node.has_value(); }
+
+			const id_set_type& out_ids(id_type id) const { return slots[id].nbrs.out(); }
+			const id_set_type& in_ids(id_type id) const { return slots[id].nbrs.in(); }
+
+			counting_type numNodes() const { return num_nodes; }
+			counting_type numEdges() const { return num_edges; }
+			counting_type degree(const KeyType& key) const;
+
+			bool isDirected() const { return is_directed; }
+
+			void clear();
+
+			// whether a node is still stored once for both graphs, neither has
+			// changed its chunk since one was copied from the other
+			bool shares_node(const PersistentGraph& other, id_type id) const { return slots.shares(other.slots, id); }
+
+			// the same for a bucket of the key table
+			std::size_t bucket_count() const { return buckets.size(); }
+			bool shares_bucket(const PersistentGraph& other, std::size_t bucket) const { return buckets.shares(other.buckets, bucket); }
+
+		private:
+			slot_list_type slots;
+			bucket_list_type buckets;
+			id_type free_head;
+			std::size_t bucket_base;	//the buckets of the current round, a power of two
+			std::size_t bucket_split;	//the next of them to split, those before are split
+			counting_type num_nodes;
+			counting_type num_edges;
+
+			std::size_t bucket_of(const KeyType& key) const;
+			void grow_buckets();
+
+			id_type acquire_id(const node_type& node);
+			void release_id(id_type id);
+
+			void link(id_type id_a, id_type id_b);
+			void unlink(id_type id_a, id_type id_b);
+
+			node_set_type make_range(const id_set_type& ids) const;
+	};
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::PersistentGraph(graph_type& graph)
+	: PersistentGraph()
+	{
+		for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+		{
+			addNode(iter->second);
+		}
+		for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+		{
+			for(const auto& nbr : graph.out_neighbors(iter->first))
+			{
+				addEdge(iter->first, nbr);
+			}
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::graph_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::to_graph() const
+	{
+		std::vector<node_type> nodes;
+		std::vector<std::pair<key_type, key_type>> edges;
+		nodes.reserve(num_nodes);
+		edges.reserve(num_edges);
+		for(id_type id = 0; id < id_bound(); id++)
+		{
+			if(!has_id(id)) continue;
+			nodes.push_back(*slots[id].node);
+			for(auto nbr : out_ids(id))
+			{
+				//undirected edges are listed once, from their smaller end
+				if(is_directed || id <= nbr) edges.emplace_back(node_key(id), node_key(nbr));
+			}
+		}
+
+		graph_type graph;
+		graph.bulk_load(nodes, edges);
+		return graph;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	std::size_t PersistentGraph<KeyType, DataType, Traits, ChunkSize>::bucket_of(const KeyType& key) const
+	{
+		//buckets already split this round hash on one more bit
+		std::size_t h = std::hash<KeyType>()(key);
+		std::size_t b = h & (bucket_base - 1);
+		return b < bucket_split ? h & (2 * bucket_base - 1) : b;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::grow_buckets()
+	{
+		if(buckets.empty())
+		{
+			bucket_base = 16;
+			bucket_split = 0;
+			for(std::size_t b = 0; b < bucket_base; b++)
+			{
+				buckets.emplace_back();
+			}
+			return;
+		}
+
+		//split one bucket into itself and a new one at the end, only their
+		//chunks are cloned and a copy keeps sharing the others
+		std::size_t old_bucket = bucket_split;
+		std::size_t new_bucket = bucket_base + bucket_split;
+		buckets.emplace_back();
+		if(++bucket_split == bucket_base)
+		{
+			bucket_base *= 2;
+			bucket_split = 0;
+		}
+
+		if(buckets[old_bucket].empty()) return;
+		auto& bucket = buckets.mutate(old_bucket);
+		auto& moved = buckets.mutate(new_bucket);
+		for(std::size_t i = 0; i < bucket.size();)
+		{
+			if(bucket_of(node_key(bucket[i])) == new_bucket)
+			{
+				moved.push_back(bucket[i]);
+				bucket[i] = bucket.back();
+				bucket.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::id_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::node_id(const KeyType& key) const
+	{
+		if(buckets.empty()) return invalid_id;
+		for(auto id : buckets[bucket_of(key)])
+		{
+			if(node_key(id) == key) return id;
+		}
+		return invalid_id;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::id_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::acquire_id(const node_type& node)
+	{
+		id_type id;
+		//reuse a released id before growing the id space
+		if(free_head != invalid_id)
+		{
+			id = free_head;
+			auto& slot = slots.mutate(id);
+			free_head = slot.next_free;
+			slot.node.emplace(node);
+			slot.next_free = invalid_id;
+		}
+		else
+		{
+			id = id_bound();
+			slots.emplace_back().node.emplace(node);
+		}
+		num_nodes++;
+
+		//at most one node per bucket on average
+		if(num_nodes > buckets.size())
+		{
+			grow_buckets();
+		}
+		buckets.mutate(bucket_of(node.getKey())).push_back(id);
+		return id;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::release_id(id_type id)
+	{
+		auto& bucket = buckets.mutate(bucket_of(node_key(id)));
+		for(auto& entry : bucket)
+		{
+			if(entry == id)
+			{
+				entry = bucket.back();
+				bucket.pop_back();
+				break;
+			}
+		}
+
+		//a fresh set gives the memory of the old one back
+		auto& slot = slots.mutate(id);
+		slot.node.reset();
+		slot.nbrs = in_out_nbr_type();
+		slot.next_free = free_head;
+		free_head = id;
+		num_nodes--;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::link(id_type id_a, id_type id_b)
+	{
+		//look before writing, a repeated edge must not clone any chunk
+		if(out_ids(id_a).count(id_b)) return;
+
+		slots.mutate(id_a).nbrs.out().insert(id_b);
+		slots.mutate(id_b).nbrs.in().insert(id_a);
+		num_edges++;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::unlink(id_type id_a, id_type id_b)
+	{
+		if(!out_ids(id_a).count(id_b)) return;
+
+		slots.mutate(id_a).nbrs.out().erase(id_b);
+		slots.mutate(id_b).nbrs.in().erase(id_a);
+		num_edges--;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::node_set_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::make_range(const id_set_type& ids) const
+	{
+		return node_set_type(ids.begin(), ids.end(), ids.size(), KeyLookup{&slots});
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::addNode(const node_type& node)
+	{
+		auto id = node_id(node.getKey());
+		//an existing node only has its data replaced and keeps its id
+		if(id == invalid_id)
+		{
+			acquire_id(node);
+		}
+		else
+		{
+			slots.mutate(id).node.emplace(node);
+		}
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::removeNode(const node_type& node)
+	{
+		auto id = node_id(node.getKey());
+		if(id == invalid_id)
+		{
+			return; //cannot remove what does not exist
+		}
+
+		//copy the neighborhood first since unlinking edits the sets
+		std::vector<id_type> nbrs(out_ids(id).begin(), out_ids(id).end());
+		for(auto u : nbrs)
+		{
+			unlink(id, u);
+		}
+		if constexpr(is_directed)
+		{
+			nbrs.assign(in_ids(id).begin(), in_ids(id).end());
+			for(auto u : nbrs)
+			{
+				unlink(u, id);
+			}
+		}
+		release_id(id);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::setData(const KeyType& key, const DataType& data)
+	{
+		auto id = node_id(key);
+		if(id == invalid_id) return;
+		slots.mutate(id).node->getData() = data;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	const typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::node_type*
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::findNode(const KeyType& key) const
+	{
+		auto id = node_id(key);
+		return id == invalid_id ? nullptr : &*slots[id].node;
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::addEdge(const KeyType& key_a, const KeyType& key_b)
+	{
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		if(id_a == invalid_id || id_b == invalid_id)
+		{
+			return; // don't add anything
+		}
+		link(id_a, id_b);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::removeEdge(const KeyType& key_a, const KeyType& key_b)
+	{
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		if(id_a == invalid_id || id_b == invalid_id)
+		{
+			return; //cannot remove what does not exist
+		}
+		unlink(id_a, id_b);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	bool PersistentGraph<KeyType, DataType, Traits, ChunkSize>::adjacent(const KeyType& key_a, const KeyType& key_b) const
+	{
+		auto id_a = node_id(key_a);
+		auto id_b = node_id(key_b);
+		return id_a != invalid_id && id_b != invalid_id && out_ids(id_a).count(id_b);
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::node_set_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::out_neighbors(const KeyType& key) const
+	{
+		auto id = node_id(key);
+		return id == invalid_id ? node_set_type() : make_range(out_ids(id));
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::node_set_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::in_neighbors(const KeyType& key) const
+	{
+		auto id = node_id(key);
+		return id == invalid_id ? node_set_type() : make_range(in_ids(id));
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	typename PersistentGraph<KeyType, DataType, Traits, ChunkSize>::counting_type
+	PersistentGraph<KeyType, DataType, Traits, ChunkSize>::degree(const KeyType& key) const
+	{
+		auto id = node_id(key);
+		return id == invalid_id ? 0 : slots[id].nbrs.degree();
+	}
+
+	template <typename KeyType, typename DataType, typename Traits, std::size_t ChunkSize>
+	void PersistentGraph<KeyType, DataType, Traits, ChunkSize>::clear()
+	{
+		//snapshots taken before keep their chunks
+		slots.clear();
+		buckets.clear();
+		bucket_base = 0;
+		bucket_split = 0;
+		free_head = invalid_id;
+		num_nodes = 0;
+		num_edges = 0;
+	}
+
+} // end namespace YAGL
+
+#endif
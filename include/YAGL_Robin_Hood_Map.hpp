@@ -0,0 +1,578 @@
+#ifndef YAGL_ROBIN_HOOD_MAP_HPP
+#define YAGL_ROBIN_HOOD_MAP_HPP
+
+#pragma once
+
+#include <algorithm> // for fill
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for hash and equal_to
+#include <iterator>
+#include <memory> // for unique_ptr
+#include <new> // for placement new and launder
+#include <stdexcept> // for length_error
+#include <tuple> // for forward_as_tuple
+#include <type_traits>
+#include <utility> // for pair
+
+namespace YAGL
+{
+	// Motivation: std::unordered_map allocates one heap node per element and
+	// 						 chases a pointer per lookup. An open addressing table keeps
+	// 						 every element in one flat array, and Robin Hood probing
+	// 						 (elements closer to home give way to those further away)
+	// 						 keeps probe sequences short even at high load.
+	//
+	// NOTE: 			 iterator and reference stability is weaker than for
+	// 						 std::unordered_map:
+	// 						 - any insertion may move every element, so all iterators
+	// 						   and references are invalidated
+	// 						 - erasing shifts the following elements of the probe run
+	// 						   back by one, so iterators and references to any element
+	// 						   are invalidated, erase while iterating is not supported
+	// 						 - lookups, assignment to mapped values and iteration never
+	// 						   invalidate anything
+	// 						 a probe run is at most 255 slots long, a hash that gives
+	// 						 more keys than that the same value makes try_emplace throw
+	// 						 std::length_error, no table size would separate them
+	template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class RobinHoodMap
+	{
+		public:
+			using key_type = Key;
+			using mapped_type = T;
+			using value_type = std::pair<const Key, T>;
+			using size_type = std::size_t;
+			using difference_type = std::ptrdiff_t;
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+			using reference = value_type&;
+			using const_reference = const value_type&;
+
+		private:
+			// raw storage, an element only lives in a slot while its info byte is set
+			struct Slot
+			{
+				alignas(value_type) unsigned char bytes[sizeof(value_type)];
+
+				value_type* get() { return std::launder(reinterpret_cast<value_type*>(bytes)); }
+				const value_type* get() const { return std::launder(reinterpret_cast<const value_type*>(bytes)); }
+			};
+
+			template <bool IsConst>
+			class Iterator
+			{
+				friend class RobinHoodMap;
+				template <bool> friend class Iterator;
+
+				using slot_pointer = std::conditional_t<IsConst, const Slot*, Slot*>;
+
+				slot_pointer slot;
+				const std::uint8_t* info;
+				const std::uint8_t* info_end;
+
+				void skip()
+				{
+					while(info != info_end && *info == 0)
+					{
+						++info;
+						++slot;
+					}
+				}
+
+				public:
+					using iterator_category = std::forward_iterator_tag;
+					using value_type = typename RobinHoodMap::value_type;
+					using difference_type = std::ptrdiff_t;
+					using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+					using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+					Iterator() : slot(nullptr), info(nullptr), info_end(nullptr) {}
+
+					Iterator(slot_pointer s, const std::uint8_t* i, const std::uint8_t* e)
+					: slot(s), info(i), info_end(e)
+					{
+						skip();
+					}
+
+					// iterators convert to const_iterators
+					template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+					Iterator(const Iterator<WasConst>& b) : slot(b.slot), info(b.info), info_end(b.info_end) {}
+
+					reference operator*() const { return *slot->get(); }
+					pointer operator->() const { return slot->get(); }
+
+					Iterator& operator++()
+					{
+						++info;
+						++slot;
+						skip();
+						return *this;
+					}
+					Iterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }
+
+					bool operator==(const Iterator& b) const { return info == b.info; }
+					bool operator!=(const Iterator& b) const { return info != b.info; }
+			};
+
+		public:
+			using iterator = Iterator<false>;
+			using const_iterator = Iterator<true>;
+
+			RobinHoodMap();
+
+			RobinHoodMap(const RobinHoodMap& b);
+			RobinHoodMap(RobinHoodMap&& b) noexcept;
+
+			RobinHoodMap& operator=(const RobinHoodMap& b);
+			RobinHoodMap& operator=(RobinHoodMap&& b) noexcept;
+
+			~RobinHoodMap();
+
+			iterator begin();
+			iterator end();
+			const_iterator begin() const;
+			const_iterator end() const;
+
+			size_type size() const { return length; }
+			bool empty() const { return length == 0; }
+			size_type bucket_count() const { return capacity; }
+			float load_factor() const { return capacity ? static_cast<float>(length) / capacity : 0.0f; }
+
+			// NOTE: 			 clamped to [0.1, 0.95], open addressing needs empty slots
+			float max_load_factor() const { return max_load; }
+			void max_load_factor(float ml);
+
+			iterator find(const Key& key);
+			const_iterator find(const Key& key) const;
+			size_type count(const Key& key) const;
+
+			template <typename ... Args>
+			std::pair<iterator, bool> try_emplace(const Key& key, Args&& ... args);
+
+			template <typename M>
+			std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+
+			// like std::unordered_map an existing key is left untouched
+			template <typename M>
+			std::pair<iterator, bool> emplace(const Key& key, M&& obj);
+
+			T& operator[](const Key& key);
+
+			size_type erase(const Key& key);
+
+			void clear();
+
+			void reserve(size_type n);
+
+			// NOTE: 			 rehash(0) shrinks to the smallest table the load factor allows
+			void rehash(size_type n);
+
+		private:
+			static constexpr size_type npos = static_cast<size_type>(-1);
+			static constexpr size_type min_capacity = 8;
+			static constexpr std::uint8_t max_distance = 255;
+
+			std::unique_ptr<Slot[]> slots;
+			std::unique_ptr<std::uint8_t[]> info; // 0 is empty, otherwise probe distance + 1
+			size_type capacity;
+			size_type length;
+			float max_load;
+			unsigned shift;
+			Hash hash;
+			KeyEqual equal;
+
+			// fibonacci hashing spreads poor hashes like the identity over the table
+			size_type home(const Key& key) const
+			{
+				return static_cast<size_type>((static_cast<std::uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+			}
+
+			size_type find_index(const Key& key) const;
+
+			// places a new element, returns npos when the table is too full or
+			// the probe run too long, nothing is moved in that case
+			template <typename ... Args>
+			size_type place(const Key& key, Args&& ... args);
+
+			// how many elements hash to the same value as key
+			size_type count_same_hash(const Key& key) const;
+
+			void allocate(size_type n);
+			void destroy_all();
+	};
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::RobinHoodMap()
+	: capacity(0), length(0), max_load(0.8f), shift(64)
+	{
+
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::RobinHoodMap(const RobinHoodMap& b)
+	: capacity(0), length(0), max_load(b.max_load), shift(64), hash(b.hash), equal(b.equal)
+	{
+		if(b.capacity == 0) return;
+
+		//same table size keeps every element at the same index
+		allocate(b.capacity);
+		for(size_type i = 0; i < capacity; i++)
+		{
+			if(b.info[i])
+			{
+				new (slots[i].bytes) value_type(*b.slots[i].get());
+				info[i] = b.info[i];
+			}
+		}
+		length = b.length;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::RobinHoodMap(RobinHoodMap&& b) noexcept
+	: slots(std::move(b.slots)), info(std::move(b.info)), capacity(b.capacity), length(b.length),
+		max_load(b.max_load), shift(b.shift), hash(std::move(b.hash)), equal(std::move(b.equal))
+	{
+		b.capacity = 0;
+		b.length = 0;
+		b.shift = 64;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>& RobinHoodMap<Key, T, Hash, KeyEqual>::operator=(const RobinHoodMap& b)
+	{
+		if(this != &b)
+		{
+			RobinHoodMap tmp(b);
+			*this = std::move(tmp);
+		}
+		return *this;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>& RobinHoodMap<Key, T, Hash, KeyEqual>::operator=(RobinHoodMap&& b) noexcept
+	{
+		if(this != &b)
+		{
+			destroy_all();
+			slots = std::move(b.slots);
+			info = std::move(b.info);
+			capacity = b.capacity;
+			length = b.length;
+			max_load = b.max_load;
+			shift = b.shift;
+			hash = std::move(b.hash);
+			equal = std::move(b.equal);
+			b.capacity = 0;
+			b.length = 0;
+			b.shift = 64;
+		}
+		return *this;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::~RobinHoodMap()
+	{
+		destroy_all();
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator RobinHoodMap<Key, T, Hash, KeyEqual>::begin()
+	{
+		return iterator(slots.get(), info.get(), info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator RobinHoodMap<Key, T, Hash, KeyEqual>::end()
+	{
+		return iterator(slots.get() + capacity, info.get() + capacity, info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::const_iterator RobinHoodMap<Key, T, Hash, KeyEqual>::begin() const
+	{
+		return const_iterator(slots.get(), info.get(), info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::const_iterator RobinHoodMap<Key, T, Hash, KeyEqual>::end() const
+	{
+		return const_iterator(slots.get() + capacity, info.get() + capacity, info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::max_load_factor(float ml)
+	{
+		max_load = ml < 0.1f ? 0.1f : (ml > 0.95f ? 0.95f : ml);
+		if(length > capacity * max_load) rehash(0);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::size_type
+	RobinHoodMap<Key, T, Hash, KeyEqual>::find_index(const Key& key) const
+	{
+		if(capacity == 0) return npos;
+
+		auto mask = capacity - 1;
+		auto i = home(key);
+		//an element further along is never closer to home than we are, once
+		//we pass a slot with a shorter distance the key can't be in the table
+		for(size_type dist = 1; info[i] >= dist; dist++)
+		{
+			if(info[i] == dist && equal(slots[i].get()->first, key)) return i;
+			i = (i + 1) & mask;
+		}
+		return npos;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator RobinHoodMap<Key, T, Hash, KeyEqual>::find(const Key& key)
+	{
+		auto i = find_index(key);
+		if(i == npos) return end();
+		return iterator(slots.get() + i, info.get() + i, info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::const_iterator
+	RobinHoodMap<Key, T, Hash, KeyEqual>::find(const Key& key) const
+	{
+		auto i = find_index(key);
+		if(i == npos) return end();
+		return const_iterator(slots.get() + i, info.get() + i, info.get() + capacity);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::size_type
+	RobinHoodMap<Key, T, Hash, KeyEqual>::count(const Key& key) const
+	{
+		return find_index(key) == npos ? 0 : 1;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	template <typename ... Args>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::size_type
+	RobinHoodMap<Key, T, Hash, KeyEqual>::place(const Key& key, Args&& ... args)
+	{
+		if(capacity == 0 || length + 1 > capacity * max_load) return npos;
+
+		auto mask = capacity - 1;
+		auto i = home(key);
+		size_type dist = 1;
+
+		//walk past everything that is at least as far from home as we are
+		while(info[i] >= dist)
+		{
+			i = (i + 1) & mask;
+			if(++dist > max_distance) return npos;
+		}
+
+		//the rest of the run moves up one slot to make room
+		auto j = i;
+		while(info[j] != 0)
+		{
+			if(info[j] == max_distance) return npos;
+			j = (j + 1) & mask;
+		}
+		while(j != i)
+		{
+			auto prev = (j - 1) & mask;
+			new (slots[j].bytes) value_type(std::move(*slots[prev].get()));
+			slots[prev].get()->~value_type();
+			info[j] = info[prev] + 1;
+			j = prev;
+		}
+
+		new (slots[i].bytes) value_type(std::piecewise_construct,
+				std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		info[i] = static_cast<std::uint8_t>(dist);
+		length++;
+		return i;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	template <typename ... Args>
+	std::pair<typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator, bool>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::try_emplace(const Key& key, Args&& ... args)
+	{
+		auto i = find_index(key);
+		if(i != npos)
+			return {iterator(slots.get() + i, info.get() + i, info.get() + capacity), false};
+
+		while((i = place(key, std::forward<Args>(args)...)) == npos)
+		{
+			//keys with equal hashes share a home at every size, growing can only
+			//make room for a run that is long because of its neighbors
+			if(count_same_hash(key) >= max_distance)
+				throw std::length_error("RobinHoodMap: too many keys hash to the same slot");
+			rehash(capacity ? 2 * capacity : min_capacity);
+		}
+		return {iterator(slots.get() + i, info.get() + i, info.get() + capacity), true};
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	template <typename M>
+	std::pair<typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator, bool>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::insert_or_assign(const Key& key, M&& obj)
+	{
+		auto i = find_index(key);
+		if(i != npos)
+		{
+			slots[i].get()->second = std::forward<M>(obj);
+			return {iterator(slots.get() + i, info.get() + i, info.get() + capacity), false};
+		}
+		return try_emplace(key, std::forward<M>(obj));
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	template <typename M>
+	std::pair<typename RobinHoodMap<Key, T, Hash, KeyEqual>::iterator, bool>
+	RobinHoodMap<Key, T, Hash, KeyEqual>::emplace(const Key& key, M&& obj)
+	{
+		return try_emplace(key, std::forward<M>(obj));
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	T& RobinHoodMap<Key, T, Hash, KeyEqual>::operator[](const Key& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::size_type
+	RobinHoodMap<Key, T, Hash, KeyEqual>::erase(const Key& key)
+	{
+		auto i = find_index(key);
+		if(i == npos) return 0;
+
+		slots[i].get()->~value_type();
+		info[i] = 0;
+
+		//backward shift, pull the rest of the run one slot closer to home
+		auto mask = capacity - 1;
+		auto next = (i + 1) & mask;
+		while(info[next] > 1)
+		{
+			new (slots[i].bytes) value_type(std::move(*slots[next].get()));
+			slots[next].get()->~value_type();
+			info[i] = info[next] - 1;
+			info[next] = 0;
+			i = next;
+			next = (next + 1) & mask;
+		}
+		length--;
+		return 1;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::clear()
+	{
+		for(size_type i = 0; i < capacity; i++)
+		{
+			if(info[i])
+			{
+				slots[i].get()->~value_type();
+				info[i] = 0;
+			}
+		}
+		length = 0;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::reserve(size_type n)
+	{
+		auto needed = static_cast<size_type>(n / max_load) + 1;
+		if(needed > capacity) rehash(needed);
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::rehash(size_type n)
+	{
+		auto needed = static_cast<size_type>(length / max_load) + 1;
+		if(n < needed) n = needed;
+
+		size_type new_capacity = min_capacity;
+		while(new_capacity < n) new_capacity *= 2;
+
+		//an empty table gives back all of its memory
+		if(length == 0 && n <= min_capacity && capacity != 0)
+		{
+			destroy_all();
+			slots.reset();
+			info.reset();
+			capacity = 0;
+			shift = 64;
+			return;
+		}
+		if(new_capacity == capacity) return;
+
+		auto old_slots = std::move(slots);
+		auto old_info = std::move(info);
+		auto old_capacity = capacity;
+
+		allocate(new_capacity);
+		length = 0;
+		for(size_type i = 0; i < old_capacity; i++)
+		{
+			if(old_info[i])
+			{
+				auto& value = *old_slots[i].get();
+				//a shrink can lengthen probe runs past what info holds, the new
+				//table grows with what it has so far until the element fits,
+				//at the old size everything did
+				while(place(value.first, std::move(value.second)) == npos)
+				{
+					rehash(2 * capacity);
+				}
+				value.~value_type();
+			}
+		}
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	typename RobinHoodMap<Key, T, Hash, KeyEqual>::size_type
+	RobinHoodMap<Key, T, Hash, KeyEqual>::count_same_hash(const Key& key) const
+	{
+		if(capacity == 0) return 0;
+
+		//they all sit in the run from their home, at their own distance
+		auto value = hash(key);
+		auto mask = capacity - 1;
+		auto i = home(key);
+		size_type n = 0;
+		for(size_type dist = 1; dist <= max_distance && info[i] >= dist; dist++)
+		{
+			if(info[i] == dist && hash(slots[i].get()->first) == value) n++;
+			i = (i + 1) & mask;
+		}
+		return n;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::allocate(size_type n)
+	{
+		slots.reset(new Slot[n]);
+		info.reset(new std::uint8_t[n]());
+		capacity = n;
+
+		shift = 64;
+		for(auto c = n; c > 1; c >>= 1) shift--;
+	}
+
+	template <typename Key, typename T, typename Hash, typename KeyEqual>
+	void RobinHoodMap<Key, T, Hash, KeyEqual>::destroy_all()
+	{
+		if(!std::is_trivially_destructible_v<value_type>)
+		{
+			for(size_type i = 0; i < capacity; i++)
+			{
+				if(info[i]) slots[i].get()->~value_type();
+			}
+		}
+		if(capacity) std::fill(info.get(), info.get() + capacity, std::uint8_t(0));
+		length = 0;
+	}
+
+} // end namespace YAGL
+
+#endif
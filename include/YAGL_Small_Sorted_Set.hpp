@@ -0,0 +1,201 @@
+#ifndef YAGL_SMALL_SORTED_SET_HPP
+#define YAGL_SMALL_SORTED_SET_HPP
+
+#pragma once
+
+#include <algorithm> // for lower_bound and copy
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility> // for pair
+
+namespace YAGL
+{
+	// Motivation: most nodes in our graphs have a handful of neighbors, a hash
+	// 						 set pays for buckets and one heap node per element to hold
+	// 						 them. A sorted array with room for N elements inline keeps
+	// 						 small neighborhoods inside the adjacency entry itself and
+	// 						 only spills to the heap once it outgrows that buffer.
+	//
+	// NOTE: 			 the elements must be trivially copyable, this is meant for ids.
+	// 						 Inserting or erasing invalidates iterators, like a vector
+	template <typename T, std::size_t N>
+	class SmallSortedSet
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SmallSortedSet only holds trivially copyable types");
+		static_assert(N > 0, "SmallSortedSet needs room for at least one inline element");
+
+		public:
+			using value_type = T;
+			using key_type = T;
+			using size_type = std::size_t;
+			using iterator = const T*;
+			using const_iterator = const T*;
+
+			SmallSortedSet() : length(0), capacity(N) {}
+
+			SmallSortedSet(const SmallSortedSet& b) : length(0), capacity(N)
+			{
+				reserve(b.length);
+				std::copy(b.begin(), b.end(), data());
+				length = b.length;
+			}
+
+			SmallSortedSet(SmallSortedSet&& b) noexcept : length(0), capacity(N)
+			{
+				steal(b);
+			}
+
+			SmallSortedSet& operator=(const SmallSortedSet& b)
+			{
+				if(this != &b)
+				{
+					length = 0;
+					reserve(b.length);
+					std::copy(b.begin(), b.end(), data());
+					length = b.length;
+				}
+				return *this;
+			}
+
+			SmallSortedSet& operator=(SmallSortedSet&& b) noexcept
+			{
+				if(this != &b)
+				{
+					release();
+					steal(b);
+				}
+				return *this;
+			}
+
+			~SmallSortedSet() { release(); }
+
+			const_iterator begin() const { return data(); }
+			const_iterator end() const { return data() + length; }
+
+			size_type size() const { return length; }
+			bool empty() const { return length == 0; }
+
+			// elements live in the object until the set grows past N
+			bool is_inline() const { return capacity == N; }
+
+			const_iterator find(const T& value) const
+			{
+				auto iter = std::lower_bound(begin(), end(), value);
+				if(iter != end() && *iter == value) return iter;
+				return end();
+			}
+
+			size_type count(const T& value) const
+			{
+				return find(value) != end() ? 1 : 0;
+			}
+
+			std::pair<const_iterator, bool> insert(const T& value)
+			{
+				auto iter = std::lower_bound(begin(), end(), value);
+				if(iter != end() && *iter == value) return {iter, false};
+
+				auto pos = iter - begin();
+				if(length == capacity) grow(2 * capacity);
+
+				//shift the tail up by one to keep the order
+				T* d = data();
+				std::copy_backward(d + pos, d + length, d + length + 1);
+				d[pos] = value;
+				length++;
+				return {d + pos, true};
+			}
+
+			size_type erase(const T& value)
+			{
+				auto iter = find(value);
+				if(iter == end()) return 0;
+
+				T* d = data();
+				auto pos = iter - begin();
+				std::copy(d + pos + 1, d + length, d + pos);
+				length--;
+				return 1;
+			}
+
+			void clear() { length = 0; }
+
+			void reserve(size_type n)
+			{
+				if(n > capacity) grow(n);
+			}
+
+			// moves a spilled set back inline when it fits, or trims the heap block
+			void shrink_to_fit()
+			{
+				if(is_inline() || length == capacity) return;
+
+				T* old = storage.heap;
+				if(length <= N)
+				{
+					std::copy(old, old + length, storage.local);
+					capacity = N;
+				}
+				else
+				{
+					T* block = new T[length];
+					std::copy(old, old + length, block);
+					storage.heap = block;
+					capacity = length;
+				}
+				delete[] old;
+			}
+
+		private:
+			std::uint32_t length;
+			std::uint32_t capacity;
+
+			union Storage
+			{
+				T local[N];
+				T* heap;
+
+				Storage() : heap(nullptr) {}
+			} storage;
+
+			T* data() { return is_inline() ? storage.local : storage.heap; }
+			const T* data() const { return is_inline() ? storage.local : storage.heap; }
+
+			void grow(size_type n)
+			{
+				T* block = new T[n];
+				std::copy(begin(), end(), block);
+				if(!is_inline()) delete[] storage.heap;
+				storage.heap = block;
+				capacity = static_cast<std::uint32_t>(n);
+			}
+
+			void release()
+			{
+				if(!is_inline()) delete[] storage.heap;
+				length = 0;
+				capacity = N;
+			}
+
+			void steal(SmallSortedSet& b)
+			{
+				if(b.is_inline())
+				{
+					std::copy(b.begin(), b.end(), storage.local);
+					capacity = N;
+				}
+				else
+				{
+					storage.heap = b.storage.heap;
+					capacity = b.capacity;
+					b.capacity = N;
+				}
+				length = b.length;
+				b.length = 0;
+			}
+	};
+
+} // end namespace YAGL
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef YAGL_THREAD_POOL_HPP
+#define YAGL_THREAD_POOL_HPP
+
+#pragma once
+
+#include <algorithm> // for min and max
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace YAGL
+{
+	// Motivation: independent pieces of work, like the search trees of the
+	// 						 root candidates of a match, are rarely the same size. A
+	// 						 static split leaves threads idle while one finishes a
+	// 						 heavy share, so every worker owns a queue of chunks and
+	// 						 steals from the others once its own runs dry.
+	//
+	// NOTE: 			 the workers live as long as the pool, the calling thread
+	// 						 joins in as worker 0 so a pool of one runs serially.
+	// 						 A pool runs one parallel_for at a time
+	class ThreadPool
+	{
+		public:
+			// zero picks the hardware concurrency
+			explicit ThreadPool(std::size_t num_threads = 0);
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			~ThreadPool();
+
+			std::size_t size() const { return num_workers; }
+
+			// splits [0, n) into chunks of at most grain items and calls
+			// fn(worker, begin, end) for each of them, blocks until all are done.
+			// The first exception thrown by fn is rethrown here
+			template <typename Fn>
+			void parallel_for(std::size_t n, std::size_t grain, Fn&& fn);
+
+		private:
+			// a worker's chunks, the owner takes from the front and thieves from
+			// the back so they rarely contend for the same end
+			struct alignas(64) ChunkQueue
+			{
+				std::mutex lock;
+				std::size_t first = 0;
+				std::size_t last = 0;
+			};
+
+			std::size_t num_workers;
+			std::vector<std::thread> threads;
+			std::unique_ptr<ChunkQueue[]> queues;
+
+			std::mutex lock;
+			std::condition_variable start;
+			std::condition_variable done;
+			std::function<void(std::size_t)> job;
+			std::size_t generation = 0;
+			std::size_t pending = 0;
+			bool stopping = false;
+
+			std::exception_ptr failure;
+
+			void work(std::size_t worker);
+			bool take_own(std::size_t worker, std::size_t& chunk);
+			bool steal(std::size_t worker, std::size_t& chunk);
+	};
+
+	inline ThreadPool::ThreadPool(std::size_t num_threads)
+	: num_workers(num_threads ? num_threads : std::max<std::size_t>(1, std::thread::hardware_concurrency())),
+		queues(new ChunkQueue[num_workers])
+	{
+		for(std::size_t worker = 1; worker < num_workers; worker++)
+		{
+			threads.emplace_back(&ThreadPool::work, this, worker);
+		}
+	}
+
+	inline ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+		}
+		start.notify_all();
+		for(auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	inline void ThreadPool::work(std::size_t worker)
+	{
+		std::size_t seen = 0;
+		while(true)
+		{
+			std::function<void(std::size_t)> current;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				start.wait(guard, [&] { return stopping || generation != seen; });
+				if(stopping) return;
+				seen = generation;
+				current = job;
+			}
+
+			current(worker);
+
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				pending--;
+			}
+			done.notify_one();
+		}
+	}
+
+	inline bool ThreadPool::take_own(std::size_t worker, std::size_t& chunk)
+	{
+		auto& queue = queues[worker];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if(queue.first == queue.last) return false;
+		chunk = queue.first++;
+		return true;
+	}
+
+	inline bool ThreadPool::steal(std::size_t worker, std::size_t& chunk)
+	{
+		//walk the other queues starting from the next worker over
+		for(std::size_t i = 1; i < num_workers; i++)
+		{
+			auto& queue = queues[(worker + i) % num_workers];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if(queue.first != queue.last)
+			{
+				chunk = --queue.last;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <typename Fn>
+	void ThreadPool::parallel_for(std::size_t n, std::size_t grain, Fn&& fn)
+	{
+		if(n == 0) return;
+		grain = std::max<std::size_t>(grain, 1);
+		auto num_chunks = (n + grain - 1) / grain;
+
+		//every worker starts out with a contiguous share of the chunks
+		auto share = (num_chunks + num_workers - 1) / num_workers;
+		for(std::size_t worker = 0; worker < num_workers; worker++)
+		{
+			queues[worker].first = std::min(num_chunks, worker * share);
+			queues[worker].last = std::min(num_chunks, (worker + 1) * share);
+		}
+		failure = nullptr;
+
+		std::mutex failure_lock;
+		auto body = [&](std::size_t worker)
+		{
+			std::size_t chunk;
+			while(take_own(worker, chunk) || steal(worker, chunk))
+			{
+				try
+				{
+					fn(worker, chunk * grain, std::min(n, (chunk + 1) * grain));
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> guard(failure_lock);
+					if(!failure) failure = std::current_exception();
+				}
+			}
+		};
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			job = body;
+			pending = num_workers - 1;
+			generation++;
+		}
+		start.notify_all();
+
+		body(0);
+
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			done.wait(guard, [&] { return pending == 0; });
+			job = nullptr;
+		}
+
+		if(failure) std::rethrow_exception(failure);
+	}
+
+} // end namespace YAGL
+
+#endif
@@ -2,12 +2,20 @@
 
 #include "catch.hpp"
 #include "YAGL_Graph.hpp"
+#include "YAGL_Persistent_Graph.hpp"
+#include "YAGL_Concurrent_Graph.hpp"
+#include "YAGL_Thread_Pool.hpp"
 #include <vector>
 #include <type_traits>
 #include <chrono>
 #include <iostream>
 
 #include <unordered_map>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <memory_resource>
+#include <thread>
 
 using namespace std::chrono;
 
@@ -31,8 +39,8 @@ TEST_CASE("graph insertion and copy performance test", "[graph_performance_test]
     }
     
     for(auto i = 0; i < num_adds - 1; i++) {
-        auto node_a = graph_perf.findNode(i)->second;
-        auto node_b = graph_perf.findNode(i+1)->second;
+        const auto& node_a = graph_perf.findNode(i)->second;
+        const auto& node_b = graph_perf.findNode(i+1)->second;
         graph_perf.addEdge(node_a, node_b);
     }
     auto stop = high_resolution_clock::now();
@@ -81,3 +89,551 @@ TEST_CASE("graph insertion and copy performance test", "[graph_performance_test]
 
 
 }
+
+template <typename GraphType>
+void time_chain_graph(const std::string& label, std::size_t num_adds)
+{
+    using node_type = typename GraphType::node_type;
+
+    GraphType graph;
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << label << ": inserting " << num_adds << " nodes and " << num_adds - 1 << " edges...\n";
+    auto start = high_resolution_clock::now();
+    for(auto i = 0; i < num_adds; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    for(auto i = 0; i < num_adds - 1; i++) {
+        graph.addEdge(i, i+1);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(stop-start);
+    std::cout << "Time taken: " << duration.count() << " milliseconds\n";
+    
+    std::cout << label << ": checking " << num_adds - 1 << " adjacencies and degrees...\n";
+    std::size_t found = 0, degree_sum = 0;
+    start = high_resolution_clock::now();
+    for(auto i = 0; i < num_adds - 1; i++) {
+        found += graph.adjacent(i, i+1);
+        degree_sum += graph.out_degree(graph.findNode(i)->second);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<milliseconds>(stop-start);
+    std::cout << "Time taken: " << duration.count() << " milliseconds\n";
+    std::cout << "--------------------------------------------------\n";
+
+    REQUIRE(graph.numEdges() == num_adds - 1);
+    REQUIRE(found == num_adds - 1);
+    REQUIRE(degree_sum == 2*(num_adds - 1) - 1);
+}
+
+TEST_CASE("graph neighbor storage policy performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+
+    std::size_t num_adds = 500'000;
+    
+    time_chain_graph<YAGL::Graph<key_type, data_type>>("Hash set neighbors", num_adds);
+    time_chain_graph<YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<4>>>("Small sorted neighbors", num_adds);
+}
+
+TEST_CASE("graph heavy payload insertion performance test", "[graph_performance_test]")
+{
+    // payloads carrying a position history like our simulation nodes
+    using key_type = int; using data_type = std::vector<double>;
+    using node_type = YAGL::Node<key_type, data_type>;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    std::size_t num_adds = 100'000;
+    std::size_t payload = 64;
+
+    auto report = [](const std::string& label, auto start, auto stop) {
+        auto duration = duration_cast<milliseconds>(stop-start);
+        std::cout << label << " time taken: " << duration.count() << " milliseconds\n";
+    };
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Inserting " << num_adds << " nodes with " << payload << " doubles each...\n";
+    
+    // each graph is torn down before the next so they all start from the same heap
+    {
+        graph_type copied;
+        auto start = high_resolution_clock::now();
+        for(auto i = 0; i < num_adds; i++) {
+            node_type n(i, data_type(payload, i*1.1));
+            copied.addNode(n);
+        }
+        report("Copy", start, high_resolution_clock::now());
+        REQUIRE(copied.numNodes() == num_adds);
+    }
+    {
+        graph_type moved;
+        auto start = high_resolution_clock::now();
+        for(auto i = 0; i < num_adds; i++) {
+            moved.addNode(node_type(i, data_type(payload, i*1.1)));
+        }
+        report("Move", start, high_resolution_clock::now());
+        REQUIRE(moved.numNodes() == num_adds);
+    }
+    
+    graph_type emplaced;
+    auto start = high_resolution_clock::now();
+    for(auto i = 0; i < num_adds; i++) {
+        emplaced.emplaceNode(i, payload, i*1.1);
+    }
+    report("Emplace", start, high_resolution_clock::now());
+
+    start = high_resolution_clock::now();
+    for(auto i = 0; i < num_adds - 1; i++) {
+        emplaced.addEdge(emplaced.findNode(i)->second, emplaced.findNode(i+1)->second);
+    }
+    report("Edge insertion by node", start, high_resolution_clock::now());
+    std::cout << "--------------------------------------------------\n";
+
+    REQUIRE(emplaced.numNodes() == num_adds);
+    REQUIRE(emplaced.numEdges() == num_adds - 1);
+    REQUIRE(emplaced[7].size() == payload);
+}
+
+TEST_CASE("graph bulk load performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using node_type = YAGL::Node<key_type, data_type>;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    std::size_t num_nodes = 200'000;
+    std::size_t num_edges = 1'000'000;
+
+    // a random sparse graph, like a checkpoint would hold
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<key_type> dist(0, num_nodes - 1);
+    
+    std::vector<node_type> nodes;
+    nodes.reserve(num_nodes);
+    for(auto i = 0; i < num_nodes; i++) nodes.emplace_back(i, i*1.1);
+    
+    std::vector<std::pair<key_type, key_type>> edges;
+    edges.reserve(num_edges);
+    for(auto i = 0; i < num_edges; i++) edges.emplace_back(dist(gen), dist(gen));
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Loading " << num_nodes << " nodes and " << num_edges << " edges...\n";
+    
+    std::size_t edges_single = 0;
+    {
+        graph_type graph;
+        auto start = high_resolution_clock::now();
+        for(auto& n : nodes) graph.addNode(n);
+        for(auto& [a, b] : edges) graph.addEdge(a, b);
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<milliseconds>(stop-start);
+        std::cout << "addNode/addEdge time taken: " << duration.count() << " milliseconds\n";
+        edges_single = graph.numEdges();
+    }
+    
+    graph_type graph;
+    auto start = high_resolution_clock::now();
+    graph.bulk_load(nodes, edges);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(stop-start);
+    std::cout << "bulk_load time taken: " << duration.count() << " milliseconds\n";
+    std::cout << "--------------------------------------------------\n";
+
+    REQUIRE(graph.numNodes() == num_nodes);
+    REQUIRE(graph.numEdges() == edges_single);
+}
+
+template <typename GraphType>
+double time_reserved_insertion(std::size_t num_adds, bool reserve)
+{
+    using node_type = typename GraphType::node_type;
+
+    GraphType graph;
+    
+    auto start = high_resolution_clock::now();
+    if(reserve)
+    {
+        graph.reserve_nodes(num_adds);
+        graph.reserve_edges(num_adds - 1);
+    }
+    for(auto i = 0; i < num_adds; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    for(auto i = 0; i < num_adds - 1; i++) {
+        graph.addEdge(i, i+1);
+    }
+    auto stop = high_resolution_clock::now();
+
+    REQUIRE(graph.numNodes() == num_adds);
+    REQUIRE(graph.numEdges() == num_adds - 1);
+    
+    return duration_cast<duration<double, std::milli>>(stop-start).count();
+}
+
+TEST_CASE("graph reserved insertion performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using small_graph_type = YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<4>>;
+
+    std::size_t num_adds = 500'000;
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Inserting " << num_adds << " nodes and " << num_adds - 1 << " edges...\n";
+    
+    auto plain = time_reserved_insertion<graph_type>(num_adds, false);
+    auto reserved = time_reserved_insertion<graph_type>(num_adds, true);
+    std::cout << "Hash set neighbors without reserve: " << plain << " milliseconds, " 
+        << num_adds / plain << " nodes/ms\n";
+    std::cout << "Hash set neighbors with reserve: " << reserved << " milliseconds, " 
+        << num_adds / reserved << " nodes/ms\n";
+    
+    plain = time_reserved_insertion<small_graph_type>(num_adds, false);
+    reserved = time_reserved_insertion<small_graph_type>(num_adds, true);
+    std::cout << "Small sorted neighbors without reserve: " << plain << " milliseconds, " 
+        << num_adds / plain << " nodes/ms\n";
+    std::cout << "Small sorted neighbors with reserve: " << reserved << " milliseconds, " 
+        << num_adds / reserved << " nodes/ms\n";
+    std::cout << "--------------------------------------------------\n";
+}
+
+template <typename GraphType>
+void time_map_backend(const std::string& label, std::size_t num_adds)
+{
+    using node_type = typename GraphType::node_type;
+
+    GraphType graph;
+    
+    auto start = high_resolution_clock::now();
+    for(auto i = 0; i < num_adds; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    auto stop = high_resolution_clock::now();
+    auto insert_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    //hit every key once and miss once per key, in a random order
+    std::vector<int> keys(num_adds);
+    for(auto i = 0; i < num_adds; i++) keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(1234));
+
+    std::size_t found = 0;
+    start = high_resolution_clock::now();
+    for(auto k : keys) {
+        if(graph.findNode(k) != graph.node_list_end()) found++;
+        if(graph.findNode(k + num_adds) != graph.node_list_end()) found++;
+    }
+    stop = high_resolution_clock::now();
+    auto lookup_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(found == num_adds);
+
+    start = high_resolution_clock::now();
+    GraphType copy_graph = graph;
+    stop = high_resolution_clock::now();
+    auto copy_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(copy_graph.numNodes() == num_adds);
+
+    std::cout << label << " insert: " << insert_time << " ms, lookup: " 
+        << lookup_time << " ms, copy: " << copy_time << " ms\n";
+}
+
+TEST_CASE("graph key map backend performance test", "[graph_performance_test]")
+{
+    std::size_t num_adds = 1000000;
+    
+    std::cout << "Comparing key map backends for " << num_adds << " nodes\n";
+    time_map_backend<YAGL::Graph<int, double>>("std::unordered_map", num_adds);
+    time_map_backend<YAGL::Graph<int, double, YAGL::RobinHoodGraphTraits>>("Robin Hood map", num_adds);
+    std::cout << "--------------------------------------------------\n";
+}
+
+TEST_CASE("graph degree statistics performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    std::size_t num_nodes = 200'000;
+    std::size_t num_edges = 1'000'000;
+
+    graph_type graph;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<key_type> pick(0, num_nodes - 1);
+
+    //the histogram is kept up to date by every insertion
+    auto start = high_resolution_clock::now();
+    for(auto i = 0; i < num_nodes; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    for(auto i = 0; i < num_edges; i++) {
+        graph.addEdge(pick(gen), pick(gen));
+    }
+    auto stop = high_resolution_clock::now();
+    auto insert_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    //min, max and average used to scan every node each
+    std::size_t num_queries = 10'000;
+    double checksum = 0;
+    start = high_resolution_clock::now();
+    for(auto i = 0; i < num_queries; i++) {
+        checksum += graph.min_degree() + graph.max_degree() + graph.avg_degree();
+    }
+    stop = high_resolution_clock::now();
+    auto query_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(checksum > 0);
+
+    start = high_resolution_clock::now();
+    std::size_t median = 0;
+    for(auto i = 0; i < num_queries; i++) {
+        median += graph.degree_percentile(0.5);
+    }
+    stop = high_resolution_clock::now();
+    auto percentile_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(median > 0);
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Inserting " << num_nodes << " nodes and " << num_edges << " random edges: " 
+        << insert_time << " milliseconds\n";
+    std::cout << num_queries << " min/max/avg degree queries: " << query_time << " milliseconds\n";
+    std::cout << num_queries << " median degree queries: " << percentile_time << " milliseconds\n";
+    std::cout << "--------------------------------------------------\n";
+}
+
+template <typename GraphType, typename SnapshotFn>
+void time_snapshots(const std::string& label, GraphType& graph, std::size_t num_adds, SnapshotFn snapshot)
+{
+    std::size_t num_snapshots = 10;
+    std::size_t edits_per_step = 1000;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> pick(0, num_adds - 1);
+
+    //a snapshot every step followed by a batch of edits to the live graph
+    std::vector<GraphType> history;
+    double snapshot_time = 0, edit_time = 0;
+    for(auto step = 0; step < num_snapshots; step++) {
+        auto start = high_resolution_clock::now();
+        history.push_back(snapshot(graph));
+        auto stop = high_resolution_clock::now();
+        snapshot_time += duration_cast<duration<double, std::milli>>(stop-start).count();
+
+        start = high_resolution_clock::now();
+        for(auto i = 0; i < edits_per_step; i++) {
+            graph.addEdge(pick(gen), pick(gen));
+        }
+        stop = high_resolution_clock::now();
+        edit_time += duration_cast<duration<double, std::milli>>(stop-start).count();
+    }
+    REQUIRE(history.front().numEdges() == num_adds - 1);
+
+    std::cout << label << " snapshot: " << snapshot_time / num_snapshots << " ms, " 
+        << edits_per_step << " edits after it: " << edit_time / num_snapshots << " ms\n";
+}
+
+TEST_CASE("graph snapshot performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using traits_type = YAGL::SmallNeighborTraits<4>;
+    using graph_type = YAGL::Graph<key_type, data_type, traits_type>;
+    using persistent_type = YAGL::PersistentGraph<key_type, data_type, traits_type>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    std::size_t num_adds = 500'000;
+
+    graph_type graph;
+    for(auto i = 0; i < num_adds; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    for(auto i = 1; i < num_adds; i++) {
+        graph.addEdge(i-1, i);
+    }
+    persistent_type persistent(graph);
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Snapshotting " << num_adds << " nodes and " << num_adds - 1 << " edges...\n";
+    time_snapshots("Graph copy", graph, num_adds, [](const graph_type& g) { return g; });
+    time_snapshots("Persistent graph", persistent, num_adds, [](const persistent_type& g) { return g; });
+    std::cout << "--------------------------------------------------\n";
+}
+
+template <typename GraphType>
+void build_scratch(GraphType& graph, std::size_t num_nodes, std::mt19937& gen)
+{
+    using node_type = typename GraphType::node_type;
+    std::uniform_int_distribution<int> pick(0, num_nodes - 1);
+
+    for(auto i = 0; i < num_nodes; i++) {
+        graph.addNode(node_type(i, i*1.1));
+    }
+    for(auto i = 0; i < 4 * num_nodes; i++) {
+        graph.addEdge(pick(gen), pick(gen));
+    }
+}
+
+TEST_CASE("graph arena allocation performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using pmr_graph_type = YAGL::Graph<key_type, data_type, YAGL::PmrGraphTraits>;
+
+    std::size_t num_rounds = 200;
+    std::size_t num_nodes = 2'000;
+
+    //many short lived scratch graphs, built and thrown away
+    std::mt19937 gen(99);
+    auto start = high_resolution_clock::now();
+    for(auto round = 0; round < num_rounds; round++) {
+        graph_type graph;
+        build_scratch(graph, num_nodes, gen);
+    }
+    auto stop = high_resolution_clock::now();
+    auto heap_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    gen.seed(99);
+    std::pmr::monotonic_buffer_resource arena;
+    start = high_resolution_clock::now();
+    for(auto round = 0; round < num_rounds; round++) {
+        {
+            pmr_graph_type graph(&arena);
+            build_scratch(graph, num_nodes, gen);
+        }
+        arena.release();
+    }
+    stop = high_resolution_clock::now();
+    auto arena_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    gen.seed(99);
+    std::pmr::unsynchronized_pool_resource pool;
+    start = high_resolution_clock::now();
+    for(auto round = 0; round < num_rounds; round++) {
+        pmr_graph_type graph(&pool);
+        build_scratch(graph, num_nodes, gen);
+    }
+    stop = high_resolution_clock::now();
+    auto pool_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Building and dropping " << num_rounds << " graphs of " << num_nodes << " nodes and " 
+        << 4 * num_nodes << " random edges...\n";
+    std::cout << "Global heap: " << heap_time << " milliseconds\n";
+    std::cout << "Monotonic arena: " << arena_time << " milliseconds\n";
+    std::cout << "Unsynchronized pool: " << pool_time << " milliseconds\n";
+    std::cout << "--------------------------------------------------\n";
+}
+
+TEST_CASE("graph concurrent insertion performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using node_type = YAGL::Node<key_type, data_type>;
+    using concurrent_type = YAGL::ConcurrentGraph<key_type, data_type>;
+
+    std::size_t num_nodes = 500'000;
+    std::size_t num_edges = 1'000'000;
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<key_type> pick(0, num_nodes - 1);
+    std::vector<std::pair<key_type, key_type>> edges(num_edges);
+    for(auto& edge : edges) edge = {pick(gen), pick(gen)};
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Inserting " << num_nodes << " nodes and " << num_edges << " random edges...\n";
+
+    //the plain graph on one thread is the baseline
+    auto start = high_resolution_clock::now();
+    YAGL::Graph<key_type, data_type> serial;
+    for(auto k = 0; k < num_nodes; k++) serial.addNode(node_type(k, k*1.1));
+    for(const auto& [a, b] : edges) serial.addEdge(a, b);
+    auto stop = high_resolution_clock::now();
+    auto serial_time = duration_cast<duration<double, std::milli>>(stop-start).count();
+    std::cout << "Graph, 1 thread: " << serial_time << " milliseconds\n";
+
+    std::vector<std::size_t> thread_counts{1, 2, 4};
+    auto hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    if(hardware > 4) thread_counts.push_back(hardware);
+
+    for(auto threads : thread_counts)
+    {
+        YAGL::ThreadPool pool(threads);
+        concurrent_type graph;
+
+        start = high_resolution_clock::now();
+        pool.parallel_for(num_nodes, 4096, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for(auto k = begin; k < end; k++) graph.addNode(node_type(k, k*1.1));
+        });
+        pool.parallel_for(num_edges, 4096, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for(auto i = begin; i < end; i++) graph.addEdge(edges[i].first, edges[i].second);
+        });
+        stop = high_resolution_clock::now();
+        auto time = duration_cast<duration<double, std::milli>>(stop-start).count();
+        REQUIRE(graph.numEdges() == serial.numEdges());
+
+        std::cout << "Concurrent graph, " << threads << " threads: " << time << " milliseconds, " 
+            << serial_time / time << "x the serial graph\n";
+    }
+    std::cout << "--------------------------------------------------\n";
+}
+
+TEST_CASE("graph batched mutation performance test", "[graph_performance_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    std::size_t num_nodes = 500'000;
+    std::size_t num_edges = 1'000'000;
+
+    YAGL::MutationBatch<key_type, data_type> build, edit;
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<key_type> pick(0, num_nodes - 1);
+    for(auto k = 0; k < num_nodes; k++) build.add_nodes.emplace_back(k, k*1.1);
+    for(auto i = 0; i < num_edges; i++) build.add_edges.emplace_back(pick(gen), pick(gen));
+    for(auto i = 0; i < num_edges / 4; i++) edit.remove_edges.emplace_back(pick(gen), pick(gen));
+    for(auto i = 0; i < num_nodes / 50; i++) edit.remove_nodes.push_back(pick(gen));
+    for(auto i = 0; i < num_edges / 4; i++) edit.add_edges.emplace_back(pick(gen), pick(gen));
+
+    //the same batches one call at a time
+    graph_type serial;
+    auto start = high_resolution_clock::now();
+    for(const auto& node : build.add_nodes) serial.addNode(node);
+    for(const auto& [a, b] : build.add_edges) serial.addEdge(a, b);
+    auto stop = high_resolution_clock::now();
+    auto serial_build = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    start = high_resolution_clock::now();
+    for(const auto& [a, b] : edit.remove_edges) serial.removeEdge(a, b);
+    for(const auto& key : edit.remove_nodes)
+        if(serial.findNode(key) != serial.node_list_end()) serial.removeNode(serial.findNode(key)->second);
+    for(const auto& [a, b] : edit.add_edges) serial.addEdge(a, b);
+    stop = high_resolution_clock::now();
+    auto serial_edit = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    graph_type batched;
+    start = high_resolution_clock::now();
+    batched.apply(build);
+    stop = high_resolution_clock::now();
+    auto batched_build = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    start = high_resolution_clock::now();
+    batched.apply(edit);
+    stop = high_resolution_clock::now();
+    auto batched_edit = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(batched.numEdges() == serial.numEdges());
+
+    YAGL::ThreadPool pool;
+    graph_type pooled;
+    start = high_resolution_clock::now();
+    pooled.apply(build, pool);
+    stop = high_resolution_clock::now();
+    auto pooled_build = duration_cast<duration<double, std::milli>>(stop-start).count();
+
+    start = high_resolution_clock::now();
+    pooled.apply(edit, pool);
+    stop = high_resolution_clock::now();
+    auto pooled_edit = duration_cast<duration<double, std::milli>>(stop-start).count();
+    REQUIRE(pooled.numEdges() == serial.numEdges());
+
+    std::cout << "\n--------------------------------------------------\n";
+    std::cout << "Building " << num_nodes << " nodes and " << num_edges << " random edges, then removing " 
+        << num_edges / 4 << " edges and " << num_nodes / 50 << " nodes and adding " << num_edges / 4 << " edges...\n";
+    std::cout << "One call at a time: " << serial_build << " + " << serial_edit << " milliseconds\n";
+    std::cout << "Batched: " << batched_build << " + " << batched_edit << " milliseconds\n";
+    std::cout << "Batched on " << pool.size() << " threads: " << pooled_build << " + " << pooled_edit << " milliseconds\n";
+    std::cout << "--------------------------------------------------\n";
+}
@@ -3,10 +3,12 @@
 #include <chrono>
 #include <iomanip> 
 #include <fstream> 
+#include <random>
 
 #include "catch.hpp"
 #include "YAGL_Graph.hpp"
 #include "YAGL_Algorithms.hpp"
+#include "YAGL_Incremental_Matcher.hpp"
 
 using data_type = struct DataType {std::size_t type;};
 using key_type = std::size_t;
@@ -149,3 +151,323 @@ TEST_CASE("subgraph iso performance test", "[subgraph_iso_performance_test]")
     write_results_matplotlib(runtimes, match_counts); 
 }
 
+
+TEST_CASE("subgraph iso engine performance test", "[subgraph_iso_engine_performance_test]")
+{
+    graph_type g1, g2;
+    
+    std::size_t n = 400'000;
+    scatter_3_segments(g1, 1);
+    scatter_3_segments(g2, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto keyed = YAGL::keyed_subgraph_isomorphism2(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> keyed_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto dense = YAGL::subgraph_isomorphism2(g1, g2);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> dense_ms = end - start;
+    
+    REQUIRE(keyed.size() == n);
+    REQUIRE(dense.size() == n);
+
+    std::cout << "Key based recursive matcher: " << std::fixed << std::setprecision(1) 
+        << keyed_ms.count() << "ms\n";
+    std::cout << "Dense id explicit stack matcher: " << dense_ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso parallel performance test", "[subgraph_iso_parallel_performance_test]")
+{
+    graph_type g1, g2;
+    
+    std::size_t n = 400'000;
+    scatter_3_segments(g1, 1);
+    scatter_3_segments(g2, n);
+
+    YAGL::ThreadPool pool;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    auto serial = YAGL::subgraph_isomorphism2(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> serial_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto parallel = YAGL::subgraph_isomorphism2(g1, g2, pool);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> parallel_ms = end - start;
+    
+    REQUIRE(serial.size() == n);
+    REQUIRE(parallel.size() == n);
+
+    std::cout << "Serial matcher: " << std::fixed << std::setprecision(1) << serial_ms.count() << "ms\n";
+    std::cout << "Parallel matcher on " << pool.size() << " threads: " << parallel_ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+template <typename GraphType>
+double time_rare_label_roots(std::size_t n)
+{
+    using node_type = typename GraphType::node_type;
+
+    GraphType g1, g2;
+    
+    //an edge pattern whose label shows up on 0.02% of the host, the labeled
+    //host nodes come in adjacent pairs
+    g1.addNode(node_type(0, {1}));
+    g1.addNode(node_type(1, {1}));
+    g1.addEdge(0, 1);
+
+    g2.reserve_nodes(n);
+    for(std::size_t i = 0; i < n; i++)
+        g2.addNode(node_type(i, {i % 10000 < 2 ? std::size_t(1) : std::size_t(0)}));
+    for(std::size_t i = 0; i + 1 < n; i++)
+        g2.addEdge(i, i+1);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    const auto end = std::chrono::high_resolution_clock::now();
+    
+    //each labeled pair matches both ways around
+    REQUIRE(results.size() == 2*(n/10000));
+    
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+TEST_CASE("subgraph iso label storage performance test", "[subgraph_iso_label_performance_test]")
+{
+    std::size_t n = 1'000'000;
+
+    auto payload = time_rare_label_roots<graph_type>(n);
+    auto column = time_rare_label_roots<YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<>>>(n);
+    auto index = time_rare_label_roots<YAGL::Graph<key_type, data_type, YAGL::LabelIndexTraits<>>>(n);
+    
+    std::cout << "Rare label roots on " << n << " nodes\n";
+    std::cout << "Labels read from payloads: " << std::fixed << std::setprecision(1) << payload << "ms\n";
+    std::cout << "Labels read from the column: " << column << "ms\n";
+    std::cout << "Labels looked up in the index: " << index << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso streaming performance test", "[subgraph_iso_streaming_performance_test]")
+{
+    graph_type g1, g2;
+    
+    std::size_t n = 400'000;
+    scatter_3_segments(g1, 1);
+    scatter_3_segments(g2, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> materialized_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto count = YAGL::subgraph_isomorphism2(g1, g2, [](const auto&) { return true; });
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> streamed_ms = end - start;
+    
+    REQUIRE(results.size() == n);
+    REQUIRE(count == n);
+
+    std::cout << "Matches materialized as maps: " << std::fixed << std::setprecision(1) 
+        << materialized_ms.count() << "ms\n";
+    std::cout << "Matches streamed to a visitor: " << streamed_ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso match set performance test", "[subgraph_iso_match_set_performance_test]")
+{
+    graph_type g1, g2;
+    
+    std::size_t n = 400'000;
+    scatter_3_segments(g1, 1);
+    scatter_3_segments(g2, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> maps_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto matches = YAGL::subgraph_match_set(g1, g2);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> set_ms = end - start;
+    
+    REQUIRE(results.size() == n);
+    REQUIRE(matches.size() == n);
+
+    std::cout << "Matches stored as a list of maps: " << std::fixed << std::setprecision(1) 
+        << maps_ms.count() << "ms\n";
+    std::cout << "Matches stored in a match set: " << set_ms.count() << "ms, "
+        << matches.data().capacity() * sizeof(key_type) / 1024 << "KiB of host keys\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso early stop performance test", "[subgraph_iso_early_stop_performance_test]")
+{
+    graph_type g1, g2;
+    
+    std::size_t n = 400'000;
+    scatter_3_segments(g1, 1);
+    scatter_3_segments(g2, n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> all_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto count = YAGL::count_matches(g1, g2);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> count_ms = end - start;
+    
+    start = std::chrono::high_resolution_clock::now();
+    auto exists = YAGL::match_exists(g1, g2);
+    auto first = YAGL::find_first_k(g1, g2, 10);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> first_ms = end - start;
+    
+    REQUIRE(results.size() == n);
+    REQUIRE(count == n);
+    REQUIRE(exists);
+    REQUIRE(first.size() == 10);
+
+    std::cout << "Enumerating every match: " << std::fixed << std::setprecision(1) << all_ms.count() << "ms\n";
+    std::cout << "Counting the matches: " << count_ms.count() << "ms\n";
+    std::cout << "Existence and the first 10 matches: " << first_ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso symmetry breaking performance test", "[subgraph_iso_symmetry_performance_test]")
+{
+    graph_type g1, g2;
+    
+    //triangles in a sparse random graph
+    g1.addNode({0, {0}}); g1.addNode({1, {0}}); g1.addNode({2, {0}});
+    g1.addEdge(0, 1); g1.addEdge(1, 2); g1.addEdge(2, 0);
+
+    std::size_t n = 200'000;
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    for(std::size_t i = 0; i < n; i++)
+        g2.addNode({i, {0}});
+    for(std::size_t e = 0; e < 4*n; e++)
+    {
+        auto a = pick(gen);
+        //mostly local edges so triangles close
+        auto b = (a + 1 + pick(gen) % 8) % n;
+        g2.addEdge(a, b);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto all = YAGL::count_matches(g1, g2);
+    auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> all_ms = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto distinct = YAGL::count_matches(g1, g2, YAGL::break_symmetry);
+    end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> distinct_ms = end - start;
+    
+    REQUIRE(all == 6 * distinct);
+
+    std::cout << "Every automorphic match: " << all << " in " << std::fixed << std::setprecision(1) 
+        << all_ms.count() << "ms\n";
+    std::cout << "Distinct embeddings: " << distinct << " in " << distinct_ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso matching order performance test", "[subgraph_iso_order_performance_test]")
+{
+    using column_graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<>>;
+    column_graph_type g1, g2;
+    
+    //a path pattern whose end carries a label found on 0.1% of the host
+    g1.addNode({0, {1}});
+    for(std::size_t i = 1; i < 4; i++)
+    {
+        g1.addNode({i, {0}});
+        g1.addEdge(i-1, i);
+    }
+
+    std::size_t n = 1'000'000;
+    g2.reserve_nodes(n);
+    for(std::size_t i = 0; i < n; i++)
+        g2.addNode({i, {i % 1000 == 0 ? std::size_t(1) : std::size_t(0)}});
+    for(std::size_t i = 0; i + 1 < n; i++)
+        g2.addEdge(i, i+1);
+    
+    YAGL::SubgraphMatcher<column_graph_type, column_graph_type> matcher(g1, g2);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto count = YAGL::count_matches(g1, g2);
+    const auto end = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> ms = end - start;
+    
+    //every rare vertex but the first starts a path in both directions
+    REQUIRE(count == 2*(n/1000) - 1);
+
+    std::cout << "Path from a rare label, matched from key " << matcher.pattern_keys()[0] << " in " 
+        << std::fixed << std::setprecision(1) << ms.count() << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
+
+TEST_CASE("subgraph iso incremental performance test", "[subgraph_iso_incremental_performance_test]")
+{
+    using log_graph_type = YAGL::Graph<key_type, data_type, YAGL::ChangeLogTraits<>>;
+    log_graph_type g1, g2;
+    
+    //a path through a rarer label in a sparse host
+    g1.addNode({0, {0}}); g1.addNode({1, {1}}); g1.addNode({2, {0}});
+    g1.addEdge(0, 1); g1.addEdge(1, 2);
+
+    std::size_t n = 200'000;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    for(std::size_t i = 0; i < n; i++)
+        g2.addNode({i, {i % 4 == 0 ? std::size_t(1) : std::size_t(0)}});
+    for(std::size_t e = 0; e < 2*n; e++)
+    {
+        auto a = pick(gen);
+        g2.addEdge(a, (a + 1 + pick(gen) % 16) % n);
+    }
+    g2.clear_changes();
+
+    YAGL::IncrementalMatcher<log_graph_type> matcher(g2);
+    matcher.add_pattern(g1);
+
+    //every step adds a node with a few edges and drops an old edge
+    std::size_t steps = 50;
+    std::chrono::duration<double, std::milli> full_ms{0}, incremental_ms{0};
+    std::size_t full_count = 0;
+    for(std::size_t step = 0; step < steps; step++)
+    {
+        auto k = n + step;
+        g2.addNode({k, {step % 2}});
+        for(int e = 0; e < 3; e++)
+            g2.addEdge(k, pick(gen));
+        auto a = pick(gen);
+        if(!g2.out_neighbors(a).empty())
+            g2.removeEdge(a, *g2.out_neighbors(a).begin());
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        matcher.update();
+        auto end = std::chrono::high_resolution_clock::now();
+        incremental_ms += end - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        full_count = YAGL::count_matches(g1, g2);
+        end = std::chrono::high_resolution_clock::now();
+        full_ms += end - start;
+    }
+    REQUIRE(matcher.match_count(0) == full_count);
+
+    std::cout << steps << " rewrite steps, " << full_count << " matches at the end\n";
+    std::cout << "Full search per step: " << std::fixed << std::setprecision(3) 
+        << full_ms.count() / steps << "ms\n";
+    std::cout << "Incremental update per step: " << incremental_ms.count() / steps << "ms\n";
+    std::cout << "------------------------------------\n\n";
+}
@@ -0,0 +1,10 @@
+#!/bin/python
+import numpy as np
+import matplotlib.pyplot as plt
+runtimes = np.asarray([234.883, 447.804, 957.64, 2214]);
+counts = np.asarray([200000, 400000, 800000, 1600000]);
+plt.xlabel('Matches Found')
+plt.ylabel('Runtime in ms')
+plt.title('Performance Analysis for MT-Like Graph')
+plt.plot(counts, runtimes, '--o')
+plt.show()
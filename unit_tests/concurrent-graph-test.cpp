@@ -0,0 +1,137 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include "YAGL_Concurrent_Graph.hpp"
+#include "YAGL_Thread_Pool.hpp"
+
+#include <vector>
+#include <random>
+#include <set>
+#include <utility>
+
+using key_type = int; using data_type = double;
+using node_type = YAGL::Node<key_type, data_type>;
+
+template <typename GraphType>
+auto edge_set(GraphType& graph)
+{
+    std::set<std::pair<key_type, key_type>> edges;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+        for(const auto& nbr : graph.out_neighbors(iter->first))
+            edges.emplace(iter->first, nbr);
+    return edges;
+}
+
+TEST_CASE("concurrent graphs behave like graphs", "[concurrent_graph_test]")
+{
+    YAGL::ConcurrentGraph<key_type, data_type> graph(4);
+    REQUIRE(graph.num_shards() == 4);
+
+    graph.addNode(node_type(1, 0.5));
+    graph.addNode(node_type(2, 1.5));
+    graph.addNode(node_type(3, 2.5));
+    graph.addEdge(1, 2);
+    graph.addEdge(2, 1);
+    graph.addEdge(2, 3);
+    graph.addEdge(3, 3);
+    graph.addEdge(3, 42);
+
+    REQUIRE(graph.numNodes() == 3);
+    REQUIRE(graph.numEdges() == 3);
+    REQUIRE(graph.adjacent(3, 2));
+    REQUIRE(graph.degree(2) == 2);
+    REQUIRE(*graph.getData(2) == 1.5);
+    REQUIRE(!graph.getData(42));
+
+    //the node replaced in place keeps its edges
+    graph.addNode(node_type(2, 9.5));
+    graph.setData(1, 4.5);
+    REQUIRE(*graph.getData(2) == 9.5);
+    REQUIRE(*graph.getData(1) == 4.5);
+    REQUIRE(graph.numNodes() == 3);
+    REQUIRE(graph.adjacent(1, 2));
+
+    graph.removeNode(3);
+    REQUIRE(!graph.contains(3));
+    REQUIRE(graph.numEdges() == 1);
+    REQUIRE(graph.out_neighbors(2) == std::vector<key_type>{1});
+
+    //a directed loop is one edge in both sets
+    YAGL::ConcurrentGraph<key_type, data_type, YAGL::DirectedTraits<>> directed(4);
+    directed.addNode(node_type(1, 0.0));
+    directed.addNode(node_type(2, 0.0));
+    directed.addEdge(1, 2);
+    directed.addEdge(2, 1);
+    directed.addEdge(1, 1);
+    REQUIRE(directed.numEdges() == 3);
+    REQUIRE(directed.in_neighbors(2) == std::vector<key_type>{1});
+    directed.removeNode(1);
+    REQUIRE(directed.numEdges() == 0);
+    REQUIRE(directed.in_neighbors(2).empty());
+    REQUIRE(directed.out_neighbors(2).empty());
+}
+
+TEST_CASE("concurrent graphs take edits from many threads", "[concurrent_graph_test]")
+{
+    key_type num_nodes = 2'000;
+    std::size_t num_edges = 20'000;
+
+    //the same random edges, inserted from many threads and from one
+    std::mt19937 gen(13);
+    std::uniform_int_distribution<key_type> pick(0, num_nodes - 1);
+    std::vector<std::pair<key_type, key_type>> edges(num_edges);
+    for(auto& edge : edges)
+        edge = {pick(gen), pick(gen)};
+
+    YAGL::Graph<key_type, data_type> serial;
+    for(key_type k = 0; k < num_nodes; k++)
+        serial.addNode(node_type(k, 0.0));
+    for(const auto& [a, b] : edges)
+        serial.addEdge(a, b);
+
+    for(std::size_t threads : {1, 2, 4, 8})
+    {
+        YAGL::ThreadPool pool(threads);
+        YAGL::ConcurrentGraph<key_type, data_type> graph(16);
+
+        pool.parallel_for(num_nodes, 64, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for(auto k = begin; k < end; k++)
+                graph.addNode(node_type(k, 0.0));
+        });
+        pool.parallel_for(num_edges, 256, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for(auto i = begin; i < end; i++)
+                graph.addEdge(edges[i].first, edges[i].second);
+        });
+
+        REQUIRE(graph.numNodes() == serial.numNodes());
+        REQUIRE(graph.numEdges() == serial.numEdges());
+        auto copy_graph = graph.to_graph();
+        REQUIRE(edge_set(copy_graph) == edge_set(serial));
+
+        //removals racing with insertions still leave every count exact
+        pool.parallel_for(num_edges, 256, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for(auto i = begin; i < end; i++)
+            {
+                auto [a, b] = edges[i];
+                switch(i % 4)
+                {
+                    case 0: graph.removeNode(a); break;
+                    case 1: graph.addNode(node_type(a, 1.0)); break;
+                    case 2: graph.removeEdge(a, b); break;
+                    default: graph.addEdge(a, b); break;
+                }
+            }
+        });
+
+        copy_graph = graph.to_graph();
+        REQUIRE(graph.numNodes() == copy_graph.numNodes());
+        REQUIRE(graph.numEdges() == copy_graph.numEdges());
+        for(auto iter = copy_graph.node_list_begin(); iter != copy_graph.node_list_end(); iter++)
+        {
+            //every neighbor is still there and sees the node back
+            for(const auto& nbr : graph.out_neighbors(iter->first))
+                REQUIRE(graph.adjacent(nbr, iter->first));
+        }
+    }
+}
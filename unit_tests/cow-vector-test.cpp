@@ -0,0 +1,63 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Cow_Vector.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("cow vectors grow and read back in chunks", "[cow_vector_test]")
+{
+    using vector_type = YAGL::CowVector<int, 4>;
+
+    vector_type values;
+    REQUIRE(values.empty());
+
+    for(int i = 0; i < 10; i++)
+        values.push_back(i * i);
+
+    REQUIRE(values.size() == 10);
+    for(int i = 0; i < 10; i++)
+        REQUIRE(values[i] == i * i);
+
+    values.mutate(9) = -1;
+    REQUIRE(values[9] == -1);
+
+    values.clear();
+    REQUIRE(values.empty());
+    values.emplace_back(3);
+    REQUIRE(values[0] == 3);
+}
+
+TEST_CASE("cow vector copies share until written", "[cow_vector_test]")
+{
+    using vector_type = YAGL::CowVector<std::string, 4>;
+
+    vector_type original;
+    for(int i = 0; i < 12; i++)
+        original.push_back(std::to_string(i));
+
+    vector_type copy = original;
+    for(std::size_t i = 0; i < 12; i++)
+        REQUIRE(copy.shares(original, i));
+
+    //a write clones the one chunk it lands in
+    copy.mutate(5) = "five";
+    REQUIRE(copy[5] == "five");
+    REQUIRE(original[5] == "5");
+    for(std::size_t i = 0; i < 12; i++)
+        REQUIRE(copy.shares(original, i) == (i / 4 != 1));
+
+    //and the original is free to change its own
+    original.mutate(0) = "zero";
+    original.push_back("12");
+    REQUIRE(copy[0] == "0");
+    REQUIRE(copy.size() == 12);
+    REQUIRE(!copy.shares(original, 0));
+    REQUIRE(copy.shares(original, 8));
+
+    //clearing one copy leaves the other whole
+    original.clear();
+    REQUIRE(copy[11] == "11");
+    REQUIRE(!copy.shares(original, 0));
+}
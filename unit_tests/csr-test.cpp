@@ -0,0 +1,185 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include "YAGL_Csr_Graph.hpp"
+#include "YAGL_Algorithms.hpp"
+
+#include <vector>
+#include <type_traits>
+
+struct NodeType
+{
+    double type;
+};
+
+void create_complete_k3_graph(YAGL::Graph<int, NodeType>& graph)
+{
+    graph.addNode({0, {0.0}});
+    graph.addNode({1, {0.0}});
+    graph.addNode({2, {0.0}});
+
+    graph.addEdge(0, 1);
+    graph.addEdge(1, 2);
+    graph.addEdge(2, 0);
+}
+
+void create_complete_k4_graph(YAGL::Graph<int, NodeType>& graph)
+{
+    for(auto i = 0; i < 4; i++)
+        graph.addNode({i, {0.0}});
+    
+    //creates a path graph and then loops it
+    for(auto i = 0; i < 3; i++)
+        graph.addEdge(i, i+1);
+    graph.addEdge(3, 0);
+    
+    //add the diagonals to make it a complete graph K4
+    graph.addEdge(0, 2);
+    graph.addEdge(1, 3);
+}
+
+TEST_CASE("frozen graphs keep the same topology", "[csr_test]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using csr_type = YAGL::CsrGraph<key_type, data_type>;
+
+    graph_type graph;
+    create_complete_k4_graph(graph);
+    graph.addNode({4, {1.0}}); graph.addNode({5, {1.0}});
+    graph.addEdge(4, 5);
+
+    csr_type csr = graph.freeze();
+
+    REQUIRE(std::is_same<typename csr_type::key_type, key_type>::value == true);
+    REQUIRE(csr.numNodes() == graph.numNodes());
+    REQUIRE(csr.numEdges() == graph.numEdges());
+    REQUIRE(csr.min_degree() == graph.min_degree());
+    REQUIRE(csr.max_degree() == graph.max_degree());
+    REQUIRE(csr.avg_degree() == graph.avg_degree());
+
+    std::cout << csr;
+
+    SECTION("dense ids round trip to keys") {
+        for(auto i = 0; i < 6; i++)
+        {
+            auto id = csr.node_id(i);
+            REQUIRE(id < csr.id_bound());
+            REQUIRE(csr.node_key(id) == i);
+            REQUIRE(csr.findNode(i)->first == i);
+        }
+        REQUIRE(csr.node_id(101) == csr_type::invalid_id);
+        REQUIRE(csr.findNode(101) == csr.node_list_end());
+    }
+
+    SECTION("neighborhoods and adjacency match the source graph") {
+        for(auto i = 0; i < 6; i++)
+        {
+            auto nbrs = csr.out_neighbors(i);
+            REQUIRE(nbrs.size() == graph.out_neighbors(i).size());
+            for(auto& k : nbrs)
+            {
+                REQUIRE(graph.adjacent(i, k));
+                REQUIRE(csr.adjacent(i, k));
+            }
+        }
+        REQUIRE(!csr.adjacent(0, 4));
+        REQUIRE(!csr.adjacent(3, 5));
+    }
+
+    SECTION("payloads are copied into the snapshot") {
+        REQUIRE(csr[4].type == 1.0);
+        csr[4].type = 2.0;
+        REQUIRE(graph[4].type == 1.0);
+    }
+}
+
+TEST_CASE("frozen directed graphs keep the same degrees", "[csr_test]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<>>;
+
+    graph_type graph;
+    for(auto i = 0; i < 4; i++)
+        graph.addNode({i, {0.0}});
+
+    //node 2 is mostly a sink, counting out edges alone undercounts it
+    graph.addEdge(0, 1);
+    graph.addEdge(0, 2);
+    graph.addEdge(1, 2);
+    graph.addEdge(2, 3);
+    graph.addEdge(3, 0);
+
+    auto csr = graph.freeze();
+
+    REQUIRE(csr.isDirected());
+    REQUIRE(csr.numEdges() == graph.numEdges());
+    REQUIRE(csr.min_degree() == graph.min_degree());
+    REQUIRE(csr.max_degree() == graph.max_degree());
+    REQUIRE(csr.avg_degree() == graph.avg_degree());
+    REQUIRE(csr.min_degree() == 2);
+    REQUIRE(csr.max_degree() == 3);
+
+    for(auto i = 0; i < 4; i++)
+    {
+        auto& node = graph.findNode(i)->second;
+        REQUIRE(csr.in_degree(node) == graph.in_degree(node));
+        REQUIRE(csr.out_degree(node) == graph.out_degree(node));
+        REQUIRE(csr.degree(node) == graph.degree(node));
+    }
+}
+
+TEST_CASE("searches run on frozen graphs", "[csr_test]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type graph;
+    create_complete_k4_graph(graph);
+    graph.addNode({4, {0.0}}); graph.addNode({5, {0.0}});
+    graph.addEdge(4, 5);
+
+    {
+        auto csr = graph.freeze();
+        REQUIRE(YAGL::iterative_bfs(csr, 0).size() == 4);
+        REQUIRE(YAGL::iterative_bfs(csr, 4).size() == 2);
+        REQUIRE(YAGL::connected_components(csr) == 2);
+
+        auto path = YAGL::recursive_dfs2(csr, 0);
+        REQUIRE(path.size() == 4);
+        REQUIRE(path[0].first == 0);
+        REQUIRE(path[0].second == 0);
+
+        //limiting the depth only keeps the root
+        REQUIRE(YAGL::recursive_dfs2(csr, 0, 1).size() == 1);
+    }
+
+    //connect the components and refreeze
+    graph.addEdge(3, 4);
+    {
+        auto csr = graph.freeze();
+        REQUIRE(YAGL::iterative_bfs(csr, 5).size() == 6);
+        REQUIRE(YAGL::connected_components(csr) == 1);
+        REQUIRE(YAGL::recursive_dfs2(csr, 5).size() == 6);
+    }
+}
+
+TEST_CASE("subgraph isomorphism against a frozen host", "[csr_test]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type g1, g2;
+
+    create_complete_k3_graph(g1);
+    create_complete_k4_graph(g2);
+    
+    auto host = g2.freeze();
+    auto pattern = g1.freeze();
+
+    // the complete graph k3 is subgraph isomorphic to k4 in 24 different ways
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, host).size() == 24);
+    REQUIRE(YAGL::subgraph_isomorphism2(pattern, host).size() == 24);
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 24);
+}
@@ -2,8 +2,12 @@
 
 #include "catch.hpp"
 #include "YAGL_Graph.hpp"
+#include "YAGL_Thread_Pool.hpp"
 #include <vector>
+#include <algorithm>
 #include <type_traits>
+#include <random>
+#include <tuple>
 
 TEST_CASE("graphs can add or remove nodes and duplicate check", "[graph_test]")
 {
@@ -300,3 +304,886 @@ TEST_CASE("graphs can be completely cleared and copied", "[graph_test]")
 
     std::cout << graph;
 }
+
+TEST_CASE("graphs hand out dense ids and recycle them", "[graph_test]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type graph;
+
+    for(auto i = 0; i < 4; i++)
+        graph.addNode({i*10, 2.6});
+    
+    graph.addEdge(0, 10);
+    graph.addEdge(10, 20);
+    graph.addEdge(20, 30);
+
+    //ids are dense and map back to their keys 
+    REQUIRE(graph.id_bound() == 4);
+    for(auto i = 0; i < 4; i++)
+    {
+        auto id = graph.node_id(i*10);
+        REQUIRE(graph.has_id(id));
+        REQUIRE(graph.node_key(id) == i*10);
+    }
+    REQUIRE(graph.node_id(606) == graph_type::invalid_id);
+    
+    //neighborhoods are stored as ids 
+    auto id_10 = graph.node_id(10);
+    REQUIRE(graph.out_ids(id_10).size() == 2);
+    REQUIRE(graph.adjacent_ids(id_10, graph.node_id(0)));
+    REQUIRE(graph.adjacent_ids(id_10, graph.node_id(20)));
+    REQUIRE(!graph.adjacent_ids(id_10, graph.node_id(30)));
+
+    //the key facing interface hands out views that still look up by key
+    for(auto& k : graph.out_neighbors(10))
+        REQUIRE((k == 0 || k == 20));
+    auto nbrs = graph.out_neighbors(10);
+    REQUIRE(nbrs.count(20) == 1);
+    REQUIRE(nbrs.count(30) == 0);
+    REQUIRE(*nbrs.find(0) == 0);
+    REQUIRE(nbrs.find(30) == nbrs.end());
+
+    //removing a node frees its id and the next node reuses it
+    auto id_20 = graph.node_id(20);
+    graph.removeNode({20, 2.6});
+    REQUIRE(!graph.has_id(id_20));
+    REQUIRE(graph.numEdges() == 1);
+    REQUIRE(graph.out_ids(id_10).size() == 1);
+
+    graph.addNode({40, 2.6});
+    REQUIRE(graph.node_id(40) == id_20);
+    REQUIRE(graph.id_bound() == 4);
+    REQUIRE(graph.out_degree(graph.findNode(40)->second) == 0);
+    
+    //re-adding an existing key keeps its id and edges
+    graph.addNode({10, 3.6});
+    REQUIRE(graph.node_id(10) == id_10);
+    REQUIRE(graph.out_ids(id_10).size() == 1);
+    REQUIRE(graph[10] == 3.6);
+
+    REQUIRE(graph.min_degree() == 0);
+    REQUIRE(graph.max_degree() == 1);
+}
+
+TEST_CASE("graphs can store neighbors in small sorted sets", "[graph_test]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<2>>;
+
+    graph_type graph;
+
+    // Define the node type
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    node_type node_a(366, 2.6);
+    node_type node_b(2, 2.6);
+    node_type node_c(4, 2.6);
+    node_type node_d(606, 2.6);
+
+    graph.addNode(node_a);
+    graph.addNode(node_b);
+    graph.addNode(node_c);
+    graph.addNode(node_d);
+        
+    graph.addEdge(node_a, node_c);
+    graph.addEdge(node_a, node_d);
+    graph.addEdge(node_a, node_b);
+    graph.addEdge(node_b, node_c);
+    graph.addEdge(node_b, node_d);
+    graph.addEdge(node_c, node_d);
+    
+    //duplicates don't count twice
+    graph.addEdge(node_d, node_c);
+
+    REQUIRE(graph.numEdges() == 6);
+    REQUIRE(graph.out_degree(node_a) == 3);
+    REQUIRE(graph.in_degree(node_d) == 3);
+    REQUIRE(graph.adjacent(366, 606));
+    
+    graph.removeEdge(node_d, node_a);
+    REQUIRE(graph.numEdges() == 5);
+    REQUIRE(!graph.adjacent(366, 606));
+
+    graph.removeNode(node_c);
+    REQUIRE(graph.numNodes() == 3);
+    REQUIRE(graph.numEdges() == 2);
+    REQUIRE(graph.min_degree() == 1);
+    REQUIRE(graph.max_degree() == 2);
+
+    graph_type copy_graph = graph;
+    graph.clear();
+    REQUIRE(copy_graph.numEdges() == 2);
+    REQUIRE(copy_graph.adjacent(2, 606));
+    
+    std::cout << copy_graph;
+}
+
+template <typename GraphType>
+void check_map_backend(GraphType& graph)
+{
+    using node_type = YAGL::Node<int, double>;
+
+    for(int i = 0; i < 100; i++)
+        graph.addNode(node_type(i * 7, 0.5));
+
+    //a ring over the nodes
+    for(int i = 0; i < 100; i++)
+        graph.addEdge(i * 7, ((i + 1) % 100) * 7);
+
+    REQUIRE(graph.numNodes() == 100);
+    REQUIRE(graph.numEdges() == 100);
+    REQUIRE(graph.findNode(21)->second.getData() == 0.5);
+    REQUIRE(graph.findNode(22) == graph.node_list_end());
+
+    //replacing a node keeps its id and edges
+    auto id = graph.node_id(21);
+    graph.addNode(node_type(21, 1.5));
+    REQUIRE(graph.node_id(21) == id);
+    REQUIRE(graph.findNode(21)->second.getData() == 1.5);
+    REQUIRE(graph.out_neighbors(21).size() == 2);
+
+    for(int i = 0; i < 100; i += 2)
+        graph.removeNode(graph.findNode(i * 7)->second);
+
+    REQUIRE(graph.numNodes() == 50);
+    REQUIRE(graph.numEdges() == 0);
+
+    std::size_t count = 0;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+    {
+        REQUIRE(iter->first % 14 == 7);
+        REQUIRE(graph.node_key(graph.node_id(iter->first)) == iter->first);
+        count++;
+    }
+    REQUIRE(count == 50);
+
+    GraphType copy_graph = graph;
+    graph.clear();
+    REQUIRE(copy_graph.numNodes() == 50);
+    REQUIRE(copy_graph.findNode(7) != copy_graph.node_list_end());
+
+    copy_graph.shrink_to_fit();
+    copy_graph.max_load_factor(0.5f);
+    REQUIRE(copy_graph.findNode(693)->second.getKey() == 693);
+}
+
+TEST_CASE("graphs can swap their key map backend", "[graph_test]")
+{    
+    using key_type = int; using data_type = double;
+
+    SECTION("robin hood maps") {
+        YAGL::Graph<key_type, data_type, YAGL::RobinHoodGraphTraits> graph;
+        check_map_backend(graph);
+    }
+
+    SECTION("robin hood maps with small neighbor sets") {
+        YAGL::Graph<key_type, data_type, YAGL::FlatGraphTraits<4>> graph;
+        check_map_backend(graph);
+    }
+
+    SECTION("the default maps") {
+        YAGL::Graph<key_type, data_type> graph;
+        check_map_backend(graph);
+    }
+}
+
+TEST_CASE("graphs can move and emplace nodes", "[graph_test]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = std::vector<double>;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    graph_type graph;
+
+    //moving a node hands its payload to the graph
+    node_type node_a(1, data_type(100, 2.6));
+    graph.addNode(std::move(node_a));
+    REQUIRE(graph.numNodes() == 1);
+    REQUIRE(graph[1].size() == 100);
+
+    //emplacing builds the payload inside the graph
+    auto [iter, inserted] = graph.emplaceNode(2, 50, 1.5);
+    REQUIRE(inserted);
+    REQUIRE(iter->first == 2);
+    REQUIRE(iter->second.getData().size() == 50);
+    REQUIRE(graph.node_id(2) != graph_type::invalid_id);
+
+    //an existing node is left alone by emplace
+    auto result = graph.emplaceNode(2, 10, 0.0);
+    REQUIRE(!result.second);
+    REQUIRE(graph[2].size() == 50);
+    REQUIRE(graph.numNodes() == 2);
+    
+    //but replaced by a moved in node
+    graph.addNode(node_type(2, data_type(3, 0.0)));
+    REQUIRE(graph[2].size() == 3);
+    REQUIRE(graph.numNodes() == 2);
+
+    graph.addEdge(1, 2);
+    REQUIRE(graph.numEdges() == 1);
+    
+    const auto& node = graph.findNode(1)->second;
+    REQUIRE(node.getData()[0] == 2.6);
+
+    //aggregate payloads are built from their fields
+    struct Particle { int type; double mass; };
+    YAGL::Graph<key_type, Particle> particles;
+    auto emplaced = particles.emplaceNode(3, 1, 0.5);
+    REQUIRE(emplaced.second);
+    REQUIRE(particles[3].type == 1);
+    REQUIRE(particles[3].mass == 0.5);
+    REQUIRE(!particles.emplaceNode(3, 2, 1.5).second);
+    REQUIRE(particles[3].type == 1);
+}
+
+TEST_CASE("graphs can be bulk loaded from edge lists", "[graph_test]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    std::vector<node_type> nodes;
+    for(auto i = 0; i < 4; i++)
+        nodes.push_back({i, 2.6});
+    
+    // K4 with duplicates in both directions and an edge to a missing node 
+    std::vector<std::pair<key_type, key_type>> edges{
+        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 2}, {1, 3},
+        {1, 0}, {2, 0}, {0, 1}, {3, 606}};
+
+    SECTION("bulk loading matches adding edges one at a time") {
+        graph_type bulk, single;
+        bulk.bulk_load(nodes, edges);
+        
+        for(auto& n : nodes) single.addNode(n);
+        for(auto& [a, b] : edges) single.addEdge(a, b);
+
+        REQUIRE(bulk.numNodes() == 4);
+        REQUIRE(bulk.numEdges() == 6);
+        REQUIRE(bulk.numEdges() == single.numEdges());
+        REQUIRE(bulk.min_degree() == 3);
+        REQUIRE(bulk.max_degree() == 3);
+        for(auto& [a, b] : edges)
+            REQUIRE(bulk.adjacent(a, b) == single.adjacent(a, b));
+    }
+
+    SECTION("bulk loading on top of an existing graph only counts new edges") {
+        graph_type graph;
+        graph.addNode({0, 1.0}); graph.addNode({1, 1.0});
+        graph.addEdge(0, 1);
+
+        graph.bulk_load(nodes, edges);
+        REQUIRE(graph.numNodes() == 4);
+        REQUIRE(graph.numEdges() == 6);
+        REQUIRE(graph[0] == 2.6);
+    }
+
+    SECTION("graphs can be built straight from an edge list") {
+        std::vector<std::pair<key_type, key_type>> chain{{5, 6}, {6, 7}, {7, 7}, {6, 5}};
+        auto graph = graph_type::from_edge_list(chain, 1.5);
+        
+        REQUIRE(graph.numNodes() == 3);
+        REQUIRE(graph.numEdges() == 3);
+        REQUIRE(graph.adjacent(7, 7));
+        REQUIRE(graph[6] == 1.5);
+
+        using small_graph_type = YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<2>>;
+        auto small_graph = small_graph_type::from_edge_list(edges);
+        REQUIRE(small_graph.numNodes() == 5);
+        REQUIRE(small_graph.numEdges() == 7);
+        REQUIRE(small_graph.max_degree() == 4);
+    }
+}
+
+TEST_CASE("graph capacity can be reserved and released", "[graph_test]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using small_graph_type = YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<2>>;
+
+    graph_type graph;
+    small_graph_type small_graph;
+
+    REQUIRE(graph.max_load_factor() == 1.0f);
+    graph.max_load_factor(0.5f);
+    REQUIRE(graph.max_load_factor() == 0.5f);
+
+    graph.reserve_nodes(100);
+    graph.reserve_edges(200);
+    small_graph.reserve_nodes(100);
+    small_graph.reserve_edges(200);
+
+    for(auto i = 0; i < 100; i++)
+    {
+        graph.addNode({i, 2.6});
+        small_graph.addNode({i, 2.6});
+    }
+    for(auto i = 0; i < 99; i++)
+    {
+        graph.addEdge(i, i+1);
+        small_graph.addEdge(i, i+1);
+    }
+
+    //reserved neighborhoods hold the 2m/n = 4 expected neighbors without a rehash
+    auto& nbrs = graph.out_ids(graph.node_id(50));
+    REQUIRE(nbrs.max_load_factor() == 0.5f);
+    REQUIRE(nbrs.bucket_count() >= 8);
+    REQUIRE(!small_graph.out_ids(small_graph.node_id(50)).is_inline());
+
+    for(auto i = 0; i < 90; i++)
+    {
+        graph.removeNode({i, 2.6});
+        small_graph.removeNode({i, 2.6});
+    }
+    
+    graph.shrink_to_fit();
+    small_graph.shrink_to_fit();
+
+    //nothing is lost and the survivors give back their spare room
+    REQUIRE(graph.numNodes() == 10);
+    REQUIRE(graph.numEdges() == 9);
+    REQUIRE(graph.adjacent(95, 96));
+    REQUIRE(small_graph.numEdges() == 9);
+    REQUIRE(small_graph.out_ids(small_graph.node_id(95)).is_inline());
+    REQUIRE(small_graph.adjacent(95, 96));
+
+    //freed ids are still recycled after shrinking
+    graph.addNode({1000, 2.6});
+    REQUIRE(graph.id_bound() == 100);
+
+    //edges reserved first wait for the nodes to spread over
+    small_graph_type edges_first;
+    edges_first.reserve_edges(200);
+    edges_first.reserve_nodes(100);
+    edges_first.addNode({0, 2.6});
+    REQUIRE(!edges_first.out_ids(edges_first.node_id(0)).is_inline());
+}
+
+TEST_CASE("graphs can keep node labels in a column", "[graph_test]")
+{    
+    struct LabeledData { int type; double weight; };
+    
+    using key_type = int; using data_type = LabeledData;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<YAGL::RobinHoodGraphTraits>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::has_label_column);
+    static_assert(!YAGL::Graph<key_type, data_type>::has_label_column);
+    static_assert(!YAGL::Graph<key_type, double, YAGL::LabelColumnTraits<>>::has_label_column);
+
+    graph_type graph;
+
+    graph.addNode(node_type(5, {1, 0.5}));
+    graph.addNode(node_type(6, {2, 0.5}));
+    graph.emplaceNode(7, LabeledData{3, 0.5});
+    
+    REQUIRE(graph.node_label(graph.node_id(5)) == 1);
+    REQUIRE(graph.node_label(graph.node_id(6)) == 2);
+    REQUIRE(graph.node_label(graph.node_id(7)) == 3);
+    REQUIRE(graph.label_column().size() == graph.id_bound());
+
+    //replacing a node refreshes its label
+    graph.addNode(node_type(6, {4, 0.5}));
+    REQUIRE(graph.node_label(graph.node_id(6)) == 4);
+
+    //payloads can only be written through calls that refresh the column
+    using payload_of = decltype(graph.findNode(6)->second.getData());
+    static_assert(std::is_const_v<std::remove_reference_t<payload_of>>);
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(graph[6])>>);
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(graph.getNodeSetRef())>>);
+    static_assert(!std::is_const_v<std::remove_reference_t<decltype(std::declval<YAGL::Graph<key_type, data_type>&>()[6])>>);
+    graph.setData(6, {5, 0.5});
+    REQUIRE(graph[6].type == 5);
+    REQUIRE(graph.node_label(graph.node_id(6)) == 5);
+    graph.setData(6, {4, 0.5});
+
+    //recycled ids get the new node's label
+    graph.removeNode(graph.findNode(5)->second);
+    graph.addNode(node_type(8, {9, 0.5}));
+    REQUIRE(graph.node_id(8) == 0);
+    REQUIRE(graph.node_label(0) == 9);
+
+    int label_sum = 0;
+    for(graph_type::id_type id = 0; id < graph.id_bound(); id++)
+        if(graph.has_id(id)) label_sum += graph.label_column()[id];
+    REQUIRE(label_sum == 16);
+
+    graph.clear();
+    REQUIRE(graph.label_column().empty());
+}
+
+TEST_CASE("graphs can index their nodes by label", "[graph_test]")
+{    
+    struct LabeledData { int type; double weight; };
+    
+    using key_type = int; using data_type = LabeledData;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelIndexTraits<>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::has_label_index);
+    static_assert(!YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<>>::has_label_index);
+
+    graph_type graph;
+
+    for(int i = 0; i < 10; i++)
+        graph.addNode(node_type(i, {i % 3, 0.5}));
+
+    auto keys_with = [&](int label) {
+        std::vector<int> keys;
+        for(const auto& k : graph.nodes_with_label(label))
+            keys.push_back(k);
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    };
+
+    REQUIRE(keys_with(0) == std::vector<int>{0, 3, 6, 9});
+    REQUIRE(keys_with(1) == std::vector<int>{1, 4, 7});
+    REQUIRE(graph.label_count(2) == 3);
+    REQUIRE(graph.nodes_with_label(5).empty());
+
+    //relabeling moves the node between buckets
+    graph.setData(4, {2, 1.5});
+    REQUIRE(keys_with(1) == std::vector<int>{1, 7});
+    REQUIRE(keys_with(2) == std::vector<int>{2, 4, 5, 8});
+    REQUIRE(graph.findNode(4)->second.getData().weight == 1.5);
+    REQUIRE(graph.node_label(graph.node_id(4)) == 2);
+
+    graph.addNode(node_type(7, {5, 0.5}));
+    REQUIRE(keys_with(1) == std::vector<int>{1});
+    REQUIRE(keys_with(5) == std::vector<int>{7});
+
+    //removals drop out of their bucket, empty buckets are dropped
+    graph.removeNode(graph.findNode(7)->second);
+    graph.removeNode(graph.findNode(0)->second);
+    REQUIRE(graph.label_count(5) == 0);
+    REQUIRE(keys_with(0) == std::vector<int>{3, 6, 9});
+
+    //setting data of a missing key does nothing
+    graph.setData(42, {0, 0.0});
+    REQUIRE(graph.label_count(0) == 3);
+
+    //the index survives copies
+    graph_type copy_graph = graph;
+    graph.clear();
+    REQUIRE(graph.label_count(0) == 0);
+    REQUIRE(copy_graph.label_count(0) == 3);
+    REQUIRE(copy_graph.nodes_with_label(1).begin().id() == copy_graph.node_id(1));
+}
+
+TEST_CASE("graphs can keep payloads on their edges", "[graph_test]")
+{
+    struct Bond { int type; double length; };
+
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::EdgeDataTraits<Bond>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::has_edge_data && graph_type::has_edge_labels);
+    static_assert(!YAGL::Graph<key_type, data_type>::has_edge_data);
+    static_assert(!YAGL::Graph<key_type, data_type, YAGL::EdgeDataTraits<double>>::has_edge_labels);
+
+    graph_type graph;
+
+    for(int i = 0; i < 4; i++)
+        graph.addNode(node_type(i, 0.5));
+
+    graph.addEdge(0, 1, Bond{1, 1.5});
+    graph.addEdge(1, 2, Bond{2, 2.5});
+    graph.addEdge(2, 3);
+    REQUIRE(graph.numEdges() == 3);
+
+    //payloads are shared by both directions of an edge
+    REQUIRE(graph.getEdgeData(0, 1)->type == 1);
+    REQUIRE(graph.getEdgeData(1, 0)->length == 1.5);
+    REQUIRE(graph.getEdgeData(2, 1)->type == 2);
+    REQUIRE(graph.edge_data_ids(graph.node_id(1), graph.node_id(2)) == graph.getEdgeData(1, 2));
+
+    //edges without a payload and missing edges have none
+    REQUIRE(graph.getEdgeData(2, 3) == nullptr);
+    REQUIRE(graph.getEdgeData(0, 3) == nullptr);
+    REQUIRE(graph.getEdgeData(0, 42) == nullptr);
+
+    //payloads can be set on existing edges only
+    graph.setEdgeData(3, 2, Bond{3, 0.5});
+    graph.setEdgeData(0, 3, Bond{4, 0.5});
+    REQUIRE(graph.getEdgeData(2, 3)->type == 3);
+    REQUIRE(graph.getEdgeData(0, 3) == nullptr);
+
+    //adding an edge again replaces its payload without a new edge
+    graph.addEdge(1, 0, Bond{5, 1.0});
+    REQUIRE(graph.numEdges() == 3);
+    REQUIRE(graph.getEdgeData(0, 1)->type == 5);
+
+    //removed edges take their payload with them
+    graph.removeEdge(0, 1);
+    REQUIRE(graph.getEdgeData(0, 1) == nullptr);
+    graph.addEdge(0, 1);
+    REQUIRE(graph.getEdgeData(0, 1) == nullptr);
+
+    //so do removed nodes, a recycled id starts out without payloads
+    graph.removeNode(graph.findNode(2)->second);
+    graph.addNode(node_type(7, 0.5));
+    REQUIRE(graph.node_id(7) == 2);
+    graph.addEdge(7, 1);
+    graph.addEdge(7, 3);
+    REQUIRE(graph.getEdgeData(7, 1) == nullptr);
+    REQUIRE(graph.getEdgeData(3, 7) == nullptr);
+
+    //payloads survive copies and are dropped on clear
+    graph.setEdgeData(7, 3, Bond{6, 0.5});
+    graph_type copy_graph = graph;
+    graph.clear();
+    REQUIRE(graph.numEdges() == 0);
+    REQUIRE(copy_graph.getEdgeData(3, 7)->type == 6);
+}
+
+TEST_CASE("graphs can be directed", "[graph_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::is_directed);
+    static_assert(!YAGL::Graph<key_type, data_type>::is_directed);
+
+    auto sorted = [](auto range) {
+        std::vector<key_type> keys(range.begin(), range.end());
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    };
+
+    graph_type graph;
+    REQUIRE(graph.isDirected());
+
+    for(int i = 0; i < 4; i++)
+        graph.addNode(node_type(i, 0.5));
+
+    graph.addEdge(0, 1);
+    graph.addEdge(0, 2);
+    graph.addEdge(2, 0);
+    graph.addEdge(3, 0);
+    graph.addEdge(0, 1);
+    REQUIRE(graph.numEdges() == 4);
+
+    //an edge only shows up at its source's out and its target's in
+    REQUIRE(sorted(graph.out_neighbors(0)) == std::vector<key_type>{1, 2});
+    REQUIRE(sorted(graph.in_neighbors(0)) == std::vector<key_type>{2, 3});
+    REQUIRE(sorted(graph.in_neighbors(1)) == std::vector<key_type>{0});
+    REQUIRE(graph.out_neighbors(1).empty());
+    REQUIRE(graph.adjacent(0, 1));
+    REQUIRE_FALSE(graph.adjacent(1, 0));
+
+    REQUIRE(graph.out_degree(graph.findNode(0)->second) == 2);
+    REQUIRE(graph.in_degree(graph.findNode(0)->second) == 2);
+    REQUIRE(graph.degree(graph.findNode(0)->second) == 4);
+    REQUIRE(graph.max_degree() == 4);
+    REQUIRE(graph.avg_degree() == 2.0);
+
+    //removing one direction leaves the other
+    graph.removeEdge(0, 2);
+    REQUIRE(graph.numEdges() == 3);
+    REQUIRE(graph.adjacent(2, 0));
+    REQUIRE_FALSE(graph.adjacent(0, 2));
+    graph.removeEdge(1, 0);
+    REQUIRE(graph.numEdges() == 3);
+
+    //removing a node drops its edges both ways
+    graph.removeNode(graph.findNode(0)->second);
+    REQUIRE(graph.numEdges() == 0);
+    REQUIRE(graph.in_neighbors(1).empty());
+    REQUIRE(graph.out_neighbors(2).empty());
+    REQUIRE(graph.out_neighbors(3).empty());
+
+    SECTION("bulk loading keeps the direction") {
+        std::vector<std::pair<key_type, key_type>> edges = {{0, 1}, {1, 2}, {2, 0}, {1, 0}, {0, 1}};
+        auto bulk = graph_type::from_edge_list(edges, 0.5);
+        REQUIRE(bulk.numEdges() == 4);
+        REQUIRE(sorted(bulk.out_neighbors(1)) == std::vector<key_type>{0, 2});
+        REQUIRE(sorted(bulk.in_neighbors(0)) == std::vector<key_type>{1, 2});
+        REQUIRE_FALSE(bulk.adjacent(0, 2));
+
+        //and so does the frozen copy
+        auto csr = bulk.freeze();
+        REQUIRE(csr.isDirected());
+        REQUIRE(csr.numEdges() == 4);
+        REQUIRE(sorted(csr.in_neighbors(0)) == std::vector<key_type>{1, 2});
+        REQUIRE(sorted(csr.out_neighbors(0)) == std::vector<key_type>{1});
+    }
+
+    SECTION("edge payloads belong to one direction") {
+        struct Bond { int type; };
+        YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<YAGL::EdgeDataTraits<Bond>>> bonds;
+        bonds.addNode(node_type(0, 0.5));
+        bonds.addNode(node_type(1, 0.5));
+        bonds.addEdge(0, 1, Bond{1});
+        bonds.addEdge(1, 0, Bond{2});
+        REQUIRE(bonds.getEdgeData(0, 1)->type == 1);
+        REQUIRE(bonds.getEdgeData(1, 0)->type == 2);
+
+        bonds.removeEdge(0, 1);
+        REQUIRE(bonds.getEdgeData(0, 1) == nullptr);
+        REQUIRE(bonds.getEdgeData(1, 0)->type == 2);
+    }
+}
+
+TEST_CASE("undirected graphs keep one neighbor set per node", "[graph_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    graph_type graph;
+    graph.addNode(node_type(0, 0.5));
+    graph.addNode(node_type(1, 0.5));
+    graph.addEdge(0, 1);
+
+    REQUIRE(graph.isUndirected());
+    REQUIRE(&graph.out_ids(0) == &graph.in_ids(0));
+    REQUIRE(graph.adjacent(1, 0));
+    REQUIRE(graph.degree(graph.findNode(0)->second) == 1);
+    REQUIRE(sizeof(graph_type::in_out_nbr_type) == sizeof(graph_type::id_set_type));
+
+    graph.removeEdge(1, 0);
+    REQUIRE(graph.numEdges() == 0);
+    REQUIRE(graph.out_neighbors(0).empty());
+}
+
+TEST_CASE("graphs can log the nodes they change", "[graph_test]")
+{
+    struct LabeledData { int type; };
+
+    using key_type = int; using data_type = LabeledData;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::ChangeLogTraits<>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::has_change_log);
+    static_assert(!YAGL::Graph<key_type, data_type>::has_change_log);
+
+    auto changed = [](const graph_type& graph) {
+        std::vector<key_type> keys(graph.changed_nodes().begin(), graph.changed_nodes().end());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    };
+
+    graph_type graph;
+    graph.addNode(node_type(1, {0}));
+    graph.emplaceNode(2, LabeledData{0});
+    graph.addNode(node_type(3, {0}));
+    REQUIRE(changed(graph) == std::vector<key_type>{1, 2, 3});
+
+    graph.clear_changes();
+    REQUIRE(graph.changed_nodes().empty());
+
+    //edges log both ends, but only when they change something
+    graph.addEdge(1, 2);
+    graph.addEdge(2, 1);
+    graph.addEdge(1, 42);
+    graph.removeEdge(2, 3);
+    REQUIRE(changed(graph) == std::vector<key_type>{1, 2});
+
+    graph.clear_changes();
+    graph.setData(3, {1});
+    graph.setData(42, {1});
+    REQUIRE(changed(graph) == std::vector<key_type>{3});
+
+    //a removed node logs itself and its neighbors
+    graph.clear_changes();
+    graph.removeNode(graph.findNode(1)->second);
+    REQUIRE(changed(graph) == std::vector<key_type>{1, 2});
+
+    graph.clear_changes();
+    graph.clear();
+    REQUIRE(changed(graph) == std::vector<key_type>{2, 3});
+}
+
+template <typename GraphType>
+void check_degree_statistics(GraphType& graph)
+{
+    //the same statistics from a scan of every node
+    std::vector<std::size_t> degrees;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+        degrees.push_back(graph.degree(iter->second));
+    std::sort(degrees.begin(), degrees.end());
+
+    if(degrees.empty())
+    {
+        REQUIRE(graph.min_degree() == 0);
+        REQUIRE(graph.max_degree() == 0);
+        REQUIRE(graph.avg_degree() == 0);
+        REQUIRE(graph.degree_percentile(0.5) == 0);
+        return;
+    }
+
+    std::size_t sum = 0;
+    for(auto d : degrees) sum += d;
+    REQUIRE(graph.min_degree() == degrees.front());
+    REQUIRE(graph.max_degree() == degrees.back());
+    REQUIRE(graph.avg_degree() == Approx(double(sum) / degrees.size()));
+    REQUIRE(graph.degree_histogram().size() == degrees.back() + 1);
+    REQUIRE(graph.degree_percentile(0.0) == degrees.front());
+    REQUIRE(graph.degree_percentile(1.0) == degrees.back());
+    REQUIRE(graph.degree_percentile(0.5) == degrees[(degrees.size() + 1) / 2 - 1]);
+}
+
+TEST_CASE("graphs keep their degree statistics up to date", "[graph_test]")
+{
+    using key_type = int; using data_type = double;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using directed_type = YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    graph_type graph;
+    check_degree_statistics(graph);
+
+    //a star with a loose node, the median is a leaf
+    for(key_type k = 0; k < 6; k++)
+        graph.addNode(node_type(k, 0.0));
+    for(key_type k = 1; k < 5; k++)
+        graph.addEdge(0, k);
+    REQUIRE(graph.min_degree() == 0);
+    REQUIRE(graph.max_degree() == 4);
+    REQUIRE(graph.degree_percentile(0.5) == 1);
+    REQUIRE(graph.degree_histogram() == std::vector<std::size_t>{1, 4, 0, 0, 1});
+
+    //removing the center leaves nothing but loose nodes
+    graph.removeNode(graph.findNode(0)->second);
+    REQUIRE(graph.max_degree() == 0);
+    REQUIRE(graph.degree_histogram() == std::vector<std::size_t>{5});
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<key_type> pick(0, 24);
+    std::uniform_int_distribution<int> action(0, 5);
+
+    directed_type directed;
+    for(int edit = 0; edit < 600; edit++)
+    {
+        auto u = pick(gen), v = pick(gen);
+        switch(action(gen))
+        {
+            case 0:
+                graph.addNode(node_type(u, 0.0));
+                directed.addNode(node_type(u, 0.0));
+                break;
+            case 1:
+                if(graph.findNode(u) != graph.node_list_end()) graph.removeNode(graph.findNode(u)->second);
+                if(directed.findNode(u) != directed.node_list_end()) directed.removeNode(directed.findNode(u)->second);
+                break;
+            case 2:
+                graph.removeEdge(u, v);
+                directed.removeEdge(u, v);
+                break;
+            default:
+                graph.addEdge(u, v);
+                directed.addEdge(u, v);
+                break;
+        }
+        check_degree_statistics(graph);
+        check_degree_statistics(directed);
+    }
+
+    //bulk loads and copies carry the statistics along
+    std::vector<std::pair<key_type, key_type>> edges{{0, 1}, {1, 2}, {2, 0}, {2, 3}};
+    auto loaded = graph_type::from_edge_list(edges, 0.0);
+    check_degree_statistics(loaded);
+    REQUIRE(loaded.max_degree() == 3);
+
+    graph_type copy_graph = graph;
+    check_degree_statistics(copy_graph);
+
+    graph.clear();
+    check_degree_statistics(graph);
+    graph.addNode(node_type(1, 0.0));
+    check_degree_statistics(graph);
+}
+
+template <typename GraphType>
+auto batch_contents(GraphType& graph)
+{
+    std::vector<std::tuple<int, int, int>> contents;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+    {
+        contents.emplace_back(iter->first, -1, int(iter->second.getData()));
+        for(const auto& nbr : graph.out_neighbors(iter->first))
+            contents.emplace_back(iter->first, nbr, 0);
+    }
+    std::sort(contents.begin(), contents.end());
+    return contents;
+}
+
+template <typename GraphType>
+void check_batches(std::mt19937& gen)
+{
+    using key_type = typename GraphType::key_type;
+    using batch_type = YAGL::MutationBatch<key_type, double>;
+
+    std::uniform_int_distribution<key_type> pick(0, 59);
+    std::uniform_int_distribution<int> size(0, 40);
+
+    GraphType serial, batched, pooled;
+    YAGL::ThreadPool pool(3);
+    for(int round = 0; round < 30; round++)
+    {
+        batch_type batch;
+        for(int i = size(gen); i > 0; i--) batch.add_nodes.emplace_back(pick(gen), double(round));
+        for(int i = size(gen) / 4; i > 0; i--) batch.remove_nodes.push_back(pick(gen));
+        for(int i = 2 * size(gen); i > 0; i--) batch.add_edges.emplace_back(pick(gen), pick(gen));
+        for(int i = size(gen); i > 0; i--) batch.remove_edges.emplace_back(pick(gen), pick(gen));
+
+        //one call at a time, in the order the batch promises
+        for(const auto& [a, b] : batch.remove_edges) serial.removeEdge(a, b);
+        for(const auto& key : batch.remove_nodes)
+            if(serial.findNode(key) != serial.node_list_end()) serial.removeNode(serial.findNode(key)->second);
+        for(const auto& node : batch.add_nodes) serial.addNode(node);
+        for(const auto& [a, b] : batch.add_edges) serial.addEdge(a, b);
+
+        batched.apply(batch);
+        pooled.apply(batch, pool);
+
+        REQUIRE(batch_contents(batched) == batch_contents(serial));
+        REQUIRE(batch_contents(pooled) == batch_contents(serial));
+        REQUIRE(batched.numEdges() == serial.numEdges());
+        REQUIRE(pooled.numEdges() == serial.numEdges());
+        REQUIRE(batched.degree_histogram() == serial.degree_histogram());
+        REQUIRE(pooled.avg_degree() == Approx(serial.avg_degree()));
+    }
+}
+
+TEST_CASE("graphs can apply batches of mutations", "[graph_test]")
+{
+    using key_type = int; using data_type = double;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    std::mt19937 gen(21);
+    check_batches<YAGL::Graph<key_type, data_type>>(gen);
+    check_batches<YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<YAGL::SmallNeighborTraits<4>>>>(gen);
+
+    //the journal of a batch replays like that of single calls
+    using journal_type = YAGL::Graph<key_type, data_type, YAGL::JournalTraits<YAGL::DirectedTraits<>>>;
+    journal_type graph;
+    for(key_type k = 0; k < 10; k++)
+        graph.addNode(node_type(k, 0.0));
+    for(key_type k = 0; k < 10; k++)
+        graph.addEdge(k, (k + 1) % 10);
+    journal_type copy_graph = graph;
+    auto seen = graph.epoch();
+
+    YAGL::MutationBatch<key_type, data_type> batch;
+    batch.remove_nodes = {3};
+    batch.remove_edges = {{5, 6}, {6, 5}};
+    batch.add_nodes = {node_type(10, 1.0), node_type(0, 2.0)};
+    batch.add_edges = {{10, 0}, {0, 0}, {0, 1}, {2, 4}, {2, 4}, {7, 42}};
+    graph.apply(batch);
+
+    REQUIRE(graph.numNodes() == 10);
+    REQUIRE(graph.numEdges() == 10 - 3 + 3);
+    YAGL::apply_changes(copy_graph, graph.changes_since(seen));
+    REQUIRE(batch_contents(copy_graph) == batch_contents(graph));
+}
@@ -0,0 +1,28 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// every allocation that reaches the global heap, so the memory resource
+// test can tell whether a graph went around its resource. Kept in a
+// translation unit of its own so the compiler never sees these bodies
+// next to the allocations they serve, and only linked into that test
+std::atomic<std::size_t> heap_allocations{0};
+
+void* operator new(std::size_t bytes)
+{
+    heap_allocations++;
+    if(void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t bytes, std::align_val_t align)
+{
+    heap_allocations++;
+    auto a = static_cast<std::size_t>(align);
+    if(void* p = std::aligned_alloc(a, (bytes + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,173 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include "YAGL_Incremental_Matcher.hpp"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+
+struct LabeledType
+{
+    int type;
+};
+
+using key_type = int; using data_type = LabeledType;
+using graph_type = YAGL::Graph<key_type, data_type, YAGL::ChangeLogTraits<>>;
+using rows_type = std::set<std::vector<key_type>>;
+
+rows_type rows_of(const YAGL::MatchSet<key_type>& matches)
+{
+    rows_type rows;
+    for(auto row : matches)
+        rows.emplace(row.begin(), row.end());
+    return rows;
+}
+
+//the matches of a full search, in the columns of the incremental matcher
+rows_type full_search(graph_type& pattern, graph_type& host)
+{
+    rows_type rows;
+    for(const auto& M : YAGL::subgraph_isomorphism2(pattern, host))
+    {
+        std::vector<key_type> row;
+        for(const auto& [u, w] : M)
+            row.push_back(w);
+        rows.insert(row);
+    }
+    return rows;
+}
+
+TEST_CASE("incremental matches follow single edits", "[incremental_matcher_test]")
+{
+    //a path labeled 0 1 0
+    graph_type pattern;
+    pattern.addNode({0, {0}}); pattern.addNode({1, {1}}); pattern.addNode({2, {0}});
+    pattern.addEdge(0, 1); pattern.addEdge(1, 2);
+
+    graph_type host;
+    host.addNode({10, {0}}); host.addNode({11, {1}}); host.addNode({12, {0}});
+    host.addEdge(10, 11);
+    host.clear_changes();
+
+    YAGL::IncrementalMatcher<graph_type> matcher(host);
+    auto p = matcher.add_pattern(pattern);
+    REQUIRE(matcher.num_patterns() == 1);
+    REQUIRE(matcher.match_count(p) == 0);
+
+    //closing the path adds it both ways round
+    host.addEdge(11, 12);
+    auto changes = matcher.update();
+    REQUIRE(host.changed_nodes().empty());
+    REQUIRE(changes.size() == 1);
+    REQUIRE(rows_of(changes[p].added) == rows_type{{10, 11, 12}, {12, 11, 10}});
+    REQUIRE(changes[p].invalidated.empty());
+    REQUIRE(changes[p].added.columns() == std::vector<key_type>{0, 1, 2});
+    REQUIRE(matcher.match_count(p) == 2);
+
+    //an edge elsewhere changes nothing
+    host.addNode({13, {0}});
+    host.addEdge(13, 10);
+    changes = matcher.update();
+    REQUIRE(changes[p].added.empty());
+    REQUIRE(changes[p].invalidated.empty());
+
+    //a third end on the middle vertex
+    host.addEdge(13, 11);
+    changes = matcher.update();
+    REQUIRE(changes[p].added.size() == 4);
+    REQUIRE(matcher.match_count(p) == 6);
+
+    //relabeling the middle vertex takes every match with it
+    host.setData(11, {0});
+    changes = matcher.update();
+    REQUIRE(changes[p].added.empty());
+    REQUIRE(changes[p].invalidated.size() == 6);
+    REQUIRE(matcher.match_count(p) == 0);
+
+    //so does removing it once it is back
+    host.setData(11, {1});
+    matcher.update();
+    REQUIRE(matcher.match_count(p) == 6);
+    host.removeNode(host.findNode(11)->second);
+    changes = matcher.update();
+    REQUIRE(changes[p].invalidated.size() == 6);
+    REQUIRE(matcher.matches(p).empty());
+
+    //keys can also be handed in directly
+    host.clear_changes();
+    host.addNode({11, {1}});
+    host.addEdge(10, 11); host.addEdge(11, 12);
+    changes = matcher.update(std::vector<key_type>{11});
+    REQUIRE(changes[p].added.size() == 2);
+    REQUIRE(rows_of(matcher.matches(p)) == full_search(pattern, host));
+}
+
+TEST_CASE("incremental matches agree with full searches", "[incremental_matcher_test]")
+{
+    //a triangle and a disconnected pair, labeled from two labels
+    graph_type triangle;
+    triangle.addNode({0, {0}}); triangle.addNode({1, {0}}); triangle.addNode({2, {1}});
+    triangle.addEdge(0, 1); triangle.addEdge(1, 2); triangle.addEdge(2, 0);
+
+    graph_type apart;
+    apart.addNode({0, {1}}); apart.addNode({1, {1}}); apart.addNode({2, {0}});
+    apart.addEdge(0, 1);
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<key_type> pick(0, 29);
+    std::uniform_int_distribution<int> label(0, 1);
+    std::uniform_int_distribution<int> action(0, 9);
+
+    graph_type host;
+    for(key_type k = 0; k < 20; k++)
+        host.addNode({k, {label(gen)}});
+    for(int e = 0; e < 40; e++)
+        host.addEdge(pick(gen) % 20, pick(gen) % 20);
+
+    YAGL::IncrementalMatcher<graph_type> matcher(host);
+    auto t = matcher.add_pattern(triangle);
+    auto a = matcher.add_pattern(apart);
+    REQUIRE(rows_of(matcher.matches(t)) == full_search(triangle, host));
+    REQUIRE(rows_of(matcher.matches(a)) == full_search(apart, host));
+    host.clear_changes();
+
+    for(int step = 0; step < 60; step++)
+    {
+        auto before_t = rows_of(matcher.matches(t));
+        auto before_a = rows_of(matcher.matches(a));
+
+        //a few random edits per step
+        for(int edit = 0; edit < 3; edit++)
+        {
+            auto u = pick(gen), v = pick(gen);
+            switch(action(gen))
+            {
+                case 0: host.addNode({u, {label(gen)}}); break;
+                case 1: if(host.findNode(u) != host.node_list_end()) host.removeNode(host.findNode(u)->second); break;
+                case 2: host.setData(u, {label(gen)}); break;
+                case 3: case 4: host.removeEdge(u, v); break;
+                default: host.addEdge(u, v); break;
+            }
+        }
+
+        auto changes = matcher.update();
+
+        auto after_t = full_search(triangle, host);
+        auto after_a = full_search(apart, host);
+        REQUIRE(rows_of(matcher.matches(t)) == after_t);
+        REQUIRE(rows_of(matcher.matches(a)) == after_a);
+        REQUIRE(matcher.match_count(t) == after_t.size());
+
+        //the reported changes are exactly the difference
+        for(auto row : changes[t].added) { REQUIRE(before_t.insert({row.begin(), row.end()}).second); }
+        for(auto row : changes[t].invalidated) { REQUIRE(before_t.erase({row.begin(), row.end()}) == 1); }
+        REQUIRE(before_t == after_t);
+
+        for(auto row : changes[a].added) { REQUIRE(before_a.insert({row.begin(), row.end()}).second); }
+        for(auto row : changes[a].invalidated) { REQUIRE(before_a.erase({row.begin(), row.end()}) == 1); }
+        REQUIRE(before_a == after_a);
+    }
+}
@@ -7,6 +7,9 @@
 #include <vector>
 #include <type_traits>
 #include <string> 
+#include <random>
+#include <algorithm>
+#include <set>
 
 struct NodeType
 {
@@ -229,3 +232,740 @@ TEST_CASE("subgraph isomorphism test complete", "[subgraph_iso_test_k3_to_k4]")
     }
 
 }
+
+TEST_CASE("graph isomorphism test k4", "[graph_iso_test_k4]")
+{    
+    // Define the graph types
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type g1, g2, g3;
+    
+    create_complete_k4_graph(g1);
+    create_complete_k4_graph(g2); 
+    create_complete_k3_graph(g3);
+    
+    // The complete graph K4 has has 24 automorphisms to itself
+    REQUIRE(YAGL::graph_isomorphism(g1, g2).size() == 24);
+    
+    // different sizes can never be isomorphic
+    REQUIRE(YAGL::graph_isomorphism(g3, g2).size() == 0);
+}
+
+TEST_CASE("subgraph isomorphism on robin hood backed graphs", "[subgraph_iso_test_robin_hood]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::RobinHoodGraphTraits>;
+
+    graph_type g1, g2;
+
+    for(auto i = 0; i < 3; i++)
+        g1.addNode({i, {0.0}});
+    for(auto i = 0; i < 4; i++)
+        g2.addNode({i, {0.0}});
+    
+    g1.addEdge(0, 1); g1.addEdge(1, 2); g1.addEdge(2, 0);
+    for(auto i = 0; i < 4; i++)
+        for(auto j = i + 1; j < 4; j++)
+            g2.addEdge(i, j);
+    
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 24);
+    REQUIRE(YAGL::connected_components(g2) == 1);
+}
+
+TEST_CASE("subgraph isomorphism with a label column", "[subgraph_iso_test_label_column]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<>>;
+
+    graph_type g1, g2;
+    
+    //a labeled path a - b in the pattern
+    g1.addNode({0, {1.0}});
+    g1.addNode({1, {2.0}});
+    g1.addEdge(0, 1);
+
+    //a labeled star in the host, two leaves carry the right label
+    g2.addNode({10, {1.0}});
+    for(auto i = 11; i < 15; i++)
+    {
+        g2.addNode({i, {i % 2 ? 2.0 : 3.0}});
+        g2.addEdge(10, i);
+    }
+    
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 2);
+
+    //relabeling through addNode is seen by the column
+    g2.addNode({12, {2.0}});
+    REQUIRE(g2.node_label(g2.node_id(12)) == 2.0);
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 3);
+
+    //the default graph reads the labels out of the payloads
+    YAGL::Graph<key_type, data_type> p1, p2;
+    for(auto& [k, node] : g1.getNodeSetRef()) p1.addNode(node);
+    for(auto& [k, node] : g2.getNodeSetRef()) p2.addNode(node);
+    p1.addEdge(0, 1);
+    for(auto i = 11; i < 15; i++) p2.addEdge(10, i);
+    REQUIRE(YAGL::subgraph_isomorphism2(p1, p2).size() == 3);
+}
+
+TEST_CASE("subgraph isomorphism with a label index", "[subgraph_iso_test_label_index]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelIndexTraits<>>;
+
+    graph_type g1, g2;
+    
+    //a labeled triangle in the pattern
+    g1.addNode({0, {1.0}});
+    g1.addNode({1, {2.0}});
+    g1.addNode({2, {2.0}});
+    g1.addEdge(0, 1); g1.addEdge(1, 2); g1.addEdge(2, 0);
+
+    //a labeled K4 in the host with one node labeled 1.0
+    g2.addNode({0, {1.0}});
+    for(auto i = 1; i < 4; i++)
+        g2.addNode({i, {2.0}});
+    for(auto i = 0; i < 4; i++)
+        for(auto j = i + 1; j < 4; j++)
+            g2.addEdge(i, j);
+
+    //the root is fixed, the two others take 3*2 places
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 6);
+    REQUIRE(YAGL::subgraph_isomorphism(g1, g2).size() == 6);
+
+    //with no node labeled 1.0 left there is nothing to match
+    g2.setData(0, {2.0});
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 0);
+    REQUIRE(YAGL::subgraph_isomorphism(g1, g2).size() == 0);
+}
+
+TEST_CASE("subgraph isomorphism engines agree", "[subgraph_iso_test_engines]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    //small random hosts with two labels and a labeled path plus triangle pattern
+    std::mt19937 gen(42);
+    for(auto trial = 0; trial < 5; trial++)
+    {
+        graph_type g1, g2;
+        
+        for(auto i = 0; i < 4; i++)
+            g1.addNode({i, {double(i % 2)}});
+        g1.addEdge(0, 1); g1.addEdge(1, 2); g1.addEdge(2, 0); g1.addEdge(2, 3);
+
+        std::uniform_int_distribution<int> pick(0, 29);
+        for(auto i = 0; i < 30; i++)
+            g2.addNode({i, {double(pick(gen) % 2)}});
+        for(auto e = 0; e < 90; e++)
+        {
+            auto a = pick(gen), b = pick(gen);
+            if(a != b) g2.addEdge(a, b);
+        }
+
+        auto fast = YAGL::subgraph_isomorphism2(g1, g2);
+        auto keyed = YAGL::keyed_subgraph_isomorphism2(g1, g2);
+        std::sort(fast.begin(), fast.end());
+        std::sort(keyed.begin(), keyed.end());
+        
+        REQUIRE(fast.size() == keyed.size());
+        REQUIRE(fast == keyed);
+    }
+}
+
+TEST_CASE("subgraph isomorphism on long chains", "[subgraph_iso_test_long_chain]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    auto make_chain = [](graph_type& graph, int n) {
+        for(auto i = 0; i < n; i++)
+            graph.addNode({i, {0.0}});
+        for(auto i = 0; i + 1 < n; i++)
+            graph.addEdge(i, i+1);
+    };
+
+    //deep enough to exhaust the call stack of a recursive search
+    graph_type path;
+    make_chain(path, 500000);
+    REQUIRE(YAGL::recursive_dfs2(path, 0).size() == 500000);
+    REQUIRE(YAGL::recursive_dfs2(path, 0, 10).size() == 10);
+
+    //a path maps onto itself forwards and backwards
+    graph_type g1, g2;
+    make_chain(g1, 300);
+    make_chain(g2, 300);
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 2);
+}
+
+TEST_CASE("parallel subgraph isomorphism", "[subgraph_iso_test_parallel]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type g1, g2;
+    
+    //a labeled path pattern over many scattered host copies
+    g1.addNode({0, {0.0}}); g1.addNode({1, {1.0}}); g1.addNode({2, {2.0}});
+    g1.addEdge(0, 1); g1.addEdge(1, 2);
+    
+    auto n = 1000;
+    for(auto i = 0; i < 3*n; i += 3)
+    {
+        g2.addNode({i, {0.0}}); g2.addNode({i+1, {1.0}}); g2.addNode({i+2, {2.0}});
+        g2.addEdge(i, i+1); g2.addEdge(i+1, i+2);
+    }
+    
+    auto serial = YAGL::subgraph_isomorphism2(g1, g2);
+    std::sort(serial.begin(), serial.end());
+    REQUIRE(serial.size() == n);
+
+    for(std::size_t threads : {1, 2, 4})
+    {
+        YAGL::ThreadPool pool(threads);
+        REQUIRE(pool.size() == threads);
+
+        auto parallel = YAGL::subgraph_isomorphism2(g1, g2, pool);
+        std::sort(parallel.begin(), parallel.end());
+        REQUIRE(parallel == serial);
+
+        //the pool can be reused, and works on a frozen host too
+        auto frozen = g2.freeze();
+        REQUIRE(YAGL::subgraph_isomorphism2(g1, frozen, pool).size() == n);
+    }
+
+    //an impossible pattern finds nothing
+    graph_type big;
+    for(auto i = 0; i < 4000; i++) big.addNode({i, {0.0}});
+    YAGL::ThreadPool pool(2);
+    REQUIRE(YAGL::subgraph_isomorphism2(big, g2, pool).empty());
+}
+
+TEST_CASE("streaming subgraph isomorphism", "[subgraph_iso_test_streaming]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using view_type = YAGL::MatchView<key_type>;
+
+    graph_type g1, g2, g3;
+
+    create_complete_k3_graph(g1);
+    create_complete_k4_graph(g2);
+    create_complete_k4_graph(g3);
+
+    //every streamed match is one of the materialized ones
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    std::sort(results.begin(), results.end());
+    
+    std::vector<std::map<key_type, key_type>> streamed;
+    auto count = YAGL::subgraph_isomorphism2(g1, g2, [&](const view_type& match) {
+        REQUIRE(match.size() == 3);
+        streamed.emplace_back(match.begin(), match.end());
+        for(const auto& [v, w] : match)
+            REQUIRE(*match.host(v) == w);
+        REQUIRE(match.host(42) == nullptr);
+    });
+    std::sort(streamed.begin(), streamed.end());
+    REQUIRE(count == 24);
+    REQUIRE(streamed == results);
+
+    //returning false stops the search after that match
+    std::size_t seen = 0;
+    count = YAGL::subgraph_isomorphism2(g1, g2, [&](const view_type&) { 
+        return ++seen < 5; 
+    });
+    REQUIRE(count == 5);
+    REQUIRE(seen == 5);
+    
+    //a stopped search leaves the graphs ready for the next one
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2).size() == 24);
+
+    //the other matchers stream the same way
+    seen = 0;
+    REQUIRE(YAGL::subgraph_isomorphism(g1, g2, [&](const view_type& match) { 
+        REQUIRE(match.size() == 3);
+        seen++; 
+    }) == 24);
+    REQUIRE(seen == 24);
+    REQUIRE(YAGL::subgraph_isomorphism(g1, g2, [](const view_type&) { return false; }) == 1);
+    
+    REQUIRE(YAGL::graph_isomorphism(g2, g3, [](const view_type&) { return true; }) == 24);
+    REQUIRE(YAGL::graph_isomorphism(g2, g3, [](const view_type&) { return false; }) == 1);
+    REQUIRE(YAGL::graph_isomorphism(g1, g3, [](const view_type&) { return true; }) == 0);
+
+    //frozen hosts stream too
+    auto frozen = g2.freeze();
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, frozen, [](const view_type&) { return true; }) == 24);
+}
+
+TEST_CASE("subgraph isomorphism into a match set", "[subgraph_iso_test_match_set]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type g1, g2;
+
+    create_complete_k3_graph(g1);
+    create_complete_k4_graph(g2);
+
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+    std::sort(results.begin(), results.end());
+
+    auto matches = YAGL::subgraph_match_set(g1, g2);
+    REQUIRE(matches.size() == 24);
+    REQUIRE(matches.stride() == 3);
+    REQUIRE(matches.data().size() == 72);
+
+    //the columns are the pattern keys, every row is a distinct image
+    auto columns = matches.columns();
+    std::sort(columns.begin(), columns.end());
+    REQUIRE(columns == std::vector<key_type>{0, 1, 2});
+    for(auto match : matches)
+    {
+        REQUIRE(match[0] != match[1]);
+        REQUIRE(match[1] != match[2]);
+        REQUIRE(g2.adjacent(*match.host(0), *match.host(1)));
+    }
+
+    auto legacy = matches.to_legacy();
+    std::sort(legacy.begin(), legacy.end());
+    REQUIRE(legacy == results);
+
+    YAGL::ThreadPool pool(2);
+    auto parallel = YAGL::subgraph_match_set(g1, g2, pool).to_legacy();
+    std::sort(parallel.begin(), parallel.end());
+    REQUIRE(parallel == results);
+
+    //no matches still leaves the columns
+    graph_type empty_host;
+    auto none = YAGL::subgraph_match_set(g1, empty_host);
+    REQUIRE(none.empty());
+    REQUIRE(none.stride() == 3);
+}
+
+TEST_CASE("subgraph isomorphism existence, counts and first matches", "[subgraph_iso_test_early_stop]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type g1, g2, g3;
+
+    create_complete_k3_graph(g1);
+    create_complete_k4_graph(g2);
+    
+    //a path has no triangles
+    for(auto i = 0; i < 5; i++) g3.addNode({i, {0.0}});
+    for(auto i = 0; i < 4; i++) g3.addEdge(i, i+1);
+
+    REQUIRE(YAGL::match_exists(g1, g2));
+    REQUIRE(!YAGL::match_exists(g1, g3));
+    
+    REQUIRE(YAGL::count_matches(g1, g2) == 24);
+    REQUIRE(YAGL::count_matches(g1, g3) == 0);
+    REQUIRE(YAGL::count_matches(g1, g1) == 6);
+
+    auto results = YAGL::subgraph_isomorphism2(g1, g2);
+
+    //the first k are the first k the full search finds
+    auto first = YAGL::find_first_k(g1, g2, 5);
+    REQUIRE(first.size() == 5);
+    for(std::size_t i = 0; i < first.size(); i++)
+        REQUIRE(first[i].to_map() == results[i]);
+    
+    REQUIRE(YAGL::find_first_k(g1, g2, 0).empty());
+    REQUIRE(YAGL::find_first_k(g1, g2, 100).size() == 24);
+    REQUIRE(YAGL::find_first_k(g1, g3, 3).empty());
+
+    //the matcher state is left clean for the next search
+    REQUIRE(YAGL::count_matches(g1, g2) == 24);
+    
+    auto frozen = g2.freeze();
+    REQUIRE(YAGL::match_exists(g1, frozen));
+    REQUIRE(YAGL::count_matches(g1, frozen) == 24);
+}
+
+TEST_CASE("subgraph isomorphism with symmetry breaking", "[subgraph_iso_test_symmetry]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+    using matcher_type = YAGL::SubgraphMatcher<graph_type, graph_type>;
+
+    graph_type g1, g2;
+
+    create_complete_k3_graph(g1);
+    create_complete_k4_graph(g2);
+
+    //a triangle has 6 automorphisms and k4 has 4 distinct triangles
+    matcher_type matcher(g1, g2);
+    matcher.break_symmetries();
+    REQUIRE(matcher.automorphism_count() == 6);
+
+    REQUIRE(YAGL::count_matches(g1, g2, YAGL::break_symmetry) == 4);
+    
+    auto results = YAGL::subgraph_isomorphism2(g1, g2, YAGL::break_symmetry);
+    REQUIRE(results.size() == 4);
+    std::vector<std::vector<key_type>> triangles;
+    for(const auto& M : results)
+    {
+        std::vector<key_type> image;
+        for(const auto& [v, w] : M) image.push_back(w);
+        std::sort(image.begin(), image.end());
+        triangles.push_back(image);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    REQUIRE(std::unique(triangles.begin(), triangles.end()) == triangles.end());
+
+    REQUIRE(YAGL::subgraph_match_set(g1, g2, YAGL::break_symmetry).size() == 4);
+    REQUIRE(YAGL::subgraph_isomorphism2(g1, g2, [](const auto&) {}, YAGL::break_symmetry) == 4);
+
+    //every distinct embedding, as a set of host edges, shows up exactly once
+    //for a triangle with two tails and for a 4 cycle with labels breaking
+    //part of its symmetry
+    auto embedding = [](graph_type& pattern, const std::map<key_type, key_type>& M) {
+        std::vector<std::pair<key_type, key_type>> edges;
+        for(const auto& [u, node_u] : pattern.getNodeSetRef())
+            for(const auto& v : pattern.out_neighbors(u))
+                edges.emplace_back(std::min(M.at(u), M.at(v)), std::max(M.at(u), M.at(v)));
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        return edges;
+    };
+
+    graph_type tails, square;
+    for(auto i = 0; i < 5; i++) tails.addNode({i, {0.0}});
+    tails.addEdge(0, 1); tails.addEdge(1, 2); tails.addEdge(2, 0); tails.addEdge(1, 3); tails.addEdge(2, 4);
+    for(auto i = 0; i < 4; i++) square.addNode({i, {double(i % 2)}});
+    for(auto i = 0; i < 4; i++) square.addEdge(i, (i + 1) % 4);
+
+    std::mt19937 gen(7);
+    for(auto trial = 0; trial < 5; trial++)
+    {
+        graph_type host;
+        std::uniform_int_distribution<int> pick(0, 24);
+        for(auto i = 0; i < 25; i++)
+            host.addNode({i, {double(pick(gen) % 2)}});
+        for(auto e = 0; e < 70; e++)
+        {
+            auto a = pick(gen), b = pick(gen);
+            if(a != b) host.addEdge(a, b);
+        }
+
+        for(auto* pattern : {&tails, &square})
+        {
+            std::set<std::vector<std::pair<key_type, key_type>>> distinct;
+            for(const auto& M : YAGL::subgraph_isomorphism2(*pattern, host))
+                distinct.insert(embedding(*pattern, M));
+
+            auto broken = YAGL::subgraph_isomorphism2(*pattern, host, YAGL::break_symmetry);
+            std::set<std::vector<std::pair<key_type, key_type>>> seen;
+            for(const auto& M : broken)
+                seen.insert(embedding(*pattern, M));
+
+            REQUIRE(broken.size() == distinct.size());
+            REQUIRE(seen == distinct);
+        }
+    }
+
+    //the labeled square only swaps its two label 0 and two label 1 corners
+    matcher_type labeled(square, g2);
+    labeled.break_symmetries();
+    REQUIRE(labeled.automorphism_count() == 4);
+}
+
+TEST_CASE("subgraph isomorphism matching order", "[subgraph_iso_test_matching_order]")
+{
+    //label frequencies come from the host's label column here
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelColumnTraits<>>;
+    using matcher_type = YAGL::SubgraphMatcher<graph_type, graph_type>;
+
+    //a labeled star with a tail, built in two different insertion orders
+    graph_type forward, backward, host;
+    std::vector<std::pair<key_type, double>> nodes{{0, 0.0}, {1, 0.0}, {2, 1.0}, {3, 0.0}, {4, 2.0}};
+    std::vector<std::pair<key_type, key_type>> edges{{0, 1}, {0, 2}, {0, 3}, {3, 4}};
+    for(auto& [k, t] : nodes) forward.addNode({k, {t}});
+    for(auto& [a, b] : edges) forward.addEdge(a, b);
+    for(auto i = nodes.size(); i-- > 0;) backward.addNode({nodes[i].first, {nodes[i].second}});
+    for(auto i = edges.size(); i-- > 0;) backward.addEdge(edges[i].first, edges[i].second);
+
+    //label 2 is rare in the host, label 0 common
+    for(auto i = 0; i < 200; i++) host.addNode({i, {i % 50 == 0 ? 2.0 : (i % 3 == 0 ? 1.0 : 0.0)}});
+    for(auto i = 0; i + 1 < 200; i++) host.addEdge(i, i+1);
+    for(auto i = 0; i + 3 < 200; i += 3) host.addEdge(i, i+3);
+
+    matcher_type a(forward, host), b(backward, host);
+    auto order = a.pattern_keys();
+    REQUIRE(order == b.pattern_keys());
+    
+    //the rarest label goes first, then every vertex hangs off the ones before
+    REQUIRE(order.size() == 5);
+    REQUIRE(order[0] == 4);
+    for(std::size_t i = 1; i < order.size(); i++)
+    {
+        bool anchored = false;
+        for(std::size_t j = 0; j < i; j++)
+            anchored = anchored || forward.adjacent(order[i], order[j]);
+        REQUIRE(anchored);
+    }
+    
+    auto results = YAGL::subgraph_isomorphism2(forward, host);
+    auto keyed = YAGL::keyed_subgraph_isomorphism2(forward, host);
+    std::sort(results.begin(), results.end());
+    std::sort(keyed.begin(), keyed.end());
+    REQUIRE(results == keyed);
+    REQUIRE(YAGL::count_matches(backward, host) == results.size());
+
+    //the old matcher follows the same kind of plan and agrees
+    auto planned = YAGL::subgraph_isomorphism(forward, host);
+    std::sort(planned.begin(), planned.end());
+    REQUIRE(planned == results);
+
+    //a plain host counts its labels from the payloads and plans the same
+    YAGL::Graph<key_type, data_type> plain_pattern, plain_host;
+    for(auto& [k, t] : nodes) plain_pattern.addNode({k, {t}});
+    for(auto& [a, b] : edges) plain_pattern.addEdge(a, b);
+    for(auto i = 0; i < 200; i++) plain_host.addNode({i, {host[i].type}});
+    for(auto i = 0; i + 1 < 200; i++) plain_host.addEdge(i, i+1);
+    for(auto i = 0; i + 3 < 200; i += 3) plain_host.addEdge(i, i+3);
+    YAGL::SubgraphMatcher<decltype(plain_pattern), decltype(plain_host)> plain(plain_pattern, plain_host);
+    REQUIRE(plain.pattern_keys() == order);
+
+    //with a single label there is nothing to count and the plan starts
+    //from the highest degree
+    YAGL::Graph<key_type, data_type> one_label, k4;
+    for(auto& [k, t] : nodes) one_label.addNode({k, {0.0}});
+    for(auto& [a, b] : edges) one_label.addEdge(a, b);
+    create_complete_k4_graph(k4);
+    YAGL::SubgraphMatcher<decltype(one_label), decltype(k4)> by_degree(one_label, k4);
+    REQUIRE(by_degree.pattern_keys()[0] == 0);
+}
+
+TEST_CASE("subgraph isomorphism of disconnected patterns", "[subgraph_iso_test_disconnected]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type>;
+
+    graph_type host;
+    create_complete_k4_graph(host);
+    host.addNode({4, {1.0}});
+    host.addNode({5, {1.0}});
+    host.addEdge(4, 5);
+
+    //two isolated vertices map to any ordered pair of distinct hosts
+    graph_type pair;
+    pair.addNode({0, {0.0}});
+    pair.addNode({1, {0.0}});
+    REQUIRE(YAGL::count_matches(pair, host) == 4 * 3);
+    REQUIRE(YAGL::count_matches(pair, host, YAGL::break_symmetry) == 6);
+
+    //an edge of each label, the components never share a host vertex
+    graph_type two_edges;
+    two_edges.addNode({0, {0.0}}); two_edges.addNode({1, {0.0}});
+    two_edges.addNode({2, {1.0}}); two_edges.addNode({3, {1.0}});
+    two_edges.addEdge(0, 1); two_edges.addEdge(2, 3);
+    
+    auto results = YAGL::subgraph_isomorphism2(two_edges, host);
+    REQUIRE(results.size() == 12 * 2);
+    for(const auto& M : results)
+    {
+        REQUIRE(host.adjacent(M.at(0), M.at(1)));
+        REQUIRE(M.at(2) >= 4);
+        REQUIRE(M.at(2) != M.at(3));
+    }
+    REQUIRE(YAGL::subgraph_isomorphism(two_edges, host).size() == 24);
+
+    //a triangle next to a label 1 vertex
+    graph_type apart;
+    create_complete_k3_graph(apart);
+    apart.addNode({3, {1.0}});
+    REQUIRE(YAGL::count_matches(apart, host) == 24 * 2);
+    REQUIRE(YAGL::count_matches(apart, host, YAGL::break_symmetry) == 4 * 2);
+
+    //the key based matcher orders every component too and finds the same
+    auto engines_agree = [](auto& pattern, auto& target) {
+        auto dense = YAGL::subgraph_isomorphism2(pattern, target);
+        auto keyed = YAGL::keyed_subgraph_isomorphism2(pattern, target);
+        std::sort(dense.begin(), dense.end());
+        std::sort(keyed.begin(), keyed.end());
+        return !dense.empty() && dense == keyed;
+    };
+    REQUIRE(engines_agree(pair, host));
+    REQUIRE(engines_agree(two_edges, host));
+    REQUIRE(engines_agree(apart, host));
+    REQUIRE(YAGL::keyed_subgraph_isomorphism2(apart, host).size() == 24 * 2);
+
+    //two edges into one vertex, a search along out edges from 0 never
+    //reaches 2
+    using directed_type = YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<>>;
+    directed_type into, directed_host;
+    into.addNode({0, {0.0}}); into.addNode({1, {1.0}}); into.addNode({2, {0.0}});
+    into.addEdge(0, 1); into.addEdge(2, 1);
+    for(auto i = 0; i < 6; i++)
+        directed_host.addNode({i, {double(i % 2)}});
+    for(auto i = 0; i < 6; i++)
+        for(auto j = 0; j < 6; j++)
+            if(i % 2 != j % 2) directed_host.addEdge(i, j);
+    REQUIRE(engines_agree(into, directed_host));
+    REQUIRE(YAGL::keyed_subgraph_isomorphism2(into, directed_host).size() == 3 * 3 * 2);
+}
+
+TEST_CASE("subgraph isomorphism with edge labels", "[subgraph_iso_test_edge_labels]")
+{
+    struct Bond { int type; };
+
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::EdgeDataTraits<Bond>>;
+
+    static_assert(YAGL::has_edge_labels_v<graph_type>);
+
+    //a k4 whose triangle 0 1 2 has two edges of type 1, the rest are type 2
+    graph_type host;
+    for(int i = 0; i < 4; i++)
+        host.addNode({i, {0.0}});
+    host.addEdge(0, 1, Bond{1}); host.addEdge(1, 2, Bond{1});
+    host.addEdge(2, 0, Bond{2}); host.addEdge(0, 3, Bond{2}); 
+    host.addEdge(1, 3, Bond{2}); host.addEdge(2, 3, Bond{2});
+
+    auto make_triangle = [](graph_type& graph) {
+        for(int i = 0; i < 3; i++)
+            graph.addNode({i, {0.0}});
+        graph.addEdge(0, 1); graph.addEdge(1, 2); graph.addEdge(2, 0);
+    };
+
+    auto agree = [&](graph_type& pattern, const auto& results) {
+        for(const auto& M : results)
+        {
+            for(const auto& [a, b] : M)
+            {
+                for(const auto& [c, d] : M)
+                {
+                    const auto* want = pattern.getEdgeData(a, c);
+                    if(!want) continue;
+                    REQUIRE(host.getEdgeData(b, d) != nullptr);
+                    REQUIRE(host.getEdgeData(b, d)->type == want->type);
+                }
+            }
+        }
+    };
+
+    SECTION("fully labeled patterns only match edges of the same type") {
+        graph_type triangle;
+        make_triangle(triangle);
+        triangle.setEdgeData(0, 1, Bond{1});
+        triangle.setEdgeData(1, 2, Bond{1});
+        triangle.setEdgeData(2, 0, Bond{2});
+
+        auto results = YAGL::subgraph_isomorphism2(triangle, host);
+        REQUIRE(results.size() == 2);
+        for(const auto& M : results)
+            REQUIRE(M.at(1) == 1);
+        agree(triangle, results);
+
+        REQUIRE(YAGL::subgraph_isomorphism(triangle, host).size() == 2);
+        REQUIRE(YAGL::count_matches(triangle, host) == 2);
+    }
+
+    SECTION("pattern edges without a payload match any edge") {
+        graph_type triangle;
+        make_triangle(triangle);
+        triangle.setEdgeData(0, 1, Bond{1});
+
+        auto results = YAGL::subgraph_isomorphism2(triangle, host);
+        REQUIRE(results.size() == 8);
+        agree(triangle, results);
+
+        auto old_results = YAGL::subgraph_isomorphism(triangle, host);
+        std::sort(results.begin(), results.end());
+        std::sort(old_results.begin(), old_results.end());
+        REQUIRE(results == old_results);
+
+        //with no labels left every triangle matches
+        graph_type plain;
+        make_triangle(plain);
+        REQUIRE(YAGL::count_matches(plain, host) == 24);
+    }
+
+    SECTION("labels no host edge carries match nothing") {
+        graph_type edge;
+        edge.addNode({0, {0.0}}); edge.addNode({1, {0.0}});
+        edge.addEdge(0, 1, Bond{3});
+
+        REQUIRE_FALSE(YAGL::match_exists(edge, host));
+        REQUIRE(YAGL::subgraph_isomorphism(edge, host).empty());
+    }
+
+    SECTION("labeled patterns need a labeled host") {
+        using plain_type = YAGL::Graph<key_type, data_type>;
+
+        //the other way around would ignore the pattern's labels, so the
+        //matchers refuse to compile it
+        static_assert(!YAGL::edge_labels_comparable_v<graph_type, plain_type>);
+        static_assert(YAGL::edge_labels_comparable_v<plain_type, graph_type>);
+        static_assert(YAGL::edge_labels_comparable_v<plain_type, plain_type>);
+
+        //an unlabeled pattern takes any host edge
+        plain_type triangle;
+        for(int i = 0; i < 3; i++)
+            triangle.addNode({i, {0.0}});
+        triangle.addEdge(0, 1); triangle.addEdge(1, 2); triangle.addEdge(2, 0);
+        REQUIRE(YAGL::count_matches(triangle, host) == 24);
+        REQUIRE(YAGL::keyed_subgraph_isomorphism2(triangle, host).size() == 24);
+    }
+}
+
+TEST_CASE("subgraph isomorphism on directed graphs", "[subgraph_iso_test_directed]")
+{
+    using key_type = int; using data_type = NodeType;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::DirectedTraits<>>;
+
+    //a directed triangle with one edge leaving it
+    graph_type host;
+    for(int i = 0; i < 4; i++)
+        host.addNode({i, {0.0}});
+    host.addEdge(0, 1); host.addEdge(1, 2); host.addEdge(2, 0); host.addEdge(2, 3);
+
+    auto same = [](auto a, auto b) {
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        return a == b;
+    };
+
+    SECTION("cycles only match along their direction") {
+        graph_type cycle;
+        for(int i = 0; i < 3; i++)
+            cycle.addNode({i, {0.0}});
+        cycle.addEdge(0, 1); cycle.addEdge(1, 2); cycle.addEdge(2, 0);
+
+        auto results = YAGL::subgraph_isomorphism2(cycle, host);
+        REQUIRE(results.size() == 3);
+        for(const auto& M : results)
+            for(const auto& [u, w] : M)
+                REQUIRE(host.adjacent(w, M.at((u + 1) % 3)));
+        REQUIRE(same(results, YAGL::subgraph_isomorphism(cycle, host)));
+        REQUIRE(YAGL::count_matches(cycle, host, YAGL::break_symmetry) == 1);
+    }
+
+    SECTION("paths follow the edges") {
+        graph_type path;
+        for(int i = 0; i < 3; i++)
+            path.addNode({i, {0.0}});
+        path.addEdge(0, 1); path.addEdge(1, 2);
+
+        auto results = YAGL::subgraph_isomorphism2(path, host);
+        REQUIRE(results.size() == 4);
+        for(const auto& M : results)
+        {
+            REQUIRE(host.adjacent(M.at(0), M.at(1)));
+            REQUIRE(host.adjacent(M.at(1), M.at(2)));
+        }
+        REQUIRE(same(results, YAGL::subgraph_isomorphism(path, host)));
+
+        //two edges into one vertex have no match
+        graph_type in_star;
+        for(int i = 0; i < 3; i++)
+            in_star.addNode({i, {0.0}});
+        in_star.addEdge(0, 2); in_star.addEdge(1, 2);
+        REQUIRE_FALSE(YAGL::match_exists(in_star, host));
+    }
+}
@@ -0,0 +1,170 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include "YAGL_Journal.hpp"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+struct Bond
+{
+    int type;
+};
+
+using key_type = int; using data_type = double;
+using graph_type = YAGL::Graph<key_type, data_type, YAGL::JournalTraits<YAGL::EdgeDataTraits<Bond>>>;
+using node_type = YAGL::Node<key_type, data_type>;
+
+//everything a replay has to reproduce, nodes with data and edges with payloads
+auto snapshot(graph_type& graph)
+{
+    std::set<std::pair<key_type, data_type>> nodes;
+    std::set<std::tuple<key_type, key_type, int>> edges;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+    {
+        nodes.emplace(iter->first, iter->second.getData());
+        for(const auto& nbr : graph.out_neighbors(iter->first))
+        {
+            const auto* bond = graph.getEdgeData(iter->first, nbr);
+            edges.emplace(iter->first, nbr, bond ? bond->type : -1);
+        }
+    }
+    return std::make_pair(nodes, edges);
+}
+
+void random_edits(graph_type& graph, std::mt19937& gen, int count)
+{
+    std::uniform_int_distribution<key_type> pick(0, 14);
+    std::uniform_int_distribution<int> action(0, 7);
+    for(int edit = 0; edit < count; edit++)
+    {
+        auto u = pick(gen), v = pick(gen);
+        switch(action(gen))
+        {
+            case 0: graph.addNode(node_type(u, double(v))); break;
+            case 1: if(graph.findNode(u) != graph.node_list_end()) graph.removeNode(graph.findNode(u)->second); break;
+            case 2: graph.setData(u, double(v)); break;
+            case 3: graph.removeEdge(u, v); break;
+            case 4: graph.addEdge(u, v, Bond{v % 3}); break;
+            case 5: graph.setEdgeData(u, v, Bond{u % 3}); break;
+            default: graph.addEdge(u, v); break;
+        }
+    }
+}
+
+TEST_CASE("journals record changes with epochs", "[journal_test]")
+{
+    static_assert(graph_type::has_journal);
+    static_assert(!YAGL::Graph<key_type, data_type>::has_journal);
+
+    graph_type graph;
+    REQUIRE(graph.epoch() == 0);
+    REQUIRE(graph.changes_since(0).empty());
+
+    graph.addNode(node_type(1, 0.5));
+    graph.addNode(node_type(2, 0.5));
+    auto seen = graph.epoch();
+    REQUIRE(seen == 2);
+
+    graph.addEdge(1, 2);
+    graph.addEdge(2, 1);
+    graph.setEdgeData(1, 2, Bond{7});
+    graph.setData(2, 1.5);
+    graph.addNode(node_type(1, 2.5));
+    graph.removeNode(graph.findNode(2)->second);
+
+    auto changes = graph.changes_since(seen);
+    std::vector<YAGL::ChangeKind> kinds;
+    for(const auto& c : changes)
+        kinds.push_back(c.kind);
+
+    //the repeated edge is no change, the node replaced in place is new data
+    //and the removed node takes its edge first
+    REQUIRE(kinds == std::vector<YAGL::ChangeKind>{
+        YAGL::ChangeKind::add_edge, YAGL::ChangeKind::set_edge_data, YAGL::ChangeKind::set_data,
+        YAGL::ChangeKind::set_data, YAGL::ChangeKind::remove_edge, YAGL::ChangeKind::remove_node});
+    REQUIRE(changes.begin()->epoch == seen + 1);
+    REQUIRE(changes.begin()[1].edge_data->type == 7);
+    REQUIRE(*changes.begin()[3].data == 2.5);
+    REQUIRE(changes.begin()[5].key_a == 2);
+    REQUIRE(graph.epoch() == seen + 6);
+
+    //consumers that caught up let the journal forget
+    graph.journal().truncate(seen + 3);
+    REQUIRE(graph.journal().base() == seen + 3);
+    REQUIRE(graph.journal().size() == 3);
+    REQUIRE(graph.changes_since(seen + 3).size() == 3);
+    REQUIRE(graph.changes_since(graph.epoch()).empty());
+
+    graph.clear();
+    REQUIRE(graph.changes_since(seen + 6).begin()->kind == YAGL::ChangeKind::clear);
+}
+
+TEST_CASE("journals replay onto copies", "[journal_test]")
+{
+    std::mt19937 gen(17);
+
+    graph_type graph;
+    random_edits(graph, gen, 50);
+
+    //a copy taken now follows the original through the journal
+    graph_type copy_graph = graph;
+    auto seen = graph.epoch();
+
+    for(int round = 0; round < 20; round++)
+    {
+        random_edits(graph, gen, 15);
+        YAGL::apply_changes(copy_graph, graph.changes_since(seen));
+        seen = graph.epoch();
+        REQUIRE(snapshot(copy_graph) == snapshot(graph));
+        REQUIRE(copy_graph.numEdges() == graph.numEdges());
+    }
+}
+
+TEST_CASE("compacted journals keep their net effect", "[journal_test]")
+{
+    std::mt19937 gen(23);
+
+    for(int trial = 0; trial < 30; trial++)
+    {
+        graph_type graph;
+        random_edits(graph, gen, 20);
+
+        graph_type copy_graph = graph;
+        auto base = graph.epoch();
+        graph.journal().truncate(base);
+
+        random_edits(graph, gen, 80);
+        if(trial % 5 == 0) graph.clear();
+        random_edits(graph, gen, 20);
+        auto middle = graph.epoch();
+        random_edits(graph, gen, 20);
+
+        auto before = graph.journal().size();
+        graph.journal().compact(middle);
+        REQUIRE(graph.journal().size() <= before);
+        REQUIRE(graph.epoch() == middle + graph.changes_since(middle).size());
+
+        //the squashed stretch and what came after still lead to the same graph
+        YAGL::apply_changes(copy_graph, graph.changes_since(base));
+        REQUIRE(snapshot(copy_graph) == snapshot(graph));
+    }
+
+    //a node that came and went leaves nothing behind
+    graph_type graph;
+    graph.addNode(node_type(1, 0.5));
+    graph.addNode(node_type(2, 0.5));
+    graph.addEdge(1, 2, Bond{1});
+    graph.setData(2, 1.5);
+    graph.removeNode(graph.findNode(2)->second);
+    graph.journal().compact(graph.epoch());
+
+    auto changes = graph.changes_since(0);
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes.begin()->kind == YAGL::ChangeKind::add_node);
+    REQUIRE(changes.begin()->epoch == graph.epoch());
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Match.hpp"
+
+#include <map>
+#include <vector>
+#include <utility>
+
+TEST_CASE("match views span pattern and host key pairs", "[match_view_test]")
+{
+    using view_type = YAGL::MatchView<int>;
+
+    std::vector<std::pair<int, int>> pairs{{2, 20}, {0, 7}, {1, 11}};
+    view_type match(pairs.data(), pairs.size());
+
+    REQUIRE(match.size() == 3);
+    REQUIRE(!match.empty());
+    REQUIRE(match[1].first == 0);
+    REQUIRE(*match.host(2) == 20);
+    REQUIRE(*match.host(1) == 11);
+    REQUIRE(match.host(3) == nullptr);
+
+    std::map<int, int> as_map(match.begin(), match.end());
+    REQUIRE(as_map == std::map<int, int>{{0, 7}, {1, 11}, {2, 20}});
+
+    REQUIRE(view_type().empty());
+
+    //visitors returning nothing always continue
+    std::size_t calls = 0;
+    auto counter = [&](const view_type&) { calls++; };
+    auto stopper = [&](const view_type&) { calls++; return false; };
+    REQUIRE(YAGL::visit_match(counter, match));
+    REQUIRE(!YAGL::visit_match(stopper, match));
+    REQUIRE(calls == 2);
+}
+
+TEST_CASE("match sets store rows of host keys", "[match_set_test]")
+{
+    using set_type = YAGL::MatchSet<int>;
+
+    set_type matches({3, 1, 2});
+    REQUIRE(matches.stride() == 3);
+    REQUIRE(matches.empty());
+    REQUIRE(matches.size() == 0);
+    REQUIRE(matches.begin() == matches.end());
+
+    REQUIRE(matches.column(1) == 1);
+    REQUIRE(matches.column(5) == matches.stride());
+
+    //rows come in column order, as pairs in any order or filled in place
+    std::vector<int> row{30, 10, 20};
+    matches.push_back(row.begin(), row.end());
+
+    std::vector<std::pair<int, int>> pairs{{1, 11}, {2, 21}, {3, 31}};
+    matches.push_back(YAGL::MatchView<int>(pairs.data(), pairs.size()));
+
+    auto in_place = matches.append_row();
+    in_place[0] = 32; in_place[1] = 12; in_place[2] = 22;
+
+    REQUIRE(matches.size() == 3);
+    REQUIRE(matches.data().size() == 9);
+    REQUIRE(matches[1][0] == 31);
+    REQUIRE(matches[1].pattern_key(0) == 3);
+    REQUIRE(*matches[2].host(1) == 12);
+    REQUIRE(matches[2].host(4) == nullptr);
+    REQUIRE(std::vector<int>(matches[0].begin(), matches[0].end()) == row);
+
+    std::size_t rows = 0;
+    for(auto match : matches)
+    {
+        REQUIRE(match.size() == 3);
+        REQUIRE(*match.host(2) == 20 + int(rows));
+        rows++;
+    }
+    REQUIRE(rows == 3);
+
+    //the legacy list of maps holds the same matches
+    auto legacy = matches.to_legacy();
+    REQUIRE(legacy.size() == 3);
+    REQUIRE(legacy[1] == std::map<int, int>{{1, 11}, {2, 21}, {3, 31}});
+    REQUIRE(legacy[0] == matches[0].to_map());
+
+    //sets with the same columns concatenate
+    set_type more({3, 1, 2});
+    more.push_back(row.begin(), row.end());
+    matches.append(more);
+    REQUIRE(matches.size() == 4);
+    REQUIRE(matches[3].to_map() == legacy[0]);
+
+    matches.clear();
+    REQUIRE(matches.empty());
+    REQUIRE(matches.columns() == std::vector<int>{3, 1, 2});
+
+    //an empty pattern has no rows
+    REQUIRE(set_type().size() == 0);
+}
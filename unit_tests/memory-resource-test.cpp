@@ -0,0 +1,100 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include <vector>
+#include <utility>
+#include <memory_resource>
+#include <atomic>
+#include <cstddef>
+
+// counted by the global operator new in heap-counter.cpp
+extern std::atomic<std::size_t> heap_allocations;
+
+TEST_CASE("graphs can allocate from a memory resource", "[memory_resource_test]")
+{
+    struct LabeledData { int type; };
+
+    //counts what passes through on the way to the heap
+    struct CountingResource : std::pmr::memory_resource
+    {
+        std::size_t live = 0, total = 0, allocations = 0;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            live += bytes; total += bytes; allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, align);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+        {
+            live -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    using key_type = int; using data_type = LabeledData;
+    using graph_type = YAGL::Graph<key_type, data_type, YAGL::LabelIndexTraits<YAGL::DirectedTraits<YAGL::PmrGraphTraits>>>;
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    static_assert(graph_type::has_memory_resource);
+    static_assert(!YAGL::Graph<key_type, data_type>::has_memory_resource);
+
+    CountingResource counting;
+    {
+        //nothing may come from the default resource while the graph is built,
+        //and the only trips to the heap are the ones counting forwards
+        std::vector<std::pair<key_type, key_type>> more{{500, 1}, {500, 2}, {3, 4}};
+        auto previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        auto heap_before = heap_allocations.load();
+
+        graph_type graph(&counting);
+        for(key_type k = 0; k < 100; k++)
+            graph.addNode(node_type(k, {k % 3}));
+        for(key_type k = 0; k < 100; k++)
+            graph.addEdge(k, (k * 7 + 1) % 100);
+        graph.removeNode(graph.findNode(5)->second);
+        graph.addNode(node_type(500, {1}));
+        graph.setData(500, {2});
+        graph.bulk_load(std::vector<node_type>{}, more);
+
+        REQUIRE(heap_allocations.load() - heap_before == counting.allocations);
+        REQUIRE(graph.memory_resource() == &counting);
+        REQUIRE(graph.numNodes() == 100);
+        REQUIRE(graph.numEdges() == 101);
+        REQUIRE(graph.label_count(2) == 33);
+        REQUIRE(counting.live > 0);
+
+        std::pmr::set_default_resource(previous);
+
+        //copies go to the default resource and leave the original alone
+        auto before = counting.total;
+        graph_type copy_graph = graph;
+        REQUIRE(counting.total == before);
+        REQUIRE(copy_graph.memory_resource() == std::pmr::get_default_resource());
+        copy_graph.addNode(node_type(600, {0}));
+        REQUIRE(counting.total == before);
+        REQUIRE(copy_graph.numEdges() == 101);
+
+        graph.clear();
+        graph.addNode(node_type(1, {0}));
+        REQUIRE(counting.total > before);
+    }
+    REQUIRE(counting.live == 0);
+
+    //an arena hands everything back at once
+    std::pmr::monotonic_buffer_resource arena;
+    for(int round = 0; round < 3; round++)
+    {
+        {
+            graph_type scratch(&arena);
+            for(key_type k = 0; k < 50; k++)
+                scratch.addNode(node_type(k, {0}));
+            for(key_type k = 1; k < 50; k++)
+                scratch.addEdge(k - 1, k);
+            REQUIRE(scratch.numEdges() == 49);
+            REQUIRE(scratch.out_neighbors(10).size() == 1);
+        }
+        arena.release();
+    }
+}
@@ -4,6 +4,8 @@
 #include "YAGL_Node.hpp"
 
 #include <type_traits>
+#include <vector>
+#include <utility>
 
 TEST_CASE("Type Node Test", "[node test]")
 {    
@@ -70,3 +72,22 @@ TEST_CASE("Node Copy Constructor Test", "[node test]")
     
     std::cout << node;
 }
+
+TEST_CASE("Node payloads can be moved or built in place", "[node test]")
+{    
+    using key_type = std::size_t;
+    using data_type = std::vector<double>;
+    
+    using node_type = YAGL::Node<key_type, data_type>;
+
+    data_type data(10, 2.6);
+    node_type moved(1, std::move(data));
+    REQUIRE(moved.getData().size() == 10);
+
+    node_type built(2, std::in_place, 5, 1.0);
+    REQUIRE(built.getKey() == 2);
+    REQUIRE(built.getData().size() == 5);
+
+    const node_type& ref = built;
+    REQUIRE(ref.getData()[4] == 1.0);
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Graph.hpp"
+#include "YAGL_Persistent_Graph.hpp"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+using key_type = int; using data_type = double;
+using node_type = YAGL::Node<key_type, data_type>;
+
+//nodes with data and edges, what two graphs have to agree on
+template <typename GraphType>
+auto contents(const GraphType& graph)
+{
+    std::set<std::pair<key_type, data_type>> nodes;
+    std::set<std::pair<key_type, key_type>> edges;
+    for(typename GraphType::id_type id = 0; id < graph.id_bound(); id++)
+    {
+        if(!graph.has_id(id)) continue;
+        auto key = graph.node_key(id);
+        nodes.emplace(key, graph.findNode(key)->getData());
+        for(const auto& nbr : graph.out_neighbors(key))
+            edges.emplace(key, nbr);
+    }
+    return std::make_pair(nodes, edges);
+}
+
+template <typename GraphType>
+auto graph_contents(GraphType& graph)
+{
+    std::set<std::pair<key_type, data_type>> nodes;
+    std::set<std::pair<key_type, key_type>> edges;
+    for(auto iter = graph.node_list_begin(); iter != graph.node_list_end(); iter++)
+    {
+        nodes.emplace(iter->first, iter->second.getData());
+        for(const auto& nbr : graph.out_neighbors(iter->first))
+            edges.emplace(iter->first, nbr);
+    }
+    return std::make_pair(nodes, edges);
+}
+
+template <typename PersistentType, typename GraphType>
+void random_edits(PersistentType& persistent, GraphType& graph, std::mt19937& gen, int count)
+{
+    std::uniform_int_distribution<key_type> pick(0, 39);
+    std::uniform_int_distribution<int> action(0, 6);
+    for(int edit = 0; edit < count; edit++)
+    {
+        auto u = pick(gen), v = pick(gen);
+        switch(action(gen))
+        {
+            case 0:
+                persistent.addNode(node_type(u, double(v)));
+                graph.addNode(node_type(u, double(v)));
+                break;
+            case 1:
+                persistent.removeNode(node_type(u, 0.0));
+                if(graph.findNode(u) != graph.node_list_end()) graph.removeNode(graph.findNode(u)->second);
+                break;
+            case 2:
+                persistent.setData(u, double(v));
+                graph.setData(u, double(v));
+                break;
+            case 3:
+                persistent.removeEdge(u, v);
+                graph.removeEdge(u, v);
+                break;
+            default:
+                persistent.addEdge(u, v);
+                graph.addEdge(u, v);
+                break;
+        }
+    }
+}
+
+TEST_CASE("persistent graphs behave like graphs", "[persistent_graph_test]")
+{
+    using persistent_type = YAGL::PersistentGraph<key_type, data_type, YAGL::SmallNeighborTraits<4>, 8>;
+    using directed_type = YAGL::PersistentGraph<key_type, data_type, YAGL::DirectedTraits<>, 8>;
+
+    persistent_type persistent;
+    persistent.addNode(node_type(1, 0.5));
+    persistent.addNode(node_type(2, 1.5));
+    persistent.addNode(node_type(3, 2.5));
+    persistent.addEdge(1, 2);
+    persistent.addEdge(2, 1);
+    persistent.addEdge(2, 3);
+    persistent.addEdge(2, 42);
+
+    REQUIRE(persistent.numNodes() == 3);
+    REQUIRE(persistent.numEdges() == 2);
+    REQUIRE(persistent.adjacent(3, 2));
+    REQUIRE(!persistent.adjacent(1, 3));
+    REQUIRE(persistent.degree(2) == 2);
+    std::vector<key_type> nbrs(persistent.out_neighbors(2).begin(), persistent.out_neighbors(2).end());
+    REQUIRE(nbrs == std::vector<key_type>{1, 3});
+
+    //the node replaced in place keeps its id and edges
+    auto id = persistent.node_id(1);
+    persistent.addNode(node_type(1, 9.5));
+    REQUIRE(persistent.node_id(1) == id);
+    REQUIRE(persistent.findNode(1)->getData() == 9.5);
+    REQUIRE(persistent.adjacent(1, 2));
+
+    //removed ids are recycled
+    persistent.removeNode(node_type(2, 0.0));
+    REQUIRE(persistent.findNode(2) == nullptr);
+    REQUIRE(persistent.numEdges() == 0);
+    persistent.addNode(node_type(4, 0.0));
+    REQUIRE(persistent.node_id(4) == id + 1);
+
+    directed_type directed;
+    directed.addNode(node_type(1, 0.0));
+    directed.addNode(node_type(2, 0.0));
+    directed.addEdge(1, 2);
+    REQUIRE(directed.adjacent(1, 2));
+    REQUIRE(!directed.adjacent(2, 1));
+    REQUIRE(directed.in_neighbors(2).size() == 1);
+    directed.removeNode(node_type(2, 0.0));
+    REQUIRE(directed.out_neighbors(1).empty());
+
+    //random edits against an ordinary graph, through conversions both ways
+    std::mt19937 gen(3);
+    persistent.clear();
+    YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<4>> graph;
+    for(int round = 0; round < 20; round++)
+    {
+        random_edits(persistent, graph, gen, 40);
+        REQUIRE(contents(persistent) == graph_contents(graph));
+        REQUIRE(persistent.numNodes() == graph.numNodes());
+        REQUIRE(persistent.numEdges() == graph.numEdges());
+    }
+
+    auto converted = persistent.to_graph();
+    REQUIRE(graph_contents(converted) == graph_contents(graph));
+    persistent_type back(graph);
+    REQUIRE(contents(back) == contents(persistent));
+    REQUIRE(back.numEdges() == persistent.numEdges());
+}
+
+TEST_CASE("persistent graph snapshots share what did not change", "[persistent_graph_test]")
+{
+    using persistent_type = YAGL::PersistentGraph<key_type, data_type, YAGL::SmallNeighborTraits<4>, 8>;
+
+    persistent_type graph;
+    for(key_type k = 0; k < 64; k++)
+        graph.addNode(node_type(k, 0.0));
+    for(key_type k = 0; k < 63; k++)
+        graph.addEdge(k, k + 1);
+
+    //the snapshot shares everything until the graph moves on
+    persistent_type snapshot = graph;
+    for(persistent_type::id_type id = 0; id < 64; id++)
+        REQUIRE(snapshot.shares_node(graph, id));
+
+    //one edge clones the chunks of its two ends
+    graph.addEdge(0, 63);
+    graph.setData(1, 5.0);
+    std::size_t shared = 0;
+    for(persistent_type::id_type id = 0; id < 64; id++)
+        shared += snapshot.shares_node(graph, id);
+    REQUIRE(shared == 64 - 2 * 8);
+
+    //repeating an edge changes nothing and clones nothing
+    persistent_type again = graph;
+    graph.addEdge(10, 11);
+    REQUIRE(again.shares_node(graph, 10));
+
+    //growing the key table splits one bucket per node, eight nodes split
+    //the first chunk of buckets and the others stay shared
+    persistent_type before = graph;
+    std::size_t buckets = graph.bucket_count();
+    for(key_type k = 64; k < 72; k++)
+        graph.addNode(node_type(k, 0.0));
+    REQUIRE(graph.bucket_count() > buckets);
+    std::size_t shared_buckets = 0;
+    for(std::size_t b = 0; b < buckets; b++)
+        shared_buckets += before.shares_bucket(graph, b);
+    REQUIRE(shared_buckets == buckets - 8);
+    for(key_type k = 0; k < 72; k++)
+        REQUIRE(graph.findNode(k) != nullptr);
+    REQUIRE(before.findNode(64) == nullptr);
+    for(key_type k = 64; k < 72; k++)
+        graph.removeNode(node_type(k, 0.0));
+
+    REQUIRE(!snapshot.adjacent(0, 63));
+    REQUIRE(snapshot.findNode(1)->getData() == 0.0);
+    REQUIRE(graph.adjacent(0, 63));
+
+    //rolling back is a copy
+    std::mt19937 gen(8);
+    std::vector<persistent_type> history{graph};
+    std::vector<decltype(contents(graph))> expected{contents(graph)};
+    YAGL::Graph<key_type, data_type, YAGL::SmallNeighborTraits<4>> mirror;
+    for(int step = 0; step < 15; step++)
+    {
+        random_edits(graph, mirror, gen, 20);
+        history.push_back(graph);
+        expected.push_back(contents(graph));
+    }
+    for(std::size_t step = 0; step < history.size(); step++)
+        REQUIRE(contents(history[step]) == expected[step]);
+
+    graph = history[3];
+    REQUIRE(contents(graph) == expected[3]);
+    graph.clear();
+    REQUIRE(contents(history[3]) == expected[3]);
+}
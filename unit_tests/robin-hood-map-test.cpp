@@ -0,0 +1,193 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Robin_Hood_Map.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+TEST_CASE("robin hood maps insert, find and assign", "[robin_hood_map_test]")
+{    
+    using map_type = YAGL::RobinHoodMap<int, std::string>;
+
+    map_type map;
+
+    REQUIRE(map.empty());
+    REQUIRE(map.find(1) == map.end());
+    REQUIRE(map.begin() == map.end());
+
+    REQUIRE(map.try_emplace(1, "one").second == true);
+    REQUIRE(map.emplace(2, "two").second == true);
+    REQUIRE(map.try_emplace(1, "uno").second == false);
+    REQUIRE(map.find(1)->second == "one");
+
+    auto [iter, inserted] = map.insert_or_assign(1, "uno");
+    REQUIRE(inserted == false);
+    REQUIRE(iter->second == "uno");
+
+    map[3] = "three";
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.count(3) == 1);
+    REQUIRE(map.count(4) == 0);
+
+    std::vector<int> keys;
+    for(auto& [k, v] : map)
+        keys.push_back(k);
+    std::sort(keys.begin(), keys.end());
+    REQUIRE(keys == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("robin hood maps grow, erase and shrink", "[robin_hood_map_test]")
+{    
+    using map_type = YAGL::RobinHoodMap<int, int>;
+
+    map_type map;
+
+    //strided keys collide badly under the identity hash without mixing
+    for(int i = 0; i < 10000; i++)
+        map.insert_or_assign(i * 1024, i);
+
+    REQUIRE(map.size() == 10000);
+    REQUIRE(map.load_factor() <= map.max_load_factor());
+    for(int i = 0; i < 10000; i++)
+        REQUIRE(map.find(i * 1024)->second == i);
+
+    //erase every other key, the runs behind them shift back
+    for(int i = 0; i < 10000; i += 2)
+        REQUIRE(map.erase(i * 1024) == 1);
+    REQUIRE(map.erase(0) == 0);
+    REQUIRE(map.size() == 5000);
+
+    bool all_found = true;
+    for(int i = 0; i < 10000; i++)
+    {
+        bool found = map.find(i * 1024) != map.end();
+        if(found != (i % 2 == 1)) all_found = false;
+    }
+    REQUIRE(all_found);
+
+    std::size_t visited = 0;
+    for(const auto& kv : map)
+    {
+        REQUIRE(kv.second * 1024 == kv.first);
+        visited++;
+    }
+    REQUIRE(visited == 5000);
+
+    SECTION("rehash to zero shrinks to fit") {
+        auto before = map.bucket_count();
+        map.rehash(0);
+        REQUIRE(map.bucket_count() < before);
+        REQUIRE(map.size() == 5000);
+        REQUIRE(map.find(1024)->second == 1);
+    }
+
+    SECTION("reserve makes room up front") {
+        map_type reserved;
+        reserved.reserve(1000);
+        auto buckets = reserved.bucket_count();
+        for(int i = 0; i < 1000; i++)
+            reserved.try_emplace(i, i);
+        REQUIRE(reserved.bucket_count() == buckets);
+    }
+
+    SECTION("clearing keeps the table usable") {
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(map.begin() == map.end());
+        map.try_emplace(5, 5);
+        REQUIRE(map.size() == 1);
+    }
+}
+
+TEST_CASE("robin hood maps can be copied and moved", "[robin_hood_map_test]")
+{    
+    using map_type = YAGL::RobinHoodMap<std::string, std::vector<int>>;
+
+    map_type map;
+    for(int i = 0; i < 100; i++)
+        map.try_emplace(std::to_string(i), std::vector<int>(3, i));
+
+    map_type copy = map;
+    REQUIRE(copy.size() == 100);
+    REQUIRE(copy.find("42")->second == std::vector<int>(3, 42));
+
+    //the copy is independent
+    copy.erase("42");
+    REQUIRE(map.count("42") == 1);
+
+    map_type moved = std::move(copy);
+    REQUIRE(moved.size() == 99);
+    REQUIRE(copy.empty());
+
+    copy = moved;
+    REQUIRE(copy.size() == 99);
+    moved = std::move(map);
+    REQUIRE(moved.size() == 100);
+
+    const map_type& cref = moved;
+    REQUIRE(cref.find("7") != cref.end());
+    REQUIRE(cref.find("100") == cref.end());
+}
+
+// every key below 1000 has its home in the first slot, the keys up to
+// 2000 in the last slot of any table up to 4096 slots
+struct CollidingHash
+{
+    std::size_t operator()(int key) const
+    {
+        if(key < 1000) return 0;
+        if(key < 2000) return 0xCC30000000000000ull;
+        return std::hash<int>()(key);
+    }
+};
+
+TEST_CASE("robin hood maps survive keys that collide", "[robin_hood_map_test]")
+{    
+    using map_type = YAGL::RobinHoodMap<int, int, CollidingHash>;
+
+    map_type map;
+    map.reserve(20000);
+
+    //the longest run info can hold, plus a run that ends right before it
+    //once the table is small enough for it to wrap around
+    for(int i = 0; i < 254; i++)
+        map.try_emplace(i, i);
+    for(int i = 1000; i < 1020; i++)
+        map.try_emplace(i, i);
+    REQUIRE(map.size() == 274);
+
+    SECTION("shrinking keeps every element") {
+        auto before = map.bucket_count();
+        map.rehash(0);
+        REQUIRE(map.bucket_count() <= before);
+        REQUIRE(map.size() == 274);
+
+        bool all_found = true;
+        for(int i = 0; i < 254; i++)
+            if(map.find(i) == map.end() || map.find(i)->second != i) all_found = false;
+        for(int i = 1000; i < 1020; i++)
+            if(map.find(i) == map.end() || map.find(i)->second != i) all_found = false;
+        REQUIRE(all_found);
+
+        std::size_t visited = 0;
+        for(const auto& kv : map)
+        {
+            REQUIRE(kv.first == kv.second);
+            visited++;
+        }
+        REQUIRE(visited == 274);
+    }
+
+    SECTION("a run longer than a probe can reach throws") {
+        map.try_emplace(254, 254);
+        REQUIRE_THROWS_AS(map.try_emplace(255, 255), std::length_error);
+        REQUIRE(map.size() == 275);
+        REQUIRE(map.count(255) == 0);
+        REQUIRE(map.find(254)->second == 254);
+    }
+}
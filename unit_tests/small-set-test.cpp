@@ -0,0 +1,81 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Small_Sorted_Set.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+TEST_CASE("small sorted sets keep unique sorted elements", "[small_set_test]")
+{    
+    using set_type = YAGL::SmallSortedSet<std::uint32_t, 4>;
+
+    set_type set;
+
+    REQUIRE(set.empty());
+    REQUIRE(set.is_inline());
+
+    REQUIRE(set.insert(7).second == true);
+    REQUIRE(set.insert(3).second == true);
+    REQUIRE(set.insert(5).second == true);
+    REQUIRE(set.insert(3).second == false);
+
+    REQUIRE(set.size() == 3);
+    REQUIRE(set.count(5) == 1);
+    REQUIRE(set.count(4) == 0);
+    REQUIRE(set.find(4) == set.end());
+
+    std::vector<std::uint32_t> order(set.begin(), set.end());
+    REQUIRE(order == std::vector<std::uint32_t>{3, 5, 7});
+
+    REQUIRE(set.erase(5) == 1);
+    REQUIRE(set.erase(5) == 0);
+    REQUIRE(set.size() == 2);
+    REQUIRE(*set.begin() == 3);
+}
+
+TEST_CASE("small sorted sets spill to the heap and come back", "[small_set_test]")
+{    
+    using set_type = YAGL::SmallSortedSet<std::uint32_t, 4>;
+
+    set_type set;
+
+    //fill past the inline buffer in reverse order
+    for(std::uint32_t i = 10; i > 0; i--)
+        set.insert(i);
+
+    REQUIRE(set.size() == 10);
+    REQUIRE(!set.is_inline());
+    
+    std::uint32_t expected = 1;
+    for(auto v : set)
+        REQUIRE(v == expected++);
+
+    SECTION("copies and moves keep the elements") {
+        set_type copy = set;
+        REQUIRE(copy.size() == 10);
+        REQUIRE(copy.count(7) == 1);
+        
+        set_type moved = std::move(copy);
+        REQUIRE(moved.size() == 10);
+        REQUIRE(copy.empty());
+
+        copy = moved;
+        REQUIRE(copy.size() == 10);
+        REQUIRE(moved.size() == 10);
+    }
+
+    SECTION("shrinking moves small sets back inline") {
+        for(std::uint32_t i = 1; i <= 7; i++)
+            set.erase(i);
+        
+        REQUIRE(set.size() == 3);
+        REQUIRE(!set.is_inline());
+
+        set.shrink_to_fit();
+        REQUIRE(set.is_inline());
+        REQUIRE(set.count(8) == 1);
+        REQUIRE(set.count(10) == 1);
+    }
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "YAGL_Thread_Pool.hpp"
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <numeric>
+
+TEST_CASE("thread pools cover every item exactly once", "[thread_pool_test]")
+{    
+    for(std::size_t threads : {1, 3, 8})
+    {
+        YAGL::ThreadPool pool(threads);
+        REQUIRE(pool.size() == threads);
+
+        std::vector<std::atomic<int>> hits(10007);
+        for(auto& h : hits) h = 0;
+
+        //catch assertions aren't thread safe, check the chunks afterwards
+        std::atomic<bool> chunks_ok{true};
+        pool.parallel_for(hits.size(), 13, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+            if(worker >= threads || end - begin > 13) chunks_ok = false;
+            for(auto i = begin; i < end; i++) hits[i]++;
+        });
+        REQUIRE(chunks_ok);
+
+        bool all_once = true;
+        for(auto& h : hits) if(h != 1) all_once = false;
+        REQUIRE(all_once);
+
+        //and again on the same workers, with per worker partial sums
+        std::vector<long> sums(threads, 0);
+        pool.parallel_for(1000, 1, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+            for(auto i = begin; i < end; i++) sums[worker] += i;
+        });
+        REQUIRE(std::accumulate(sums.begin(), sums.end(), 0l) == 999*1000/2);
+        
+        //nothing to do is fine
+        pool.parallel_for(0, 4, [&](std::size_t, std::size_t, std::size_t) {});
+    }
+}
+
+TEST_CASE("thread pools pass exceptions back to the caller", "[thread_pool_test]")
+{
+    YAGL::ThreadPool pool(4);
+
+    std::atomic<int> ran{0};
+    REQUIRE_THROWS_AS(pool.parallel_for(100, 1, [&](std::size_t, std::size_t begin, std::size_t) {
+        ran++;
+        if(begin == 42) throw std::runtime_error("chunk 42");
+    }), std::runtime_error);
+    
+    //the remaining chunks still ran and the pool is still usable
+    REQUIRE(ran == 100);
+    std::atomic<int> after{0};
+    pool.parallel_for(10, 1, [&](std::size_t, std::size_t, std::size_t) { after++; });
+    REQUIRE(after == 10);
+}